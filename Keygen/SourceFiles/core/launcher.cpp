@@ -10,14 +10,25 @@
 #include "core/sandbox.h"
 #include "base/platform/base_platform_info.h"
 #include "base/concurrent_timer.h"
+#include "keygen/crypto/ed25519.h"
+#include "keygen/key_requests.h"
+#include "keygen/keystore.h"
+#include "keygen/recovery/search.h"
+#include "keygen/self_test.h"
+#include "keygen/word_index.h"
+#include "ton/ton_wallet.h"
 
 #include <QtWidgets/QApplication>
 #include <QtCore/QJsonObject>
 #include <QtCore/QStandardPaths>
+#include <QtCore/QTextStream>
 
 namespace Core {
 namespace {
 
+constexpr auto kBenchmarkKeys = 16384;
+constexpr auto kBenchmarkCreated = 16;
+
 class FilteredCommandLineArguments {
 public:
 	FilteredCommandLineArguments(int argc, char **argv);
@@ -82,6 +93,21 @@ void Launcher::init() {
 int Launcher::exec() {
 	init();
 
+	if (!_argumentsError.isEmpty()) {
+		QTextStream(stderr) << _argumentsError << "\n";
+		return 2;
+	} else if (_benchmarkKeys) {
+		return executeKeysBenchmark();
+	} else if (_selfTest) {
+		return executeSelfTest();
+	} else if (!_recoverSpec.isEmpty()) {
+		return executeRecovery();
+	} else if (!_exportWords.isEmpty()) {
+		return executeExport();
+	} else if (!_verifyKeystore.isEmpty()) {
+		return executeVerify();
+	}
+
 	auto options = QJsonObject();
 	const auto tempFontConfigPath = QStandardPaths::writableLocation(
 		QStandardPaths::TempLocation
@@ -117,6 +143,134 @@ void Launcher::prepareSettings() {
 }
 
 void Launcher::processArguments() {
+	_benchmarkKeys = _arguments.contains("-benchmark-keys");
+	_selfTest = _arguments.contains("-self-test");
+
+	const auto value = [&](const QString &name) {
+		const auto index = _arguments.indexOf(name);
+		return (index >= 0
+			&& index + 1 < _arguments.size()
+			&& !_arguments[index + 1].startsWith('-'))
+			? _arguments[index + 1]
+			: QString();
+	};
+	const auto invalid = [&](const QString &name) {
+		return _arguments.contains(name) && value(name).isEmpty();
+	};
+
+	// -recover <spec.json> [-shard <i>/<n>] [-checkpoint <path>]
+	// A typo in one process of a sharded run must not make it search
+	// the whole space, so bad values stop the launch.
+	_recoverSpec = value("-recover");
+	_recoverCheckpoint = value("-checkpoint");
+	if (invalid("-recover")) {
+		_argumentsError = "-recover needs a spec file.";
+		return;
+	} else if (invalid("-checkpoint")) {
+		_argumentsError = "-checkpoint needs a file.";
+		return;
+	} else if (_recoverSpec.isEmpty()
+		&& (_arguments.contains("-shard")
+			|| _arguments.contains("-checkpoint"))) {
+		_argumentsError = "-shard and -checkpoint need -recover.";
+		return;
+	}
+	if (_arguments.contains("-shard")) {
+		const auto shard = value("-shard").split('/');
+		auto indexParsed = false;
+		auto countParsed = false;
+		const auto index = (shard.size() == 2)
+			? shard[0].toInt(&indexParsed)
+			: 0;
+		const auto count = (shard.size() == 2)
+			? shard[1].toInt(&countParsed)
+			: 0;
+		if (!indexParsed
+			|| !countParsed
+			|| count <= 0
+			|| index <= 0
+			|| index > count) {
+			_argumentsError = "-shard needs <i>/<n> with 1 <= i <= n.";
+			return;
+		}
+		_recoverShard = index - 1;
+		_recoverShards = count;
+	}
+
+	// -export-keystores <words.txt> -output <folder>
+	_exportWords = value("-export-keystores");
+	_exportOutput = value("-output");
+	if (invalid("-export-keystores")) {
+		_argumentsError = "-export-keystores needs a words file.";
+		return;
+	} else if (invalid("-output")) {
+		_argumentsError = "-output needs a folder.";
+		return;
+	} else if (_exportWords.isEmpty() != _exportOutput.isEmpty()) {
+		_argumentsError = "-export-keystores and -output go together.";
+		return;
+	}
+
+	// -verify-keystore <keystore.json>
+	_verifyKeystore = value("-verify-keystore");
+	if (invalid("-verify-keystore")) {
+		_argumentsError = "-verify-keystore needs a keystore file.";
+	}
+}
+
+int Launcher::executeKeysBenchmark() const {
+	const auto result = Keygen::Crypto::BenchmarkPublicKeys(kBenchmarkKeys);
+	QTextStream(stdout)
+		<< "Ed25519 keys per second per core: "
+		<< qRound(result.batchedPerSecond)
+		<< " batched, "
+		<< qRound(result.singlePerSecond)
+		<< " one by one.\n";
+
+	// The counters the key requests keep, for keys created in a row.
+	using Clock = std::chrono::steady_clock;
+	const auto index = Keygen::WordIndex(Ton::Wallet::GetValidWords());
+	const auto engine = Keygen::Crypto::MnemonicEngine(index.list());
+	auto stats = Keygen::KeyRequests::Stats();
+	const auto started = Clock::now();
+	for (auto i = 0; i != kBenchmarkCreated; ++i) {
+		++stats.started;
+		const auto created = engine.create(QByteArray::number(i));
+		Assert(created.has_value());
+		stats.countCreated(*created);
+		++stats.finished;
+	}
+	const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+		Clock::now() - started);
+	QTextStream(stdout)
+		<< "Created " << kBenchmarkCreated
+		<< " keys in " << elapsed.count() << " ms.\n"
+		<< Keygen::DescribeStats(stats) << "\n";
+	return 0;
+}
+
+int Launcher::executeSelfTest() const {
+	return Keygen::RunSelfTest();
+}
+
+int Launcher::executeRecovery() const {
+	auto options = Keygen::Recovery::SearchOptions();
+	options.specPath = _recoverSpec;
+	options.shard = _recoverShard;
+	options.shards = _recoverShards;
+	options.checkpointPath = _recoverCheckpoint;
+	return Keygen::Recovery::RunSearch(options);
+}
+
+int Launcher::executeExport() const {
+	auto options = Keygen::ExportOptions();
+	options.wordsPath = _exportWords;
+	options.outputPath = _exportOutput;
+	return Keygen::RunExport(options);
+}
+
+int Launcher::executeVerify() const {
+	return Keygen::RunVerify(_verifyKeystore);
 }
 
 int Launcher::executeApplication() {
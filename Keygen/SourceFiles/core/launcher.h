@@ -30,10 +30,25 @@ private:
 
 	void init();
 	int executeApplication();
+	int executeKeysBenchmark() const;
+	int executeSelfTest() const;
+	int executeRecovery() const;
+	int executeExport() const;
+	int executeVerify() const;
 
 	int _argc;
 	char **_argv;
 	QStringList _arguments;
+	QString _argumentsError;
+	bool _benchmarkKeys = false;
+	bool _selfTest = false;
+	QString _recoverSpec;
+	QString _recoverCheckpoint;
+	int _recoverShard = 0;
+	int _recoverShards = 1;
+	QString _exportWords;
+	QString _exportOutput;
+	QString _verifyKeystore;
 	BaseIntegration _baseIntegration;
 
 };
@@ -7,6 +7,8 @@
 #include "keygen/application.h"
 
 #include "keygen/steps/manager.h"
+#include "keygen/crypto/mnemonic.h"
+#include "keygen/crypto/wallet_address.h"
 #include "keygen/phrases.h"
 #include "ui/widgets/window.h"
 #include "ui/text/text_utilities.h"
@@ -22,6 +24,8 @@
 #include "styles/style_widgets.h"
 #include "styles/palette.h"
 
+#include <openssl/crypto.h>
+
 #include <QtCore/QStandardPaths>
 #include <QtCore/QDir>
 #include <QtGui/QtEvents>
@@ -33,24 +37,112 @@
 namespace Keygen {
 namespace {
 
+constexpr auto kWordlistSize = 2048;
+
 [[nodiscard]] QString AllFilesFilter() {
 	return Platform::IsWindows() ? "All Files (*.*)" : "All Files (*)";
 }
 
+[[nodiscard]] double VanityPatternChance(
+		const QByteArray &pattern,
+		bool address) {
+	return address
+		? Crypto::AddressPatternChance(pattern)
+		: Crypto::PublicKeyPatternChance(pattern);
+}
+
 [[nodiscard]] bool IsBadWordsError(const Ton::Error &error) {
 	const auto text = error.details;
 	return text.startsWith(qstr("INVALID_MNEMONIC"))
 		|| text.endsWith(qstr("NEED_MNEMONIC_PASSWORD"));
 }
 
+[[nodiscard]] bool IsNeedPasswordError(const Ton::Error &error) {
+	return error.details.endsWith(qstr("NEED_MNEMONIC_PASSWORD"));
+}
+
+[[nodiscard]] QString CombineErrorText(const Ton::Error &error) {
+	const auto text = error.details;
+	if (IsNeedPasswordError(error)) {
+		return tr::lng_combine_bad_password(tr::now);
+	} else if (text.endsWith(qstr("NOT_ENOUGH_SHARES"))) {
+		return tr::lng_combine_bad_count(tr::now);
+	} else if (text.endsWith(qstr("SHARES_KEY_MISMATCH"))) {
+		return tr::lng_combine_bad_key(tr::now);
+	} else if (text.endsWith(qstr("INVALID_SHARES"))) {
+		return tr::lng_combine_bad_shares(tr::now);
+	}
+	return text;
+}
+
+[[nodiscard]] QString WalletTitle(const Crypto::WalletAddress &address) {
+	return tr::lng_addresses_wallet(
+		tr::now
+	).replace(
+		"{version}",
+		Crypto::WalletVersionName(address.version)
+	).replace(
+		"{workchain}",
+		((address.workchain == Crypto::kMasterchain)
+			? tr::lng_addresses_masterchain
+			: tr::lng_addresses_basechain)(tr::now));
+}
+
+[[nodiscard]] auto CreateMnemonicEngine(const WordIndex &words)
+-> std::shared_ptr<const Crypto::MnemonicEngine> {
+	if (words.size() != kWordlistSize) {
+		// Let tonlib handle whatever it is using.
+		return nullptr;
+	}
+	return std::make_shared<Crypto::MnemonicEngine>(words.list());
+}
+
+[[nodiscard]] std::vector<QByteArray> ToUtf8(
+		const std::vector<QString> &words) {
+	return ranges::view::all(
+		words
+	) | ranges::view::transform([](const QString &word) {
+		return word.toUtf8();
+	}) | ranges::to_vector;
+}
+
+// Time depends only on the lengths, never on where the words differ.
+[[nodiscard]] bool ConstantTimeMatch(
+		const QByteArray &expected,
+		const QByteArray &typed,
+		bool prefix) {
+	const auto length = typed.size();
+	if (prefix ? (length > expected.size()) : (length != expected.size())) {
+		return false;
+	}
+	auto difference = uchar(0);
+	for (auto i = 0; i != length; ++i) {
+		difference |= uchar(expected[i]) ^ uchar(typed[i]);
+	}
+	return (difference == 0);
+}
+
 } // namespace
 
 Application::Application()
 : _window(std::make_unique<Ui::Window>())
 , _steps(std::make_unique<Steps::Manager>([&](const QString &word) {
 	return wordsByPrefix(word);
+}, [&](const QString &word) {
+	return isValidWord(word);
+}, [&](int index, const QString &word) {
+	return isExpectedWord(index, word);
+}, [&](int index, const QString &word) {
+	return isExpectedPrefix(index, word);
+}, [&](const Steps::VanityRequest &request) {
+	return VanityPatternChance(
+		request.pattern.toUtf8(),
+		(request.target == Steps::VanityTarget::WalletAddress));
 }))
-, _validWords(Ton::Wallet::GetValidWords()) {
+, _validWords(Ton::Wallet::GetValidWords())
+, _validWordsSet(_validWords)
+, _validWordsMatcher(&_validWords)
+, _requests(CreateMnemonicEngine(_validWords)) {
 	QApplication::setWindowIcon(QIcon(QPixmap(":/gui/art/logo.png", "PNG")));
 	initWindow();
 	initSteps();
@@ -58,37 +150,37 @@ Application::Application()
 }
 
 Application::~Application() {
+	_requests.cancelAll();
 	Ton::Finish();
 }
 
-std::vector<QString> Application::wordsByPrefix(const QString &word) const {
-	const auto adjusted = word.trimmed().toLower();
+WordsRange Application::wordsByPrefix(const QString &word) const {
+	const auto adjusted = QStringRef(&word).trimmed();
 	if (adjusted.size() < _minimalValidWordLength) {
 		return {};
-	} else if (_validWords.empty()) {
-		return { word };
 	}
-	auto prefix = QString();
-	auto count = 0;
-	auto maxCount = 0;
-	for (auto word : _validWords) {
-		if (word.midRef(0, 3) != prefix) {
-			prefix = word.mid(0, 3);
-			count = 1;
-		} else {
-			++count;
-		}
-		if (maxCount < count) {
-			maxCount = count;
-		}
-	}
-	auto result = std::vector<QString>();
-	const auto from = ranges::lower_bound(_validWords, adjusted);
-	const auto end = _validWords.end();
-	for (auto i = from; i != end && i->startsWith(adjusted); ++i) {
-		result.push_back(*i);
-	}
-	return result;
+	const auto result = _validWords.byPrefix(adjusted);
+	return result.empty()
+		? _validWordsMatcher.find(adjusted)
+		: result;
+}
+
+bool Application::isValidWord(const QString &word) const {
+	return _validWordsSet.contains(word);
+}
+
+bool Application::isExpectedWord(int index, const QString &word) const {
+	Expects(_key.has_value());
+	Expects(index >= 0 && index < _key->words.size());
+
+	return ConstantTimeMatch(_key->words[index], word.toUtf8(), false);
+}
+
+bool Application::isExpectedPrefix(int index, const QString &word) const {
+	Expects(_key.has_value());
+	Expects(index >= 0 && index < _key->words.size());
+
+	return ConstantTimeMatch(_key->words[index], word.toUtf8(), true);
 }
 
 void Application::initSteps() {
@@ -99,6 +191,16 @@ void Application::initSteps() {
 		widget->setGeometry({ QPoint(), size });
 	}, widget->lifetime());
 
+	_steps->passwordRequests(
+	) | rpl::start_with_next([=](const QString &password) {
+		setPassword(password);
+	}, _lifetime);
+
+	_steps->vanityRequests(
+	) | rpl::start_with_next([=](const Steps::VanityRequest &request) {
+		setVanityPattern(request);
+	}, _lifetime);
+
 	_steps->generateRequests(
 	) | rpl::start_with_next([=](const QByteArray &seed) {
 		setRandomSeed(seed);
@@ -114,6 +216,36 @@ void Application::initSteps() {
 		verifyWords(std::move(words));
 	}, _lifetime);
 
+	_steps->speculateRequests(
+	) | rpl::start_with_next([=](std::vector<QString> &&words) {
+		speculate(std::move(words));
+	}, _lifetime);
+
+	_steps->recoveryRequests(
+	) | rpl::start_with_next([=](const Steps::RecoveryRequest &request) {
+		recoverWords(request);
+	}, _lifetime);
+
+	_steps->recoveredChoices(
+	) | rpl::start_with_next([=](int index) {
+		useRecovered(index);
+	}, _lifetime);
+
+	_steps->splitRequests(
+	) | rpl::start_with_next([=](const Steps::SplitRequest &request) {
+		splitKey(request);
+	}, _lifetime);
+
+	_steps->combineRequests(
+	) | rpl::start_with_next([=](const Steps::CombineRequest &request) {
+		combineShares(request);
+	}, _lifetime);
+
+	_steps->keystoreRequests(
+	) | rpl::start_with_next([=](const QString &passphrase) {
+		exportKeystore(passphrase);
+	}, _lifetime);
+
 	using Action = Steps::Manager::Action;
 	_steps->actionRequests(
 	) | rpl::start_with_next([=](Action action) {
@@ -125,6 +257,15 @@ void Application::initSteps() {
 		case Action::CopyKey: return copyPublicKey();
 		case Action::SaveKey: return savePublicKey();
 		case Action::NewKey: return startNewKey();
+		case Action::CancelRecovery:
+			return _requests.cancel(KeyRequests::Channel::Recover);
+		case Action::CancelVanity: return cancelVanity();
+		case Action::ShowAddresses:
+			return _steps->showAddresses(walletAddresses());
+		case Action::CopyAddresses: return copyAddresses();
+		case Action::CopyShares: return copyShares();
+		case Action::CancelKeystore:
+			return _requests.cancel(KeyRequests::Channel::Export);
 		}
 		Unexpected("Action in actionRequests.");
 	}, _lifetime);
@@ -204,6 +345,34 @@ void Application::handleWindowKeyPress(not_null<QKeyEvent*> e) {
 	}
 }
 
+void Application::setPassword(const QString &password) {
+	if (!_password.isEmpty()) {
+		_password.detach();
+		OPENSSL_cleanse(_password.data(), _password.size());
+	}
+	_password = password.toUtf8();
+
+	// Speculated results were derived with the previous password.
+	_requests.cancel(KeyRequests::Channel::Speculate);
+	_speculation = std::nullopt;
+}
+
+void Application::setVanityPattern(const Steps::VanityRequest &request) {
+	_vanityPattern = request.pattern.toUtf8();
+	_vanityAddress = (request.target == Steps::VanityTarget::WalletAddress);
+}
+
+void Application::cancelVanity() {
+	const auto channel = KeyRequests::Channel::Create;
+	if (_state != State::Creating || !_requests.running(channel)) {
+		return;
+	}
+	_requests.cancel(channel);
+	_randomSeed = QByteArray();
+	_state = State::WaitingRandom;
+	_steps->showVanity();
+}
+
 void Application::setRandomSeed(const QByteArray &seed) {
 	Expects(!seed.isEmpty());
 
@@ -217,15 +386,55 @@ void Application::checkRandomSeed() {
 	}
 	_verifying = std::nullopt;
 	_state = State::Creating;
-	Ton::CreateKey(_randomSeed, [=](Ton::Result<Ton::UtilityKey> result) {
+	const auto done = [=](Ton::Result<Ton::UtilityKey> result) {
 		if (!result) {
 			_steps->showError(result.error().details);
 		} else {
 			_key = *result;
 			_state = State::Created;
+			_derivations.remember(_key->words, _password, _key->publicKey);
 			_steps->showCreated(collectWords());
 		}
-	});
+	};
+	if (_vanityPattern.isEmpty()) {
+		_requests.create(_randomSeed, _password, done);
+		return;
+	}
+	const auto chance = VanityPatternChance(_vanityPattern, _vanityAddress);
+
+	Assert(chance > 0.);
+
+	// The address matched is the first one shown for the created key.
+	const auto pattern = _vanityPattern;
+	const auto address = _vanityAddress;
+	const auto matches = [=](const Crypto::PublicKey &key) {
+		return address
+			? Crypto::SerializeAddress(Crypto::ComputeWalletAddress(
+				key,
+				Crypto::WalletVersion::V3R2,
+				Crypto::kBasechain)).startsWith(pattern)
+			: Crypto::SerializePublicKey(key).startsWith(pattern);
+	};
+	const auto started = crl::now();
+	const auto progress = [=](int64 keys) {
+		const auto elapsed = std::max(crl::now() - started, crl::time(1));
+		const auto perSecond = keys * 1000. / elapsed;
+
+		// Each key matches independently, so the expected time to match
+		// does not depend on how long the search has been running.
+		const auto expected = 1. / (chance * std::max(perSecond, 1.));
+		_steps->setVanityProgress(
+			keys,
+			int64(std::round(perSecond)),
+			int64(std::min(expected, 1e15)));
+	};
+	_steps->showVanityProgress();
+	_requests.createMatching(
+		_randomSeed,
+		_password,
+		matches,
+		progress,
+		done);
 }
 
 void Application::checkWords(std::vector<QString> &&words) {
@@ -251,20 +460,14 @@ void Application::checkWords(std::vector<QString> &&words) {
 		}
 	};
 	if (words[0] == "speakfriendandenter") {
+		_requests.cancel(KeyRequests::Channel::Check);
 		callback(_key->publicKey);
 		return;
-	} else if (_state == State::Checking) {
-		return;
 	}
+	// A new submission supersedes the one still running, if any.
 	_state = State::Checking;
 
-	const auto utf8 = ranges::view::all(
-		words
-	) | ranges::view::transform([](const QString &word) {
-		return word.toUtf8();
-	}) | ranges::to_vector;
-
-	Ton::CheckKey(utf8, callback);
+	checkKey(ToUtf8(words), callback);
 }
 
 void Application::verifyWords(std::vector<QString> &&words) {
@@ -277,7 +480,14 @@ void Application::verifyWords(std::vector<QString> &&words) {
 		}
 		auto words = base::take(_verifying);
 		if (!result) {
-			if (IsBadWordsError(result.error())) {
+			if (IsNeedPasswordError(result.error())) {
+				_steps->showVerifyPassword();
+			} else if (IsBadWordsError(result.error())) {
+				if (!_password.isEmpty()) {
+					// Ask for the password again if the words need one.
+					setPassword(QString());
+				}
+				_recoverable = std::move(*words);
 				_steps->showVerifyFail();
 			} else {
 				_steps->showError(result.error().details);
@@ -290,16 +500,194 @@ void Application::verifyWords(std::vector<QString> &&words) {
 			_steps->showVerifyDone(_key->publicKey);
 		}
 	};
-	if (_verifying) {
+	_verifying = ToUtf8(words);
+
+	checkKey(*_verifying, callback);
+}
+
+void Application::speculate(std::vector<QString> &&words) {
+	if (_speculation && _speculation->done) {
+		// Someone already waits for this result, let it finish.
+		return;
+	} else if (words.empty()) {
+		_requests.cancel(KeyRequests::Channel::Speculate);
+		_speculation = std::nullopt;
 		return;
 	}
-	_verifying = ranges::view::all(
-		words
-	) | ranges::view::transform([](const QString &word) {
-		return word.toUtf8();
+	const auto utf8 = ToUtf8(words);
+	if (_speculation && _speculation->words == utf8) {
+		return;
+	}
+	const auto channel = KeyRequests::Channel::Speculate;
+	if (auto cached = _derivations.find(utf8, _password)) {
+		_requests.cancel(channel);
+		_speculation = Speculation{ utf8, std::move(cached) };
+		return;
+	}
+	_speculation = Speculation{ utf8 };
+	const auto password = _password;
+	const auto checked = [=](Ton::Result<QByteArray> result) {
+		Expects(_speculation.has_value());
+
+		rememberDerivation(utf8, password, result);
+		_speculation->result = result;
+		if (const auto done = base::take(_speculation->done)) {
+			done(result);
+		}
+	};
+	_requests.check(channel, utf8, password, checked);
+}
+
+void Application::recoverWords(const Steps::RecoveryRequest &request) {
+	Expects(!_recoverable.empty());
+
+	setPassword(request.password);
+
+	auto recovery = Crypto::RecoveryRequest();
+	recovery.words = _recoverable;
+	recovery.password = _password;
+	recovery.publicKey = request.publicKey.toUtf8();
+	const auto count = int(_recoverable.size());
+	for (auto position = 0; position != count; ++position) {
+		if (request.position < 0 || request.position == position) {
+			recovery.slots.push_back({
+				position,
+				recoveryCandidates(_recoverable[position]),
+			});
+		}
+	}
+	const auto progress = [=](int done, int total) {
+		_steps->setRecoveryProgress(int(int64(done) * 100 / total));
+	};
+	using Recovered = std::vector<Crypto::RecoveredKey>;
+	const auto done = [=](Ton::Result<Recovered> result) {
+		if (!result) {
+			_steps->showError(result.error().details);
+			return;
+		}
+		_recovered = std::move(*result);
+		_steps->showRecoveryDone(ranges::view::all(
+			_recovered
+		) | ranges::view::transform([](const Crypto::RecoveredKey &key) {
+			return Steps::RecoveredWord{
+				key.position,
+				QString::fromUtf8(key.words[key.position]),
+				QString::fromUtf8(key.publicKey),
+			};
+		}) | ranges::to_vector);
+	};
+	_steps->showRecoveryProgress();
+	_requests.recover(std::move(recovery), progress, done);
+}
+
+void Application::useRecovered(int index) {
+	Expects(index >= 0 && index < _recovered.size());
+
+	const auto recovered = base::take(_recovered)[index];
+	_recoverable.clear();
+	_key = Ton::UtilityKey();
+	_key->words = recovered.words;
+	_key->publicKey = recovered.publicKey;
+	_state = State::Created;
+	_derivations.remember(_key->words, _password, _key->publicKey);
+	_steps->showVerifyDone(_key->publicKey);
+}
+
+void Application::splitKey(const Steps::SplitRequest &request) {
+	Expects(_key.has_value());
+
+	auto result = _requests.split(*_key, request.threshold, request.count);
+	if (!result) {
+		_steps->showError(result.error().details);
+		return;
+	}
+	_shares = ranges::view::all(
+		*result
+	) | ranges::view::transform([](const std::vector<QByteArray> &words) {
+		return QString::fromUtf8(Crypto::JoinWords(words));
 	}) | ranges::to_vector;
+	auto shares = _shares;
+	_steps->showShares(std::move(shares), request.threshold);
+}
+
+void Application::combineShares(const Steps::CombineRequest &request) {
+	Expects(!_key.has_value());
+
+	setPassword(request.password);
+
+	auto shares = Crypto::KeyShares();
+	for (const auto &line : request.shares) {
+		const auto list = line.simplified().toLower().split(' ');
+		const auto words = std::vector<QString>(list.begin(), list.end());
+		shares.push_back(ToUtf8(words));
+	}
+	const auto password = _password;
+	const auto done = [=](Ton::Result<Ton::UtilityKey> result) {
+		if (!result) {
+			_steps->showCombineFail(CombineErrorText(result.error()));
+			return;
+		}
+		_key = std::move(*result);
+		_state = State::Created;
+		_derivations.remember(_key->words, password, _key->publicKey);
+		_steps->showVerifyDone(_key->publicKey);
+	};
+	_requests.combine(std::move(shares), _password, done);
+}
 
-	Ton::CheckKey(*_verifying, callback);
+void Application::exportKeystore(const QString &passphrase) {
+	Expects(_key.has_value());
+
+	const auto done = [=](QByteArray keystore) {
+		_steps->hideKeystoreProgress();
+		const auto filter = "JSON Files (*.json);;" + AllFilesFilter();
+		const auto saved = [=](QString path) {
+			_steps->showSaveKeystoreDone(path);
+		};
+		saveFileNow(keystore, "keystore.json", filter, saved);
+	};
+	_steps->showKeystoreProgress();
+	_requests.exportKeystore(
+		*_key,
+		!_password.isEmpty(),
+		passphrase.toUtf8(),
+		done);
+}
+
+void Application::checkKey(
+		const std::vector<QByteArray> &words,
+		Fn<void(Ton::Result<QByteArray>)> done) {
+	const auto channel = KeyRequests::Channel::Check;
+	if (const auto cached = _derivations.find(words, _password)) {
+		_requests.cancel(channel);
+		done(*cached);
+		return;
+	} else if (!_speculation || _speculation->words != words) {
+		_requests.cancel(KeyRequests::Channel::Speculate);
+		_speculation = std::nullopt;
+		const auto password = _password;
+		const auto checked = [=](Ton::Result<QByteArray> result) {
+			rememberDerivation(words, password, result);
+			done(result);
+		};
+		_requests.check(channel, words, password, checked);
+		return;
+	}
+	_requests.cancel(channel);
+	if (const auto &result = _speculation->result) {
+		done(*result);
+	} else {
+		_speculation->done = std::move(done);
+	}
+}
+
+void Application::rememberDerivation(
+		const std::vector<QByteArray> &words,
+		const QByteArray &password,
+		const Ton::Result<QByteArray> &result) {
+	if (result || IsBadWordsError(result.error())) {
+		_derivations.remember(words, password, result);
+	}
 }
 
 void Application::copyPublicKey() {
@@ -309,31 +697,57 @@ void Application::copyPublicKey() {
 	_steps->showCopyKeyDone();
 }
 
+void Application::copyAddresses() {
+	Expects(_key.has_value());
+
+	QGuiApplication::clipboard()->setText(addressesText());
+	_steps->showCopyAddressesDone();
+}
+
+void Application::copyShares() {
+	// One share on each line, as the combine box takes them.
+	auto lines = QStringList();
+	for (const auto &share : _shares) {
+		lines.push_back(share);
+	}
+	QGuiApplication::clipboard()->setText(lines.join('\n'));
+	_steps->showCopySharesDone();
+}
+
 void Application::savePublicKey() {
 	Expects(_key.has_value());
 
-	const auto key = _key->publicKey;
+	// The key stays on the first line, the addresses follow it.
+	const auto addresses = addressesText();
+	const auto content = addresses.isEmpty()
+		? _key->publicKey
+		: (_key->publicKey + "\n\n" + addresses.toUtf8() + "\n");
 	const auto delay = st::defaultRippleAnimation.hideDuration;
 	base::call_delayed(delay, _steps->content(), [=] {
-		savePublicKeyNow(key);
+		const auto filter = "Text Files (*.txt);;" + AllFilesFilter();
+		const auto saved = [=](QString path) {
+			_steps->showSaveKeyDone(path);
+		};
+		saveFileNow(content, "public_key.txt", filter, saved);
 	});
 }
 
-void Application::savePublicKeyNow(const QByteArray &key) {
-	const auto filter = QString("Text Files (*.txt);;All Files (*.*)");
+void Application::saveFileNow(
+		const QByteArray &content,
+		const QString &name,
+		const QString &filter,
+		Fn<void(QString)> saved) {
 	const auto fail = crl::guard(_steps->content(), [=] {
 		_steps->showSaveKeyFail();
 	});
-	const auto done = crl::guard(_steps->content(), [=](QString path) {
-		_steps->showSaveKeyDone(path);
-	});
+	const auto done = crl::guard(_steps->content(), saved);
 	const auto getPath = [&] {
 		const auto where = QStandardPaths::writableLocation(
 			QStandardPaths::DocumentsLocation);
 		return QFileDialog::getSaveFileName(
 			_steps->content()->window(),
 			tr::lng_done_save_caption(tr::now),
-			where + "/public_key.txt",
+			where + '/' + name,
 			filter);
 	};
 	const auto path = Core::Sandbox::Instance().runNestedEventLoop(
@@ -343,7 +757,8 @@ void Application::savePublicKeyNow(const QByteArray &key) {
 		return;
 	}
 	auto file = QFile(path);
-	if (file.open(QIODevice::WriteOnly) && file.write(key) == key.size()) {
+	if (file.open(QIODevice::WriteOnly)
+		&& file.write(content) == content.size()) {
 		done(path);
 	} else {
 		fail();
@@ -353,12 +768,76 @@ void Application::savePublicKeyNow(const QByteArray &key) {
 void Application::startNewKey() {
 	_key = std::nullopt;
 	_verifying = std::nullopt;
+	_speculation = std::nullopt;
+	_recoverable.clear();
+	_recovered.clear();
+	_shares.clear();
+	_requests.cancelAll();
+	_derivations.clear();
+	setPassword(QString());
+	_vanityPattern = QByteArray();
+	_vanityAddress = false;
 	if (_state != State::Starting) {
 		_state = State::WaitingRandom;
 	}
 	_steps->showIntro();
 }
 
+std::vector<Steps::WalletAddress> Application::walletAddresses() const {
+	Expects(_key.has_value());
+
+	const auto key = Crypto::ParsePublicKey(_key->publicKey);
+	if (!key) {
+		return {};
+	}
+	const auto addresses = Crypto::ComputeWalletAddresses(*key);
+	return ranges::view::all(
+		addresses
+	) | ranges::view::transform([](const Crypto::WalletAddress &address) {
+		return Steps::WalletAddress{
+			WalletTitle(address),
+			QString::fromLatin1(Crypto::SerializeAddress(address)),
+		};
+	}) | ranges::to_vector;
+}
+
+QString Application::addressesText() const {
+	auto result = QStringList();
+	for (const auto &[title, address] : walletAddresses()) {
+		result.push_back(title + ": " + address);
+	}
+	return result.join('\n');
+}
+
+std::vector<QByteArray> Application::recoveryCandidates(
+		const QByteArray &word) const {
+	// The nearest fuzzy matches go first, then the rest of the words.
+	const auto text = QString::fromUtf8(word);
+	const auto nearest = _validWordsMatcher.find(QStringRef(&text));
+	const auto first = ranges::view::ints(
+		0,
+		nearest.size()
+	) | ranges::view::transform([&](int position) {
+		return nearest.wordIndex(position);
+	}) | ranges::to_vector;
+
+	auto result = std::vector<QByteArray>();
+	result.reserve(_validWords.size());
+	const auto add = [&](int index) {
+		const auto word = _validWords.word(index);
+		result.push_back(QByteArray(word.data(), word.size()));
+	};
+	for (const auto index : first) {
+		add(index);
+	}
+	for (auto i = 0; i != _validWords.size(); ++i) {
+		if (ranges::find(first, i) == end(first)) {
+			add(i);
+		}
+	}
+	return result;
+}
+
 std::vector<QString> Application::collectWords() const {
 	Expects(_key.has_value());
 
@@ -6,6 +6,11 @@
 //
 #pragma once
 
+#include "keygen/derivation_cache.h"
+#include "keygen/key_requests.h"
+#include "keygen/word_index.h"
+#include "keygen/word_matcher.h"
+#include "keygen/word_set.h"
 #include "ton/ton_utility.h"
 
 class QEvent;
@@ -18,6 +23,11 @@ class Window;
 namespace Keygen {
 namespace Steps {
 class Manager;
+struct VanityRequest;
+struct RecoveryRequest;
+struct WalletAddress;
+struct SplitRequest;
+struct CombineRequest;
 } // namespace Steps
 
 class Application final {
@@ -30,6 +40,11 @@ public:
 	void run();
 
 private:
+	struct Speculation {
+		std::vector<QByteArray> words;
+		std::optional<Ton::Result<QByteArray>> result;
+		Fn<void(Ton::Result<QByteArray>)> done;
+	};
 	enum class State {
 		Starting,
 		WaitingRandom,
@@ -43,28 +58,67 @@ private:
 	void updateWindowPalette();
 	void handleWindowEvent(not_null<QEvent*> e);
 	void handleWindowKeyPress(not_null<QKeyEvent*> e);
+	void setPassword(const QString &password);
+	void setVanityPattern(const Steps::VanityRequest &request);
+	void cancelVanity();
 	void setRandomSeed(const QByteArray &seed);
 	void checkRandomSeed();
 	void checkWords(std::vector<QString> &&words);
 	void verifyWords(std::vector<QString> &&words);
+	void speculate(std::vector<QString> &&words);
+	void recoverWords(const Steps::RecoveryRequest &request);
+	void useRecovered(int index);
+	void splitKey(const Steps::SplitRequest &request);
+	void combineShares(const Steps::CombineRequest &request);
+	void exportKeystore(const QString &passphrase);
+	void checkKey(
+		const std::vector<QByteArray> &words,
+		Fn<void(Ton::Result<QByteArray>)> done);
+	void rememberDerivation(
+		const std::vector<QByteArray> &words,
+		const QByteArray &password,
+		const Ton::Result<QByteArray> &result);
 	void copyPublicKey();
+	void copyAddresses();
+	void copyShares();
 	void savePublicKey();
-	void savePublicKeyNow(const QByteArray &key);
+	void saveFileNow(
+		const QByteArray &content,
+		const QString &name,
+		const QString &filter,
+		Fn<void(QString)> saved);
 	void startNewKey();
 
-	[[nodiscard]] std::vector<QString> wordsByPrefix(
-		const QString &word) const;
+	[[nodiscard]] WordsRange wordsByPrefix(const QString &word) const;
+	[[nodiscard]] bool isValidWord(const QString &word) const;
+	[[nodiscard]] bool isExpectedWord(int index, const QString &word) const;
+	[[nodiscard]] bool isExpectedPrefix(int index, const QString &word) const;
 	[[nodiscard]] std::vector<QString> collectWords() const;
+	[[nodiscard]] std::vector<Steps::WalletAddress> walletAddresses() const;
+	[[nodiscard]] QString addressesText() const;
+	[[nodiscard]] std::vector<QByteArray> recoveryCandidates(
+		const QByteArray &word) const;
 
 	const std::unique_ptr<Ui::Window> _window;
 	const std::unique_ptr<Steps::Manager> _steps;
-	const base::flat_set<QString> _validWords;
+	const WordIndex _validWords;
+	const WordSet _validWordsSet;
+	const WordMatcher _validWordsMatcher;
 
 	State _state = State::Starting;
 	QByteArray _randomSeed;
+	QByteArray _password;
+	QByteArray _vanityPattern;
+	bool _vanityAddress = false;
 	int _minimalValidWordLength = 1;
 	std::optional<Ton::UtilityKey> _key;
 	std::optional<std::vector<QByteArray>> _verifying;
+	std::optional<Speculation> _speculation;
+	std::vector<QByteArray> _recoverable;
+	std::vector<Crypto::RecoveredKey> _recovered;
+	std::vector<QString> _shares;
+	KeyRequests _requests;
+	DerivationCache _derivations;
 
 	rpl::lifetime _lifetime;
 
@@ -0,0 +1,52 @@
+// This file is part of TON Key Generator,
+// a desktop application for the TON Blockchain project.
+//
+// For license and copyright information please follow this link:
+// https://github.com/ton-blockchain/tonkeygen/blob/master/LEGAL
+//
+#include "keygen/crypto/cpu_features.h"
+
+#ifdef KEYGEN_CRYPTO_X86_64
+#ifdef _MSC_VER
+#include <intrin.h>
+#else // _MSC_VER
+#include <cpuid.h>
+#endif // _MSC_VER
+
+namespace Keygen::Crypto::details {
+
+CpuIdResult CpuId(uint32_t leaf, uint32_t subleaf) {
+	auto result = CpuIdResult();
+#ifdef _MSC_VER
+	int registers[4] = { 0 };
+	__cpuidex(registers, int(leaf), int(subleaf));
+	result.eax = uint32_t(registers[0]);
+	result.ebx = uint32_t(registers[1]);
+	result.ecx = uint32_t(registers[2]);
+	result.edx = uint32_t(registers[3]);
+#else // _MSC_VER
+	__cpuid_count(
+		leaf,
+		subleaf,
+		result.eax,
+		result.ebx,
+		result.ecx,
+		result.edx);
+#endif // _MSC_VER
+	return result;
+}
+
+uint64_t EnabledXsaveFeatures() {
+#ifdef _MSC_VER
+	return _xgetbv(0);
+#else // _MSC_VER
+	auto eax = uint32_t(0);
+	auto edx = uint32_t(0);
+	__asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+	return (uint64_t(edx) << 32) | eax;
+#endif // _MSC_VER
+}
+
+} // namespace Keygen::Crypto::details
+
+#endif // KEYGEN_CRYPTO_X86_64
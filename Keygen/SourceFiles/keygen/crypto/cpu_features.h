@@ -0,0 +1,36 @@
+// This file is part of TON Key Generator,
+// a desktop application for the TON Blockchain project.
+//
+// For license and copyright information please follow this link:
+// https://github.com/ton-blockchain/tonkeygen/blob/master/LEGAL
+//
+#pragma once
+
+// Included by translation units built with different instruction sets,
+// so it must not depend on the precompiled header.
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define KEYGEN_CRYPTO_X86_64
+#endif // __x86_64__ || _M_X64
+
+namespace Keygen::Crypto::details {
+
+#ifdef KEYGEN_CRYPTO_X86_64
+
+struct CpuIdResult {
+	uint32_t eax = 0;
+	uint32_t ebx = 0;
+	uint32_t ecx = 0;
+	uint32_t edx = 0;
+};
+
+[[nodiscard]] CpuIdResult CpuId(uint32_t leaf, uint32_t subleaf);
+
+// The XCR0 register, which register states the OS saves on switches.
+// Check the OSXSAVE bit of CpuId(1, 0) before calling it.
+[[nodiscard]] uint64_t EnabledXsaveFeatures();
+
+#endif // KEYGEN_CRYPTO_X86_64
+
+} // namespace Keygen::Crypto::details
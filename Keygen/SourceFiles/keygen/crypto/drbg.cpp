@@ -0,0 +1,135 @@
+// This file is part of TON Key Generator,
+// a desktop application for the TON Blockchain project.
+//
+// For license and copyright information please follow this link:
+// https://github.com/ton-blockchain/tonkeygen/blob/master/LEGAL
+//
+#include "keygen/crypto/drbg.h"
+
+#include <openssl/crypto.h>
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+
+namespace Keygen::Crypto {
+namespace {
+
+constexpr auto kSystemSeedSize = 48;
+
+void Sha512(
+		std::initializer_list<std::pair<const void*, size_t>> parts,
+		uchar *result) {
+	const auto context = EVP_MD_CTX_new();
+	Assert(context != nullptr);
+
+	EVP_DigestInit_ex(context, EVP_sha512(), nullptr);
+	for (const auto &[data, size] : parts) {
+		EVP_DigestUpdate(context, data, size);
+	}
+	EVP_DigestFinal_ex(context, result, nullptr);
+	EVP_MD_CTX_free(context);
+}
+
+[[nodiscard]] std::array<uchar, kSystemSeedSize> SystemSeed() {
+	auto result = std::array<uchar, kSystemSeedSize>();
+	const auto generated = RAND_bytes(result.data(), result.size());
+	Assert(generated == 1);
+	return result;
+}
+
+} // namespace
+
+DrbgCounters &DrbgCounters::operator+=(const DrbgCounters &other) {
+	draws += other.draws;
+	bytes += other.bytes;
+	reseeds += other.reseeds;
+	return *this;
+}
+
+Drbg::Drbg(const QByteArray &seed, int stream)
+: _context(EVP_CIPHER_CTX_new()) {
+	Expects(_context != nullptr);
+
+	const auto index = int32(stream);
+	auto system = SystemSeed();
+	auto state = std::array<uchar, 64>();
+	static_assert(kStateSize <= state.size());
+	Sha512({
+		{ seed.constData(), size_t(seed.size()) },
+		{ system.data(), system.size() },
+		{ &index, sizeof(index) },
+	}, state.data());
+	rekey(state.data());
+	OPENSSL_cleanse(system.data(), system.size());
+	OPENSSL_cleanse(state.data(), state.size());
+}
+
+Drbg::~Drbg() {
+	EVP_CIPHER_CTX_free(_context);
+}
+
+void Drbg::generate(uchar *buffer, int size) {
+	Expects(size >= 0);
+
+	if (_drawsSinceReseed == kReseedInterval) {
+		reseed();
+	}
+	keystream(buffer, size);
+
+	// Replace the key, so that a later state leak can't reveal
+	// the output given out already.
+	auto state = std::array<uchar, kStateSize>();
+	keystream(state.data(), state.size());
+	rekey(state.data());
+	OPENSSL_cleanse(state.data(), state.size());
+
+	++_drawsSinceReseed;
+	++_counters.draws;
+	_counters.bytes += size;
+}
+
+const DrbgCounters &Drbg::counters() const {
+	return _counters;
+}
+
+void Drbg::keystream(uchar *buffer, int size) {
+	// CTR mode output over zeros is the bare keystream.
+	memset(buffer, 0, size);
+	auto written = 0;
+	const auto done = EVP_EncryptUpdate(
+		_context,
+		buffer,
+		&written,
+		buffer,
+		size);
+	Assert(done == 1 && written == size);
+}
+
+void Drbg::rekey(const uchar *state) {
+	const auto done = EVP_EncryptInit_ex(
+		_context,
+		EVP_aes_256_ctr(),
+		nullptr,
+		state,
+		state + kKeySize);
+	Assert(done == 1);
+}
+
+void Drbg::reseed() {
+	auto current = std::array<uchar, kStateSize>();
+	auto system = SystemSeed();
+	auto state = std::array<uchar, 64>();
+	keystream(current.data(), current.size());
+	Sha512({
+		{ current.data(), current.size() },
+		{ system.data(), system.size() },
+	}, state.data());
+	rekey(state.data());
+	OPENSSL_cleanse(current.data(), current.size());
+	OPENSSL_cleanse(system.data(), system.size());
+	OPENSSL_cleanse(state.data(), state.size());
+
+	_drawsSinceReseed = 0;
+	++_counters.reseeds;
+}
+
+} // namespace Keygen::Crypto
@@ -0,0 +1,56 @@
+// This file is part of TON Key Generator,
+// a desktop application for the TON Blockchain project.
+//
+// For license and copyright information please follow this link:
+// https://github.com/ton-blockchain/tonkeygen/blob/master/LEGAL
+//
+#pragma once
+
+struct evp_cipher_ctx_st;
+
+namespace Keygen::Crypto {
+
+struct DrbgCounters {
+	int64 draws = 0;
+	int64 bytes = 0;
+	int64 reseeds = 0;
+
+	DrbgCounters &operator+=(const DrbgCounters &other);
+};
+
+// AES-256-CTR deterministic random bit generator for a single thread,
+// so that workers never contend on the global OpenSSL generator.
+//
+// The key mixes the caller seed, fresh system randomness and the stream
+// index, so that workers sharing a seed still get distinct outputs. The
+// key is replaced after every draw and mixed with system randomness
+// again every kReseedInterval draws.
+class Drbg final {
+public:
+	static constexpr auto kReseedInterval = 4096;
+
+	Drbg(const QByteArray &seed, int stream);
+	Drbg(const Drbg &other) = delete;
+	Drbg &operator=(const Drbg &other) = delete;
+	~Drbg();
+
+	void generate(uchar *buffer, int size);
+
+	[[nodiscard]] const DrbgCounters &counters() const;
+
+private:
+	static constexpr auto kKeySize = 32;
+	static constexpr auto kIvSize = 16;
+	static constexpr auto kStateSize = kKeySize + kIvSize;
+
+	void keystream(uchar *buffer, int size);
+	void rekey(const uchar *state);
+	void reseed();
+
+	evp_cipher_ctx_st *_context = nullptr;
+	DrbgCounters _counters;
+	int _drawsSinceReseed = 0;
+
+};
+
+} // namespace Keygen::Crypto
@@ -0,0 +1,547 @@
+// This file is part of TON Key Generator,
+// a desktop application for the TON Blockchain project.
+//
+// For license and copyright information please follow this link:
+// https://github.com/ton-blockchain/tonkeygen/blob/master/LEGAL
+//
+#include "keygen/crypto/ed25519.h"
+
+#include <openssl/crypto.h>
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+
+#include <chrono>
+
+namespace Keygen::Crypto {
+namespace {
+
+constexpr auto kLimbs = 5;
+constexpr auto kLimbBits = 51;
+constexpr auto kLimbMask = (uint64(1) << kLimbBits) - 1;
+constexpr auto kTableRows = 32;
+constexpr auto kTableColumns = 8;
+constexpr auto kBenchmarkBatch = 256;
+
+// Little-endian x coordinate of the Ed25519 base point, y is 4/5.
+constexpr auto kBasePointX = std::array<uchar, 32>{ {
+	0x1a, 0xd5, 0x25, 0x8f, 0x60, 0x2d, 0x56, 0xc9,
+	0xb2, 0xa7, 0x25, 0x95, 0x60, 0xc7, 0x2c, 0x69,
+	0x5c, 0xdc, 0xd6, 0xfd, 0x31, 0xe2, 0xa4, 0xc0,
+	0xfe, 0x53, 0x6e, 0xcd, 0xd3, 0x36, 0x69, 0x21,
+} };
+
+// Element of GF(2^255 - 19) in five limbs of 51 bits. Every operation
+// returns limbs below 2^52, so any two results may be multiplied without
+// overflowing the 128 bit sums.
+struct FieldElement {
+	std::array<uint64, kLimbs> limbs = { { 0 } };
+};
+
+#ifdef __SIZEOF_INT128__
+using Wide = unsigned __int128;
+
+[[nodiscard]] inline Wide Product(uint64 a, uint64 b) {
+	return Wide(a) * b;
+}
+
+[[nodiscard]] inline uint64 Low(Wide value) {
+	return uint64(value);
+}
+
+[[nodiscard]] inline uint64 Carried(Wide value) {
+	return uint64(value >> kLimbBits);
+}
+#else // __SIZEOF_INT128__
+struct Wide {
+	uint64 low = 0;
+	uint64 high = 0;
+};
+
+[[nodiscard]] inline Wide operator+(Wide a, Wide b) {
+	const auto low = a.low + b.low;
+	return { low, a.high + b.high + ((low < a.low) ? 1 : 0) };
+}
+
+[[nodiscard]] inline Wide Product(uint64 a, uint64 b) {
+	constexpr auto kHalf = uint64(0xFFFFFFFFULL);
+	const auto ll = (a & kHalf) * (b & kHalf);
+	const auto lh = (a & kHalf) * (b >> 32);
+	const auto hl = (a >> 32) * (b & kHalf);
+	const auto hh = (a >> 32) * (b >> 32);
+	const auto middle = (ll >> 32) + (lh & kHalf) + (hl & kHalf);
+	return {
+		(ll & kHalf) | (middle << 32),
+		hh + (lh >> 32) + (hl >> 32) + (middle >> 32),
+	};
+}
+
+[[nodiscard]] inline uint64 Low(Wide value) {
+	return value.low;
+}
+
+[[nodiscard]] inline uint64 Carried(Wide value) {
+	return (value.low >> kLimbBits) | (value.high << (64 - kLimbBits));
+}
+#endif // __SIZEOF_INT128__
+
+// X:Y:Z:T with x = X / Z, y = Y / Z and x * y = T / Z.
+struct ExtendedPoint {
+	FieldElement x, y, z, t;
+};
+
+// ((X:Z), (Y:T)), the result of an addition or a doubling.
+struct CompletedPoint {
+	FieldElement x, y, z, t;
+};
+
+struct ProjectivePoint {
+	FieldElement x, y, z;
+};
+
+// Affine (y + x, y - x, 2 * d * x * y) for the mixed addition.
+struct PrecomputedPoint {
+	FieldElement yPlusX, yMinusX, xy2d;
+};
+
+struct BaseTable {
+	FieldElement d2;
+	// points[i][j] is (j + 1) * 256^i * B.
+	std::array<std::array<PrecomputedPoint, kTableColumns>, kTableRows> points;
+};
+
+void Carry(FieldElement &h) {
+	auto &l = h.limbs;
+	auto carry = uint64(0);
+	for (auto i = 0; i != kLimbs; ++i) {
+		l[i] += carry;
+		carry = l[i] >> kLimbBits;
+		l[i] &= kLimbMask;
+	}
+	l[0] += carry * 19;
+}
+
+[[nodiscard]] FieldElement Reduce(const std::array<Wide, kLimbs> &wide) {
+	auto result = FieldElement();
+	auto &l = result.limbs;
+	auto carry = uint64(0);
+	for (auto i = 0; i != kLimbs; ++i) {
+		const auto value = wide[i] + Wide{ carry };
+		l[i] = Low(value) & kLimbMask;
+		carry = Carried(value);
+	}
+	l[0] += carry * 19;
+	l[1] += l[0] >> kLimbBits;
+	l[0] &= kLimbMask;
+	return result;
+}
+
+[[nodiscard]] FieldElement FromInt(uint64 value) {
+	auto result = FieldElement();
+	result.limbs[0] = value;
+	Carry(result);
+	return result;
+}
+
+[[nodiscard]] FieldElement Add(const FieldElement &f, const FieldElement &g) {
+	auto result = FieldElement();
+	for (auto i = 0; i != kLimbs; ++i) {
+		result.limbs[i] = f.limbs[i] + g.limbs[i];
+	}
+	Carry(result);
+	return result;
+}
+
+[[nodiscard]] FieldElement Sub(const FieldElement &f, const FieldElement &g) {
+	// Add 4 * p first, so that no limb goes below zero.
+	constexpr auto kFirst = (uint64(1) << (kLimbBits + 2)) - 4 * 19;
+	constexpr auto kOther = (uint64(1) << (kLimbBits + 2)) - 4;
+
+	auto result = FieldElement();
+	for (auto i = 0; i != kLimbs; ++i) {
+		result.limbs[i] = f.limbs[i] + (i ? kOther : kFirst) - g.limbs[i];
+	}
+	Carry(result);
+	return result;
+}
+
+[[nodiscard]] FieldElement Neg(const FieldElement &f) {
+	return Sub(FieldElement(), f);
+}
+
+[[nodiscard]] FieldElement Mul(const FieldElement &f, const FieldElement &g) {
+	const auto &a = f.limbs;
+	const auto &b = g.limbs;
+
+	// The limbs past 2^255 wrap around multiplied by 19.
+	const auto b1 = b[1] * 19;
+	const auto b2 = b[2] * 19;
+	const auto b3 = b[3] * 19;
+	const auto b4 = b[4] * 19;
+	return Reduce({
+		Product(a[0], b[0]) + Product(a[1], b4) + Product(a[2], b3)
+			+ Product(a[3], b2) + Product(a[4], b1),
+		Product(a[0], b[1]) + Product(a[1], b[0]) + Product(a[2], b4)
+			+ Product(a[3], b3) + Product(a[4], b2),
+		Product(a[0], b[2]) + Product(a[1], b[1]) + Product(a[2], b[0])
+			+ Product(a[3], b4) + Product(a[4], b3),
+		Product(a[0], b[3]) + Product(a[1], b[2]) + Product(a[2], b[1])
+			+ Product(a[3], b[0]) + Product(a[4], b4),
+		Product(a[0], b[4]) + Product(a[1], b[3]) + Product(a[2], b[2])
+			+ Product(a[3], b[1]) + Product(a[4], b[0]),
+	});
+}
+
+[[nodiscard]] FieldElement Sq(const FieldElement &f) {
+	const auto &a = f.limbs;
+	const auto a0 = a[0] * 2;
+	const auto a1 = a[1] * 2;
+	const auto a2 = a[2] * 38;
+	const auto a3 = a[3] * 19;
+	const auto a4 = a[4] * 19;
+	return Reduce({
+		Product(a[0], a[0]) + Product(a[1], a4 * 2) + Product(a2, a[3]),
+		Product(a0, a[1]) + Product(a[2], a4 * 2) + Product(a[3], a3),
+		Product(a0, a[2]) + Product(a[1], a[1]) + Product(a[3], a4 * 2),
+		Product(a0, a[3]) + Product(a1, a[2]) + Product(a[4], a4),
+		Product(a0, a[4]) + Product(a1, a[3]) + Product(a[2], a[2]),
+	});
+}
+
+[[nodiscard]] FieldElement Invert(const FieldElement &z) {
+	// z^(p - 2), where p - 2 = 2^255 - 21 has only the bits 2 and 4 unset.
+	auto result = FromInt(1);
+	for (auto bit = 254; bit >= 0; --bit) {
+		result = Sq(result);
+		if (bit != 2 && bit != 4) {
+			result = Mul(result, z);
+		}
+	}
+	return result;
+}
+
+// Montgomery's trick: one inversion and three multiplications each.
+void BatchInvert(std::vector<FieldElement> &values) {
+	if (values.empty()) {
+		return;
+	}
+	auto products = std::vector<FieldElement>();
+	products.reserve(values.size());
+	products.push_back(values.front());
+	for (auto i = 1; i != values.size(); ++i) {
+		products.push_back(Mul(products.back(), values[i]));
+	}
+	auto inverted = Invert(products.back());
+	for (auto i = int(values.size()) - 1; i > 0; --i) {
+		const auto value = values[i];
+		values[i] = Mul(inverted, products[i - 1]);
+		inverted = Mul(inverted, value);
+	}
+	values.front() = inverted;
+}
+
+[[nodiscard]] std::vector<FieldElement> InvertedZ(
+		const std::vector<ExtendedPoint> &points) {
+	auto result = ranges::view::all(
+		points
+	) | ranges::view::transform([](const ExtendedPoint &point) {
+		return point.z;
+	}) | ranges::to_vector;
+	BatchInvert(result);
+	return result;
+}
+
+[[nodiscard]] FieldElement FromBytes(const std::array<uchar, 32> &bytes) {
+	auto result = FieldElement();
+	for (auto i = 0; i != kLimbs; ++i) {
+		for (auto bit = 0; bit != kLimbBits; ++bit) {
+			const auto index = i * kLimbBits + bit;
+			const auto value = (bytes[index / 8] >> (index % 8)) & 1;
+			result.limbs[i] |= uint64(value) << bit;
+		}
+	}
+	return result;
+}
+
+[[nodiscard]] std::array<uchar, 32> ToBytes(FieldElement f) {
+	auto &h = f.limbs;
+	Carry(f);
+	Carry(f);
+
+	// Now h < 2^255 + 19, subtract p once if h >= p.
+	auto q = (h[0] + 19) >> kLimbBits;
+	for (auto i = 1; i != kLimbs; ++i) {
+		q = (h[i] + q) >> kLimbBits;
+	}
+	h[0] += 19 * q;
+	for (auto i = 0; i + 1 != kLimbs; ++i) {
+		h[i + 1] += h[i] >> kLimbBits;
+		h[i] &= kLimbMask;
+	}
+	h[kLimbs - 1] &= kLimbMask;
+
+	auto result = std::array<uchar, 32>();
+	auto accumulator = uint64(0);
+	auto accumulated = 0;
+	auto written = 0;
+	for (auto i = 0; i != kLimbs; ++i) {
+		accumulator |= h[i] << accumulated;
+		accumulated += kLimbBits;
+		while (accumulated >= 8) {
+			result[written++] = uchar(accumulator & 0xFF);
+			accumulator >>= 8;
+			accumulated -= 8;
+		}
+	}
+	result[written] = uchar(accumulator);
+	return result;
+}
+
+[[nodiscard]] bool IsNegative(const FieldElement &f) {
+	return (ToBytes(f)[0] & 1);
+}
+
+// Sets f to g if mask is all ones, keeps it if mask is zero.
+void Select(FieldElement &f, const FieldElement &g, uint64 mask) {
+	for (auto i = 0; i != kLimbs; ++i) {
+		f.limbs[i] ^= (f.limbs[i] ^ g.limbs[i]) & mask;
+	}
+}
+
+[[nodiscard]] CompletedPoint AddPrecomputed(
+		const ExtendedPoint &p,
+		const PrecomputedPoint &q) {
+	const auto a = Mul(Add(p.y, p.x), q.yPlusX);
+	const auto b = Mul(Sub(p.y, p.x), q.yMinusX);
+	const auto c = Mul(q.xy2d, p.t);
+	const auto d = Add(p.z, p.z);
+	return {
+		Sub(a, b),
+		Add(a, b),
+		Add(d, c),
+		Sub(d, c),
+	};
+}
+
+[[nodiscard]] ExtendedPoint AddExtended(
+		const ExtendedPoint &p,
+		const ExtendedPoint &q,
+		const FieldElement &d2) {
+	const auto a = Mul(Sub(p.y, p.x), Sub(q.y, q.x));
+	const auto b = Mul(Add(p.y, p.x), Add(q.y, q.x));
+	const auto c = Mul(Mul(p.t, d2), q.t);
+	const auto zz = Mul(p.z, q.z);
+	const auto d = Add(zz, zz);
+	const auto e = Sub(b, a);
+	const auto f = Sub(d, c);
+	const auto g = Add(d, c);
+	const auto h = Add(b, a);
+	return { Mul(e, f), Mul(g, h), Mul(f, g), Mul(e, h) };
+}
+
+[[nodiscard]] CompletedPoint Double(const ProjectivePoint &p) {
+	const auto xx = Sq(p.x);
+	const auto yy = Sq(p.y);
+	const auto zz = Sq(p.z);
+	const auto sum = Sq(Add(p.x, p.y));
+	const auto y = Add(yy, xx);
+	const auto z = Sub(yy, xx);
+	return { Sub(sum, y), y, z, Sub(Add(zz, zz), z) };
+}
+
+[[nodiscard]] ExtendedPoint ToExtended(const CompletedPoint &p) {
+	return { Mul(p.x, p.t), Mul(p.y, p.z), Mul(p.z, p.t), Mul(p.x, p.y) };
+}
+
+[[nodiscard]] ProjectivePoint ToProjective(const CompletedPoint &p) {
+	return { Mul(p.x, p.t), Mul(p.y, p.z), Mul(p.z, p.t) };
+}
+
+[[nodiscard]] ProjectivePoint ToProjective(const ExtendedPoint &p) {
+	return { p.x, p.y, p.z };
+}
+
+[[nodiscard]] ExtendedPoint Identity() {
+	return { FieldElement(), FromInt(1), FromInt(1), FieldElement() };
+}
+
+[[nodiscard]] BaseTable ComputeBaseTable() {
+	auto result = BaseTable();
+	const auto d = Mul(Neg(FromInt(121665)), Invert(FromInt(121666)));
+	result.d2 = Add(d, d);
+
+	const auto x = FromBytes(kBasePointX);
+	const auto y = Mul(FromInt(4), Invert(FromInt(5)));
+	auto row = ExtendedPoint{ x, y, FromInt(1), Mul(x, y) };
+
+	auto points = std::vector<ExtendedPoint>();
+	points.reserve(kTableRows * kTableColumns);
+	for (auto i = 0; i != kTableRows; ++i) {
+		auto multiple = row;
+		for (auto j = 0; j != kTableColumns; ++j) {
+			points.push_back(multiple);
+			multiple = AddExtended(multiple, row, result.d2);
+		}
+		for (auto doubling = 0; doubling != 8; ++doubling) {
+			row = ToExtended(Double(ToProjective(row)));
+		}
+	}
+
+	// The table is stored affine, so invert all the Z at once.
+	const auto inverted = InvertedZ(points);
+	for (auto i = 0; i != points.size(); ++i) {
+		const auto x = Mul(points[i].x, inverted[i]);
+		const auto y = Mul(points[i].y, inverted[i]);
+		auto &entry = result.points[i / kTableColumns][i % kTableColumns];
+		entry.yPlusX = Add(y, x);
+		entry.yMinusX = Sub(y, x);
+		entry.xy2d = Mul(Mul(x, y), result.d2);
+	}
+	return result;
+}
+
+[[nodiscard]] const BaseTable &Table() {
+	static const auto result = ComputeBaseTable();
+	return result;
+}
+
+// Constant time lookup of digit * 256^row * B for digit in [-8, 8].
+[[nodiscard]] PrecomputedPoint Lookup(
+		const BaseTable &table,
+		int row,
+		int64 digit) {
+	const auto negative = uint64(digit) >> 63;
+	const auto negativeMask = uint64(0) - negative;
+	const auto absolute = digit - 2 * int64(negative) * digit;
+	auto result = PrecomputedPoint{ FromInt(1), FromInt(1), FieldElement() };
+	for (auto j = 0; j != kTableColumns; ++j) {
+		const auto equal = (uint64(absolute ^ (j + 1)) - 1) >> 63;
+		const auto mask = uint64(0) - equal;
+		const auto &entry = table.points[row][j];
+		Select(result.yPlusX, entry.yPlusX, mask);
+		Select(result.yMinusX, entry.yMinusX, mask);
+		Select(result.xy2d, entry.xy2d, mask);
+	}
+	const auto negated = PrecomputedPoint{
+		result.yMinusX,
+		result.yPlusX,
+		Neg(result.xy2d),
+	};
+	Select(result.yPlusX, negated.yPlusX, negativeMask);
+	Select(result.yMinusX, negated.yMinusX, negativeMask);
+	Select(result.xy2d, negated.xy2d, negativeMask);
+	return result;
+}
+
+// a * B for a clamped scalar a, with signed radix 16 digits as ref10.
+[[nodiscard]] ExtendedPoint MultiplyBase(
+		const BaseTable &table,
+		const uchar *scalar) {
+	auto digits = std::array<int64, 64>();
+	for (auto i = 0; i != 32; ++i) {
+		digits[2 * i] = scalar[i] & 15;
+		digits[2 * i + 1] = (scalar[i] >> 4) & 15;
+	}
+	auto carry = int64(0);
+	for (auto i = 0; i != 63; ++i) {
+		digits[i] += carry;
+		carry = (digits[i] + 8) >> 4;
+		digits[i] -= carry * 16;
+	}
+	digits[63] += carry;
+
+	auto result = Identity();
+	for (auto i = 1; i < 64; i += 2) {
+		result = ToExtended(
+			AddPrecomputed(result, Lookup(table, i / 2, digits[i])));
+	}
+	auto projective = ToProjective(result);
+	for (auto doubling = 0; doubling != 3; ++doubling) {
+		projective = ToProjective(Double(projective));
+	}
+	result = ToExtended(Double(projective));
+	for (auto i = 0; i < 64; i += 2) {
+		result = ToExtended(
+			AddPrecomputed(result, Lookup(table, i / 2, digits[i])));
+	}
+	OPENSSL_cleanse(digits.data(), digits.size() * sizeof(digits[0]));
+	return result;
+}
+
+} // namespace
+
+void ComputePublicKeys(
+		gsl::span<const Seed> seeds,
+		gsl::span<PublicKey> results) {
+	Expects(seeds.size() == results.size());
+
+	const auto &table = Table();
+	auto points = std::vector<ExtendedPoint>();
+	points.reserve(seeds.size());
+	for (const auto &seed : seeds) {
+		// The private scalar is the clamped first half of SHA-512.
+		auto hash = std::array<uchar, 64>();
+		const auto done = EVP_Digest(
+			seed.data(),
+			32,
+			hash.data(),
+			nullptr,
+			EVP_sha512(),
+			nullptr);
+		Assert(done == 1);
+		hash[0] &= 248;
+		hash[31] &= 63;
+		hash[31] |= 64;
+		points.push_back(MultiplyBase(table, hash.data()));
+		OPENSSL_cleanse(hash.data(), hash.size());
+	}
+
+	const auto inverted = InvertedZ(points);
+	for (auto i = 0; i != points.size(); ++i) {
+		const auto x = Mul(points[i].x, inverted[i]);
+		auto &result = results[i];
+		result = ToBytes(Mul(points[i].y, inverted[i]));
+		result[31] ^= (IsNegative(x) ? 0x80 : 0);
+	}
+}
+
+PublicKeysBenchmark BenchmarkPublicKeys(int keys) {
+	Expects(keys > 0);
+
+	using Clock = std::chrono::steady_clock;
+	const auto perSecond = [&](Clock::time_point start) {
+		const auto elapsed = std::chrono::duration<double>(
+			Clock::now() - start).count();
+		return (elapsed > 0.) ? (keys / elapsed) : 0.;
+	};
+
+	auto seeds = std::vector<Seed>(keys);
+	auto results = std::vector<PublicKey>(keys);
+	Assert(RAND_bytes(seeds.front().data(), keys * sizeof(Seed)) == 1);
+
+	// Build the table before the clock starts.
+	ComputePublicKeys(
+		gsl::make_span(seeds).first(1),
+		gsl::make_span(results).first(1));
+
+	auto result = PublicKeysBenchmark{ keys };
+	const auto batched = Clock::now();
+	for (auto from = 0; from < keys; from += kBenchmarkBatch) {
+		const auto count = std::min(kBenchmarkBatch, keys - from);
+		ComputePublicKeys(
+			gsl::make_span(seeds).subspan(from, count),
+			gsl::make_span(results).subspan(from, count));
+	}
+	result.batchedPerSecond = perSecond(batched);
+
+	const auto single = Clock::now();
+	for (auto i = 0; i != keys; ++i) {
+		// Every key from the batches must match the OpenSSL one.
+		Assert(ComputePublicKey(seeds[i]) == results[i]);
+	}
+	result.singlePerSecond = perSecond(single);
+
+	OPENSSL_cleanse(seeds.data(), seeds.size() * sizeof(Seed));
+	return result;
+}
+
+} // namespace Keygen::Crypto
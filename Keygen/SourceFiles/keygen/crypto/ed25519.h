@@ -0,0 +1,29 @@
+// This file is part of TON Key Generator,
+// a desktop application for the TON Blockchain project.
+//
+// For license and copyright information please follow this link:
+// https://github.com/ton-blockchain/tonkeygen/blob/master/LEGAL
+//
+#pragma once
+
+#include "keygen/crypto/mnemonic.h"
+
+namespace Keygen::Crypto {
+
+// Ed25519 public keys for the first halves of many seeds at once.
+// Uses a precomputed base point table and a single field inversion
+// for the whole batch, the result matches ComputePublicKey.
+void ComputePublicKeys(
+	gsl::span<const Seed> seeds,
+	gsl::span<PublicKey> results);
+
+struct PublicKeysBenchmark {
+	int keys = 0;
+	double batchedPerSecond = 0.;
+	double singlePerSecond = 0.;
+};
+
+// Measures keys per second on the calling thread, so per core.
+[[nodiscard]] PublicKeysBenchmark BenchmarkPublicKeys(int keys);
+
+} // namespace Keygen::Crypto
@@ -0,0 +1,180 @@
+// This file is part of TON Key Generator,
+// a desktop application for the TON Blockchain project.
+//
+// For license and copyright information please follow this link:
+// https://github.com/ton-blockchain/tonkeygen/blob/master/LEGAL
+//
+#include "keygen/crypto/gf256.h"
+
+#include "keygen/crypto/gf256_kernels.h"
+
+#include <openssl/rand.h>
+
+namespace Keygen::Crypto::details {
+
+void Gf256MultiplyAddScalar(
+		uint8_t *to,
+		const uint8_t *from,
+		int size,
+		const Gf256Tables &tables) {
+	for (auto i = 0; i != size; ++i) {
+		const auto value = from[i];
+		to[i] ^= tables.low[value & 0x0F] ^ tables.high[value >> 4];
+	}
+}
+
+} // namespace Keygen::Crypto::details
+
+namespace Keygen::Crypto {
+namespace {
+
+constexpr auto kPolynomial = 0x11B;
+constexpr auto kGenerator = 0x03;
+constexpr auto kSelfTestSize = 16 * 5 + 7;
+
+struct LogTables {
+	std::array<uchar, 2 * 255> exp = { { 0 } };
+	std::array<uchar, 256> log = { { 0 } };
+};
+
+struct Kernel {
+	details::Gf256MultiplyAddRegion multiplyAdd = nullptr;
+	Gf256Kernel type = Gf256Kernel::Scalar;
+};
+
+[[nodiscard]] constexpr int MultiplySlow(int a, int b) {
+	auto result = 0;
+	for (; b != 0; b >>= 1) {
+		if (b & 1) {
+			result ^= a;
+		}
+		a <<= 1;
+		if (a & 0x100) {
+			a ^= kPolynomial;
+		}
+	}
+	return result;
+}
+
+[[nodiscard]] constexpr LogTables ComputeLogTables() {
+	auto result = LogTables();
+	auto value = 1;
+	for (auto power = 0; power != 255; ++power) {
+		// The exponents are doubled so that a sum of two logarithms
+		// never needs a reduction.
+		result.exp[power] = result.exp[power + 255] = uchar(value);
+		result.log[value] = uchar(power);
+		value = MultiplySlow(value, kGenerator);
+	}
+	return result;
+}
+
+constexpr auto kLogTables = ComputeLogTables();
+
+[[nodiscard]] details::Gf256Tables ComputeTables(uchar factor) {
+	auto result = details::Gf256Tables();
+	for (auto nibble = 0; nibble != 16; ++nibble) {
+		result.low[nibble] = Gf256Multiply(factor, uchar(nibble));
+		result.high[nibble] = Gf256Multiply(factor, uchar(nibble << 4));
+	}
+	return result;
+}
+
+[[nodiscard]] bool MatchesScalar(const Kernel &kernel) {
+	auto source = std::array<uchar, kSelfTestSize>();
+	Assert(RAND_bytes(source.data(), source.size()) == 1);
+	for (const auto factor : { 0x01, 0x02, 0x53, 0x8E, 0xFF }) {
+		const auto tables = ComputeTables(uchar(factor));
+		auto expected = source;
+		auto result = source;
+		for (auto i = 0; i != kSelfTestSize; ++i) {
+			expected[i] ^= Gf256Multiply(uchar(factor), source[i]);
+		}
+		kernel.multiplyAdd(
+			result.data(),
+			source.data(),
+			kSelfTestSize,
+			tables);
+		if (result != expected) {
+			return false;
+		}
+	}
+	return true;
+}
+
+#ifdef KEYGEN_CRYPTO_X86_64
+
+[[nodiscard]] bool Supports(Gf256Kernel type) {
+	constexpr auto kSsse3Bit = (1U << 9);
+
+	switch (type) {
+	case Gf256Kernel::Scalar: return true;
+	case Gf256Kernel::Ssse3:
+		return (details::CpuId(1, 0).ecx & kSsse3Bit) != 0;
+	}
+	Unexpected("Type in Supports.");
+}
+
+#endif // KEYGEN_CRYPTO_X86_64
+
+[[nodiscard]] Kernel ChooseKernel() {
+#ifdef KEYGEN_CRYPTO_X86_64
+	const auto ssse3 = Kernel{
+		details::Gf256MultiplyAddSsse3,
+		Gf256Kernel::Ssse3,
+	};
+	if (Supports(ssse3.type) && MatchesScalar(ssse3)) {
+		return ssse3;
+	}
+#endif // KEYGEN_CRYPTO_X86_64
+
+	const auto scalar = Kernel{
+		details::Gf256MultiplyAddScalar,
+		Gf256Kernel::Scalar,
+	};
+	Assert(MatchesScalar(scalar));
+	return scalar;
+}
+
+[[nodiscard]] const Kernel &ActiveKernel() {
+	static const auto result = ChooseKernel();
+	return result;
+}
+
+} // namespace
+
+Gf256Kernel ActiveGf256Kernel() {
+	return ActiveKernel().type;
+}
+
+uchar Gf256Multiply(uchar a, uchar b) {
+	if (!a || !b) {
+		return 0;
+	}
+	return kLogTables.exp[kLogTables.log[a] + kLogTables.log[b]];
+}
+
+uchar Gf256Inverse(uchar a) {
+	Expects(a != 0);
+
+	return kLogTables.exp[255 - kLogTables.log[a]];
+}
+
+void Gf256MultiplyAdd(
+		gsl::span<uchar> to,
+		gsl::span<const uchar> from,
+		uchar factor) {
+	Expects(to.size() == from.size());
+
+	if (!factor) {
+		return;
+	}
+	const auto tables = ComputeTables(factor);
+	ActiveKernel().multiplyAdd(
+		to.data(),
+		from.data(),
+		int(to.size()),
+		tables);
+}
+
+} // namespace Keygen::Crypto
@@ -0,0 +1,32 @@
+// This file is part of TON Key Generator,
+// a desktop application for the TON Blockchain project.
+//
+// For license and copyright information please follow this link:
+// https://github.com/ton-blockchain/tonkeygen/blob/master/LEGAL
+//
+#pragma once
+
+namespace Keygen::Crypto {
+
+// GF(2^8) with the AES polynomial x^8 + x^4 + x^3 + x + 1.
+
+enum class Gf256Kernel {
+	Scalar,
+	Ssse3,
+};
+
+// The widest kernel this CPU runs, checked against the scalar one on
+// first use.
+[[nodiscard]] Gf256Kernel ActiveGf256Kernel();
+
+[[nodiscard]] uchar Gf256Multiply(uchar a, uchar b);
+[[nodiscard]] uchar Gf256Inverse(uchar a);
+
+// to[i] ^= factor * from[i] for all the bytes. The bytes are looked up
+// only in the 16 entry nibble tables of the factor.
+void Gf256MultiplyAdd(
+	gsl::span<uchar> to,
+	gsl::span<const uchar> from,
+	uchar factor);
+
+} // namespace Keygen::Crypto
@@ -0,0 +1,45 @@
+// This file is part of TON Key Generator,
+// a desktop application for the TON Blockchain project.
+//
+// For license and copyright information please follow this link:
+// https://github.com/ton-blockchain/tonkeygen/blob/master/LEGAL
+//
+#pragma once
+
+// Included by translation units built with different instruction sets,
+// so it must not depend on the precompiled header.
+#include "keygen/crypto/cpu_features.h"
+
+#include <cstdint>
+
+namespace Keygen::Crypto::details {
+
+// Products of one factor with every low and every high nibble, so that
+// factor * byte == low[byte & 0x0F] ^ high[byte >> 4].
+struct Gf256Tables {
+	alignas(16) uint8_t low[16];
+	alignas(16) uint8_t high[16];
+};
+
+// to[i] ^= factor * from[i] for all the size bytes.
+using Gf256MultiplyAddRegion = void(*)(
+	uint8_t *to,
+	const uint8_t *from,
+	int size,
+	const Gf256Tables &tables);
+
+void Gf256MultiplyAddScalar(
+	uint8_t *to,
+	const uint8_t *from,
+	int size,
+	const Gf256Tables &tables);
+
+#ifdef KEYGEN_CRYPTO_X86_64
+void Gf256MultiplyAddSsse3(
+	uint8_t *to,
+	const uint8_t *from,
+	int size,
+	const Gf256Tables &tables);
+#endif // KEYGEN_CRYPTO_X86_64
+
+} // namespace Keygen::Crypto::details
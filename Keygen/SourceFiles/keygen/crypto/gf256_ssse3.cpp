@@ -0,0 +1,46 @@
+// This file is part of TON Key Generator,
+// a desktop application for the TON Blockchain project.
+//
+// For license and copyright information please follow this link:
+// https://github.com/ton-blockchain/tonkeygen/blob/master/LEGAL
+//
+#include "keygen/crypto/gf256_kernels.h"
+
+#ifdef KEYGEN_CRYPTO_X86_64
+
+#include <tmmintrin.h>
+
+namespace Keygen::Crypto::details {
+
+void Gf256MultiplyAddSsse3(
+		uint8_t *to,
+		const uint8_t *from,
+		int size,
+		const Gf256Tables &tables) {
+	// Each shuffle looks up sixteen nibbles in a table at once.
+	const auto low = _mm_load_si128(
+		reinterpret_cast<const __m128i*>(tables.low));
+	const auto high = _mm_load_si128(
+		reinterpret_cast<const __m128i*>(tables.high));
+	const auto mask = _mm_set1_epi8(0x0F);
+
+	auto i = 0;
+	for (; i + 16 <= size; i += 16) {
+		const auto source = _mm_loadu_si128(
+			reinterpret_cast<const __m128i*>(from + i));
+		const auto target = reinterpret_cast<__m128i*>(to + i);
+		const auto product = _mm_xor_si128(
+			_mm_shuffle_epi8(low, _mm_and_si128(source, mask)),
+			_mm_shuffle_epi8(
+				high,
+				_mm_and_si128(_mm_srli_epi64(source, 4), mask)));
+		_mm_storeu_si128(
+			target,
+			_mm_xor_si128(_mm_loadu_si128(target), product));
+	}
+	Gf256MultiplyAddScalar(to + i, from + i, size - i, tables);
+}
+
+} // namespace Keygen::Crypto::details
+
+#endif // KEYGEN_CRYPTO_X86_64
@@ -0,0 +1,981 @@
+// This file is part of TON Key Generator,
+// a desktop application for the TON Blockchain project.
+//
+// For license and copyright information please follow this link:
+// https://github.com/ton-blockchain/tonkeygen/blob/master/LEGAL
+//
+#include "keygen/crypto/mnemonic.h"
+
+#include "keygen/crypto/ed25519.h"
+#include "keygen/crypto/pbkdf2_sha512.h"
+#include "keygen/crypto/shamir.h"
+
+#include <openssl/crypto.h>
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+#include <openssl/sha.h>
+
+#include <thread>
+
+namespace Keygen::Crypto {
+namespace {
+
+constexpr auto kWordIndexMask = 2047;
+constexpr auto kWordIndexBits = 11;
+constexpr auto kShareHeaderSize = 4;
+constexpr auto kRecoveryChunkLanes = 4;
+constexpr auto kPublicKeyTag = std::array<uchar, 2>{ { 0x3E, 0xE6 } };
+constexpr auto kSerializedKeySize = 36;
+
+const auto kSeedSalt = QByteArray("TON default seed");
+const auto kBasicSeedSalt = QByteArray("TON seed version");
+const auto kPasswordSeedSalt = QByteArray("TON fast seed version");
+const auto kBase64UrlAlphabet = QByteArray(
+	"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_");
+
+using RandomWords = std::array<uint16, kMnemonicWordsCount>;
+
+// The point, the threshold, two bytes of the public key hash and the
+// share value. Its 296 bits fill all the words but one padding bit.
+using PackedShare = std::array<uchar, kShareHeaderSize + kShamirSecretSize>;
+
+static_assert(kMnemonicWordsCount * kWordIndexBits == kShamirSecretSize * 8);
+static_assert(
+	(kShareWordsCount - 1) * kWordIndexBits < sizeof(PackedShare) * 8
+	&& kShareWordsCount * kWordIndexBits >= sizeof(PackedShare) * 8);
+
+template <size_t Size>
+[[nodiscard]] std::array<uchar, Size> Pbkdf2Sha512(
+		const Entropy &entropy,
+		const QByteArray &salt,
+		int iterations) {
+	auto result = std::array<uchar, Size>();
+	const auto done = PKCS5_PBKDF2_HMAC(
+		reinterpret_cast<const char*>(entropy.data()),
+		entropy.size(),
+		reinterpret_cast<const uchar*>(salt.constData()),
+		salt.size(),
+		iterations,
+		EVP_sha512(),
+		result.size(),
+		result.data());
+	Assert(done == 1);
+	return result;
+}
+
+// Big endian bit string of the bytes cut into word indices, the last
+// one padded with zero bits.
+[[nodiscard]] std::vector<int> BytesToIndices(gsl::span<const uchar> bytes) {
+	auto result = std::vector<int>();
+	result.reserve((bytes.size() * 8 + kWordIndexBits - 1) / kWordIndexBits);
+	auto accumulator = uint32(0);
+	auto bits = 0;
+	for (const auto byte : bytes) {
+		accumulator = (accumulator << 8) | byte;
+		bits += 8;
+		while (bits >= kWordIndexBits) {
+			bits -= kWordIndexBits;
+			result.push_back(int(accumulator >> bits) & kWordIndexMask);
+		}
+	}
+	if (bits > 0) {
+		const auto padded = accumulator << (kWordIndexBits - bits);
+		result.push_back(int(padded) & kWordIndexMask);
+	}
+	return result;
+}
+
+// Fails if there are not enough indices or the padding bits are not zero.
+[[nodiscard]] bool IndicesToBytes(
+		gsl::span<const int> indices,
+		gsl::span<uchar> bytes) {
+	auto accumulator = uint32(0);
+	auto bits = 0;
+	auto filled = 0;
+	for (const auto index : indices) {
+		accumulator = (accumulator << kWordIndexBits) | uint32(index);
+		bits += kWordIndexBits;
+		while (bits >= 8 && filled != bytes.size()) {
+			bits -= 8;
+			bytes[filled++] = uchar(accumulator >> bits);
+		}
+	}
+	const auto padding = accumulator & ((uint32(1) << bits) - 1);
+	return (filled == bytes.size()) && (bits < 8) && !padding;
+}
+
+[[nodiscard]] std::array<uchar, 2> KeyFingerprint(
+		const QByteArray &publicKey) {
+	auto hash = std::array<uchar, SHA256_DIGEST_LENGTH>();
+	SHA256(
+		reinterpret_cast<const uchar*>(publicKey.constData()),
+		publicKey.size(),
+		hash.data());
+	return { { hash[0], hash[1] } };
+}
+
+template <typename Block>
+void Cleanse(std::vector<Block> &blocks) {
+	OPENSSL_cleanse(blocks.data(), blocks.size() * sizeof(Block));
+}
+
+[[nodiscard]] int WorkersCount() {
+	return std::max(int(std::thread::hardware_concurrency()), 1);
+}
+
+// Workers take chunks of [0, count) until work(worker, from, till)
+// returns false or nothing is left.
+template <typename Work>
+void RunOnAllCores(int count, int chunk, Work &&work) {
+	auto next = std::atomic<int>(0);
+	const auto loop = [&](int worker) {
+		while (true) {
+			const auto from = next.fetch_add(chunk);
+			if (from >= count) {
+				return;
+			} else if (!work(worker, from, std::min(from + chunk, count))) {
+				return;
+			}
+		}
+	};
+	const auto workers = WorkersCount();
+	auto threads = std::vector<std::thread>();
+	threads.reserve(workers - 1);
+	for (auto i = 1; i < workers; ++i) {
+		threads.emplace_back(loop, i);
+	}
+	loop(0);
+	for (auto &thread : threads) {
+		thread.join();
+	}
+}
+
+// Returns indices of the phrases that are basic seeds with the password.
+// With a password they must be password seeds without it first.
+[[nodiscard]] std::vector<int> FilterBasicSeeds(
+		const std::vector<QByteArray> &phrases,
+		const QByteArray &password) {
+	auto indices = std::vector<int>();
+	auto entropies = std::vector<Entropy>();
+	indices.reserve(phrases.size());
+	entropies.reserve(phrases.size());
+	for (auto i = 0; i != phrases.size(); ++i) {
+		indices.push_back(i);
+		entropies.push_back(ComputeEntropy(phrases[i], QByteArray()));
+	}
+	auto derived = std::vector<Pbkdf2Block>(entropies.size());
+	if (!password.isEmpty()) {
+		Pbkdf2Sha512Many(entropies, kPasswordSeedSalt, 1, derived);
+		auto kept = 0;
+		for (auto i = 0; i != entropies.size(); ++i) {
+			if (derived[i][0] == 1) {
+				indices[kept] = i;
+				entropies[kept++] = ComputeEntropy(phrases[i], password);
+			}
+		}
+		OPENSSL_cleanse(
+			entropies.data() + kept,
+			(entropies.size() - kept) * sizeof(Entropy));
+		indices.resize(kept);
+		entropies.resize(kept);
+		derived.resize(kept);
+	}
+	Pbkdf2Sha512Many(
+		entropies,
+		kBasicSeedSalt,
+		kBasicSeedIterations,
+		derived);
+	auto result = std::vector<int>();
+	for (auto i = 0; i != entropies.size(); ++i) {
+		if (derived[i][0] == 0) {
+			result.push_back(indices[i]);
+		}
+	}
+	Cleanse(entropies);
+	Cleanse(derived);
+	return result;
+}
+
+} // namespace
+
+QByteArray JoinWords(const std::vector<QByteArray> &words) {
+	auto result = QByteArray();
+	for (const auto &word : words) {
+		if (!result.isEmpty()) {
+			result.append(' ');
+		}
+		result.append(word);
+	}
+	return result;
+}
+
+Entropy ComputeEntropy(const QByteArray &phrase, const QByteArray &password) {
+	auto result = Entropy();
+	auto size = uint32(result.size());
+	const auto done = HMAC(
+		EVP_sha512(),
+		phrase.constData(),
+		phrase.size(),
+		reinterpret_cast<const uchar*>(password.constData()),
+		password.size(),
+		result.data(),
+		&size);
+	Assert(done != nullptr && size == result.size());
+	return result;
+}
+
+bool IsBasicSeed(const Entropy &entropy) {
+	const auto result = Pbkdf2Sha512<64>(
+		entropy,
+		kBasicSeedSalt,
+		kBasicSeedIterations);
+	return (result[0] == 0);
+}
+
+bool IsPasswordSeed(const Entropy &entropy) {
+	const auto result = Pbkdf2Sha512<64>(entropy, kPasswordSeedSalt, 1);
+	return (result[0] == 1);
+}
+
+Seed ComputeSeed(const Entropy &entropy) {
+	return Pbkdf2Sha512<64>(entropy, kSeedSalt, kSeedIterations);
+}
+
+PublicKey ComputePublicKey(const Seed &seed) {
+	// The first half of the seed is the Ed25519 private key.
+	const auto key = EVP_PKEY_new_raw_private_key(
+		EVP_PKEY_ED25519,
+		nullptr,
+		seed.data(),
+		32);
+	Assert(key != nullptr);
+
+	auto result = PublicKey();
+	auto size = size_t(result.size());
+	const auto done = EVP_PKEY_get_raw_public_key(key, result.data(), &size);
+	EVP_PKEY_free(key);
+	Assert(done == 1 && size == result.size());
+	return result;
+}
+
+QByteArray SerializePublicKey(const PublicKey &key) {
+	auto buffer = std::array<uchar, kSerializedKeySize>();
+	std::copy(begin(kPublicKeyTag), end(kPublicKeyTag), buffer.data());
+	std::copy(begin(key), end(key), buffer.data() + kPublicKeyTag.size());
+	const auto crc = Crc16(buffer.data(), 34);
+	buffer[34] = uchar(crc >> 8);
+	buffer[35] = uchar(crc & 0xFF);
+	return QByteArray(
+		reinterpret_cast<const char*>(buffer.data()),
+		buffer.size()
+	).toBase64(QByteArray::Base64UrlEncoding);
+}
+
+std::optional<PublicKey> ParsePublicKey(const QByteArray &serialized) {
+	const auto bytes = QByteArray::fromBase64(
+		serialized,
+		QByteArray::Base64UrlEncoding);
+	if (bytes.size() != kSerializedKeySize) {
+		return std::nullopt;
+	}
+	const auto data = reinterpret_cast<const uchar*>(bytes.constData());
+	const auto crc = Crc16(data, 34);
+	if (!std::equal(begin(kPublicKeyTag), end(kPublicKeyTag), data)
+		|| data[34] != uchar(crc >> 8)
+		|| data[35] != uchar(crc & 0xFF)) {
+		return std::nullopt;
+	}
+	auto result = PublicKey();
+	const auto key = data + kPublicKeyTag.size();
+	std::copy(key, key + result.size(), begin(result));
+	return result;
+}
+
+uint16 Crc16(const uchar *data, int size) {
+	// CRC-16/XMODEM, the one td::crc16 computes.
+	auto result = uint16(0);
+	for (auto i = 0; i != size; ++i) {
+		result ^= uint16(data[i]) << 8;
+		for (auto bit = 0; bit != 8; ++bit) {
+			result = (result & 0x8000)
+				? uint16((result << 1) ^ 0x1021)
+				: uint16(result << 1);
+		}
+	}
+	return result;
+}
+
+double Base64PatternChance(
+		const QByteArray &pattern,
+		gsl::span<const uchar> fixed,
+		int size) {
+	if (pattern.size() * 6 > size * 8) {
+		return 0.;
+	}
+	auto result = 1.;
+	for (auto i = 0; i != pattern.size(); ++i) {
+		const auto value = kBase64UrlAlphabet.indexOf(pattern[i]);
+		if (value < 0) {
+			return 0.;
+		}
+		for (auto bit = 0; bit != 6; ++bit) {
+			const auto position = i * 6 + bit;
+			const auto byte = position / 8;
+			if (byte >= fixed.size()) {
+				result /= 2.;
+				continue;
+			}
+			const auto expected = (value >> (5 - bit)) & 1;
+			const auto actual = (fixed[byte] >> (7 - position % 8)) & 1;
+			if (expected != actual) {
+				return 0.;
+			}
+		}
+	}
+	return result;
+}
+
+double PublicKeyPatternChance(const QByteArray &pattern) {
+	return Base64PatternChance(pattern, kPublicKeyTag, kSerializedKeySize);
+}
+
+MnemonicEngine::MnemonicEngine(std::vector<QByteArray> wordlist)
+: _wordlist(std::move(wordlist)) {
+	Expects(ranges::is_sorted(_wordlist));
+}
+
+int MnemonicEngine::wordlistSize() const {
+	return int(_wordlist.size());
+}
+
+const QByteArray &MnemonicEngine::word(int index) const {
+	Expects(index >= 0 && index < _wordlist.size());
+
+	return _wordlist[index];
+}
+
+bool MnemonicEngine::isValidWord(const QByteArray &word) const {
+	return std::binary_search(begin(_wordlist), end(_wordlist), word);
+}
+
+bool MnemonicEngine::isValidWords(
+		const std::vector<QByteArray> &words) const {
+	return (words.size() == kMnemonicWordsCount)
+		&& ranges::all_of(words, [&](const QByteArray &word) {
+			return isValidWord(word);
+		});
+}
+
+CheckedKey MnemonicEngine::check(
+		const std::vector<QByteArray> &words,
+		const QByteArray &password) const {
+	const auto invalid = [] {
+		return CheckedKey{ QByteArray(), MnemonicError::InvalidMnemonic };
+	};
+	if (!isValidWords(words)) {
+		return invalid();
+	}
+	const auto phrase = JoinWords(words);
+	if (!password.isEmpty()) {
+		// Only the words created for a password may be used with one.
+		auto plain = ComputeEntropy(phrase, QByteArray());
+		const auto passwordSeed = IsPasswordSeed(plain);
+		OPENSSL_cleanse(plain.data(), plain.size());
+		if (!passwordSeed) {
+			return invalid();
+		}
+	}
+	auto entropy = ComputeEntropy(phrase, password);
+	if (!IsBasicSeed(entropy)) {
+		const auto needPassword = password.isEmpty()
+			&& IsPasswordSeed(entropy);
+		OPENSSL_cleanse(entropy.data(), entropy.size());
+		return needPassword
+			? CheckedKey{ QByteArray(), MnemonicError::NeedPassword }
+			: invalid();
+	}
+	auto seed = ComputeSeed(entropy);
+	const auto key = ComputePublicKey(seed);
+	OPENSSL_cleanse(entropy.data(), entropy.size());
+	OPENSSL_cleanse(seed.data(), seed.size());
+	return { SerializePublicKey(key) };
+}
+
+std::vector<CheckedKey> MnemonicEngine::check(
+		const std::vector<std::vector<QByteArray>> &batch) const {
+	auto result = std::vector<CheckedKey>(
+		batch.size(),
+		CheckedKey{ QByteArray(), MnemonicError::InvalidMnemonic });
+
+	// Each PBKDF2 step runs for all the lists at once, so that
+	// the multi-buffer kernel gets its lanes filled.
+	auto indices = std::vector<int>();
+	auto entropies = std::vector<Entropy>();
+	for (auto i = 0; i != batch.size(); ++i) {
+		if (isValidWords(batch[i])) {
+			indices.push_back(i);
+			entropies.push_back(
+				ComputeEntropy(JoinWords(batch[i]), QByteArray()));
+		}
+	}
+	auto derived = std::vector<Pbkdf2Block>(entropies.size());
+	Pbkdf2Sha512Many(
+		entropies,
+		kBasicSeedSalt,
+		kBasicSeedIterations,
+		derived);
+
+	auto passed = std::vector<Entropy>();
+	auto passedIndices = std::vector<int>();
+	auto failed = std::vector<Entropy>();
+	auto failedIndices = std::vector<int>();
+	for (auto i = 0; i != entropies.size(); ++i) {
+		const auto basic = (derived[i][0] == 0);
+		(basic ? passed : failed).push_back(entropies[i]);
+		(basic ? passedIndices : failedIndices).push_back(indices[i]);
+	}
+	Cleanse(entropies);
+
+	derived.resize(failed.size());
+	Pbkdf2Sha512Many(failed, kPasswordSeedSalt, 1, derived);
+	for (auto i = 0; i != failed.size(); ++i) {
+		if (derived[i][0] == 1) {
+			result[failedIndices[i]].error = MnemonicError::NeedPassword;
+		}
+	}
+	Cleanse(failed);
+
+	derived.resize(passed.size());
+	Pbkdf2Sha512Many(passed, kSeedSalt, kSeedIterations, derived);
+	auto keys = std::vector<PublicKey>(passed.size());
+	ComputePublicKeys(derived, keys);
+	for (auto i = 0; i != passed.size(); ++i) {
+		result[passedIndices[i]] = CheckedKey{ SerializePublicKey(keys[i]) };
+	}
+	Cleanse(passed);
+	Cleanse(derived);
+	return result;
+}
+
+std::vector<int> MnemonicEngine::filterValid(
+		const std::vector<std::vector<QByteArray>> &lists,
+		const QByteArray &password) const {
+	auto indices = std::vector<int>();
+	auto phrases = std::vector<QByteArray>();
+	indices.reserve(lists.size());
+	phrases.reserve(lists.size());
+	for (auto i = 0; i != lists.size(); ++i) {
+		if (isValidWords(lists[i])) {
+			indices.push_back(i);
+			phrases.push_back(JoinWords(lists[i]));
+		}
+	}
+	auto result = FilterBasicSeeds(phrases, password);
+	for (auto &index : result) {
+		index = indices[index];
+	}
+	return result;
+}
+
+std::vector<QByteArray> MnemonicEngine::publicKeys(
+		const std::vector<std::vector<QByteArray>> &lists,
+		const QByteArray &password) const {
+	auto entropies = std::vector<Entropy>();
+	entropies.reserve(lists.size());
+	for (const auto &words : lists) {
+		entropies.push_back(ComputeEntropy(JoinWords(words), password));
+	}
+	auto seeds = std::vector<Pbkdf2Block>(entropies.size());
+	Pbkdf2Sha512Many(entropies, kSeedSalt, kSeedIterations, seeds);
+	auto keys = std::vector<PublicKey>(seeds.size());
+	ComputePublicKeys(seeds, keys);
+	Cleanse(entropies);
+	Cleanse(seeds);
+
+	return ranges::view::all(
+		keys
+	) | ranges::view::transform([](const PublicKey &key) {
+		return SerializePublicKey(key);
+	}) | ranges::to_vector;
+}
+
+std::optional<std::vector<RecoveredKey>> MnemonicEngine::recover(
+		const RecoveryRequest &request,
+		Fn<void(int, int)> progress,
+		const std::atomic<bool> *cancelled) const {
+	Expects(request.words.size() == kMnemonicWordsCount);
+
+	struct Variant {
+		int position = 0;
+		const QByteArray *word = nullptr;
+	};
+	auto variants = std::vector<Variant>();
+	for (const auto &slot : request.slots) {
+		Expects(slot.position >= 0 && slot.position < kMnemonicWordsCount);
+
+		for (const auto &candidate : slot.candidates) {
+			if (candidate != request.words[slot.position]) {
+				variants.push_back({ slot.position, &candidate });
+			}
+		}
+	}
+	const auto wordsFor = [&](int index) {
+		const auto &variant = variants[index];
+		auto result = request.words;
+		result[variant.position] = *variant.word;
+		return result;
+	};
+	const auto count = int(variants.size());
+	const auto workers = WorkersCount();
+	auto found = std::atomic<bool>(false);
+	const auto stopped = [&] {
+		return found.load() || (cancelled && cancelled->load());
+	};
+
+	// Every 256th list passes the basic seed check and its key costs
+	// as much as 256 of those checks, so the keys are expected to take
+	// about the same time as the checks before them.
+	constexpr auto kKeyCost = kSeedIterations / kBasicSeedIterations;
+	auto done = std::atomic<int>(0);
+	auto total = std::atomic<int>(2 * count);
+	const auto report = [&](int units) {
+		if (progress) {
+			progress(done += units, total.load());
+		}
+	};
+
+	// First find the valid lists, the checks fill the lanes in chunks.
+	auto passed = std::vector<std::vector<int>>(workers);
+	const auto chunk = Pbkdf2Lanes() * kRecoveryChunkLanes;
+	const auto checkBasic = [&](int worker, int from, int till) {
+		if (stopped()) {
+			return false;
+		}
+		auto phrases = std::vector<QByteArray>();
+		phrases.reserve(till - from);
+		for (auto i = from; i != till; ++i) {
+			phrases.push_back(JoinWords(wordsFor(i)));
+		}
+		const auto basic = FilterBasicSeeds(phrases, request.password);
+		for (const auto index : basic) {
+			passed[worker].push_back(from + index);
+		}
+		report(till - from);
+		return true;
+	};
+	RunOnAllCores(count, chunk, checkBasic);
+	if (stopped()) {
+		return std::nullopt;
+	}
+	auto valid = std::vector<int>();
+	for (const auto &list : passed) {
+		valid.insert(end(valid), begin(list), end(list));
+	}
+	std::sort(begin(valid), end(valid));
+	total = count + int(valid.size()) * kKeyCost;
+
+	// Then derive the keys for them, a full set of lanes at a time.
+	auto keys = std::vector<std::vector<std::pair<int, RecoveredKey>>>(
+		workers);
+	const auto deriveKeys = [&](int worker, int from, int till) {
+		if (stopped()) {
+			return false;
+		}
+		auto entropies = std::vector<Entropy>();
+		entropies.reserve(till - from);
+		for (auto i = from; i != till; ++i) {
+			entropies.push_back(ComputeEntropy(
+				JoinWords(wordsFor(valid[i])),
+				request.password));
+		}
+		auto seeds = std::vector<Pbkdf2Block>(entropies.size());
+		Pbkdf2Sha512Many(entropies, kSeedSalt, kSeedIterations, seeds);
+		auto publicKeys = std::vector<PublicKey>(seeds.size());
+		ComputePublicKeys(seeds, publicKeys);
+		Cleanse(entropies);
+		Cleanse(seeds);
+
+		for (auto i = from; i != till; ++i) {
+			auto serialized = SerializePublicKey(publicKeys[i - from]);
+			if (!request.publicKey.isEmpty()) {
+				if (serialized != request.publicKey) {
+					continue;
+				}
+				found = true;
+			}
+			keys[worker].emplace_back(valid[i], RecoveredKey{
+				wordsFor(valid[i]),
+				std::move(serialized),
+				variants[valid[i]].position,
+			});
+		}
+		report((till - from) * kKeyCost);
+		return true;
+	};
+	RunOnAllCores(int(valid.size()), Pbkdf2Lanes(), deriveKeys);
+	if (!found && cancelled && cancelled->load()) {
+		return std::nullopt;
+	}
+	auto ordered = std::vector<std::pair<int, RecoveredKey>>();
+	for (auto &list : keys) {
+		for (auto &key : list) {
+			ordered.push_back(std::move(key));
+		}
+	}
+	std::sort(begin(ordered), end(ordered), [](const auto &a, const auto &b) {
+		return a.first < b.first;
+	});
+	auto result = std::vector<RecoveredKey>();
+	result.reserve(ordered.size());
+	for (auto &[index, key] : ordered) {
+		result.push_back(std::move(key));
+	}
+	return result;
+}
+
+std::vector<KeyShares> MnemonicEngine::split(
+		const std::vector<std::vector<QByteArray>> &lists,
+		const std::vector<QByteArray> &publicKeys,
+		int threshold,
+		int count) const {
+	Expects(_wordlist.size() == kWordIndexMask + 1);
+	Expects(lists.size() == publicKeys.size());
+	Expects(threshold > 1 && threshold <= count);
+	Expects(count <= kShamirSharesMax);
+
+	auto secrets = std::vector<ShamirSecret>(lists.size());
+	auto indices = std::vector<int>(kMnemonicWordsCount);
+	for (auto i = 0; i != lists.size(); ++i) {
+		Expects(lists[i].size() == kMnemonicWordsCount);
+
+		for (auto j = 0; j != kMnemonicWordsCount; ++j) {
+			indices[j] = wordIndex(lists[i][j]);
+
+			Expects(indices[j] >= 0);
+		}
+		const auto filled = IndicesToBytes(indices, secrets[i]);
+		Assert(filled);
+	}
+	auto shares = SplitSecrets(secrets, threshold, count);
+	Cleanse(secrets);
+	ranges::fill(indices, 0);
+
+	auto result = std::vector<KeyShares>(lists.size());
+	auto packed = PackedShare();
+	for (auto i = 0; i != lists.size(); ++i) {
+		const auto fingerprint = KeyFingerprint(publicKeys[i]);
+		for (auto &share : shares[i]) {
+			packed[0] = share.index;
+			packed[1] = uchar(threshold);
+			packed[2] = fingerprint[0];
+			packed[3] = fingerprint[1];
+			std::copy(
+				begin(share.value),
+				end(share.value),
+				begin(packed) + kShareHeaderSize);
+			OPENSSL_cleanse(share.value.data(), share.value.size());
+
+			auto &words = result[i].emplace_back();
+			words.reserve(kShareWordsCount);
+			for (const auto index : BytesToIndices(packed)) {
+				words.push_back(_wordlist[index]);
+			}
+		}
+	}
+	OPENSSL_cleanse(packed.data(), packed.size());
+	return result;
+}
+
+CombinedKey MnemonicEngine::combine(
+		const KeyShares &shares,
+		const QByteArray &password) const {
+	const auto fail = [](SharesError error) {
+		return CombinedKey{ {}, QByteArray(), error };
+	};
+	if (_wordlist.size() != kWordIndexMask + 1) {
+		return fail(SharesError::InvalidShares);
+	}
+	auto parsed = std::vector<ShamirShare>();
+	auto threshold = 0;
+	auto fingerprint = std::array<uchar, 2>();
+	auto indices = std::vector<int>(kShareWordsCount);
+	auto packed = PackedShare();
+	const auto cleanse = [&] {
+		for (auto &share : parsed) {
+			OPENSSL_cleanse(share.value.data(), share.value.size());
+		}
+		OPENSSL_cleanse(packed.data(), packed.size());
+		ranges::fill(indices, 0);
+	};
+	for (const auto &words : shares) {
+		if (words.size() != kShareWordsCount) {
+			cleanse();
+			return fail(SharesError::InvalidShares);
+		}
+		for (auto i = 0; i != kShareWordsCount; ++i) {
+			indices[i] = wordIndex(words[i]);
+		}
+		if (ranges::find(indices, -1) != end(indices)
+			|| !IndicesToBytes(indices, packed)
+			|| !packed[0]
+			|| packed[1] < 2
+			|| (!parsed.empty()
+				&& (packed[1] != threshold
+					|| packed[2] != fingerprint[0]
+					|| packed[3] != fingerprint[1]))) {
+			cleanse();
+			return fail(SharesError::InvalidShares);
+		}
+		threshold = packed[1];
+		fingerprint = { { packed[2], packed[3] } };
+
+		auto share = ShamirShare{ packed[0] };
+		std::copy(
+			begin(packed) + kShareHeaderSize,
+			end(packed),
+			begin(share.value));
+		const auto same = ranges::find(
+			parsed,
+			share.index,
+			&ShamirShare::index);
+		if (same == end(parsed)) {
+			parsed.push_back(share);
+		} else if (same->value != share.value) {
+			cleanse();
+			return fail(SharesError::InvalidShares);
+		}
+		OPENSSL_cleanse(share.value.data(), share.value.size());
+	}
+	if (!threshold || int(parsed.size()) < threshold) {
+		cleanse();
+		return fail(SharesError::NotEnoughShares);
+	}
+	parsed.resize(threshold);
+	auto secret = CombineShares(parsed);
+	Assert(secret.has_value());
+	const auto unpacked = [&] {
+		auto result = BytesToIndices(*secret);
+		OPENSSL_cleanse(secret->data(), secret->size());
+		return result;
+	}();
+	cleanse();
+
+	auto result = CombinedKey();
+	result.words = ranges::view::all(
+		unpacked
+	) | ranges::view::transform([&](int index) {
+		return _wordlist[index];
+	}) | ranges::to_vector;
+	const auto checked = check(result.words, password);
+	switch (checked.error) {
+	case MnemonicError::None: break;
+	case MnemonicError::NeedPassword:
+		return fail(SharesError::NeedPassword);
+	case MnemonicError::InvalidMnemonic:
+		// With a wrong password the words are most likely invalid.
+		return fail(password.isEmpty()
+			? SharesError::InvalidShares
+			: SharesError::KeyMismatch);
+	}
+	if (KeyFingerprint(checked.publicKey) != fingerprint) {
+		return fail(SharesError::KeyMismatch);
+	}
+	result.publicKey = checked.publicKey;
+	return result;
+}
+
+std::vector<QByteArray> MnemonicEngine::wordsFromRandom(
+		const std::array<uint16, kMnemonicWordsCount> &random) const {
+	Expects(_wordlist.size() == kWordIndexMask + 1);
+
+	auto result = std::vector<QByteArray>();
+	result.reserve(random.size());
+	for (const auto value : random) {
+		result.push_back(_wordlist[value & kWordIndexMask]);
+	}
+	return result;
+}
+
+std::optional<CreatedKey> MnemonicEngine::create(
+		const QByteArray &seed,
+		const QByteArray &password,
+		const std::atomic<bool> *cancelled) const {
+	return search(seed, password, nullptr, nullptr, cancelled);
+}
+
+std::optional<CreatedKey> MnemonicEngine::createMatching(
+		const QByteArray &seed,
+		const QByteArray &password,
+		KeyMatcher matches,
+		Fn<void(int64)> progress,
+		const std::atomic<bool> *cancelled) const {
+	Expects(matches != nullptr);
+
+	return search(seed, password, matches, progress, cancelled);
+}
+
+int MnemonicEngine::wordIndex(const QByteArray &word) const {
+	const auto i = std::lower_bound(begin(_wordlist), end(_wordlist), word);
+	return (i != end(_wordlist) && *i == word)
+		? int(i - begin(_wordlist))
+		: -1;
+}
+
+std::optional<CreatedKey> MnemonicEngine::search(
+		const QByteArray &seed,
+		const QByteArray &password,
+		const KeyMatcher &matches,
+		const Fn<void(int64)> &progress,
+		const std::atomic<bool> *cancelled) const {
+	const auto workers = WorkersCount();
+	auto counters = std::vector<DrbgCounters>(workers);
+	auto found = std::atomic<bool>(false);
+	auto attempts = std::atomic<int64>(0);
+	auto keys = std::atomic<int64>(0);
+	auto result = std::optional<CreatedKey>();
+
+	const auto stopped = [&] {
+		return found.load() || (cancelled && cancelled->load());
+	};
+	const auto work = [&](int index) {
+		// Each worker has its own generator, so they never contend.
+		auto drbg = Drbg(seed, index);
+
+		// Test as many candidates at once as the PBKDF2 kernel has lanes.
+		const auto lanes = Pbkdf2Lanes();
+		auto random = std::vector<RandomWords>(lanes);
+		auto entropies = std::vector<Entropy>(lanes);
+		auto derived = std::vector<Pbkdf2Block>(lanes);
+		const auto bytes = reinterpret_cast<uchar*>(random.data());
+		const auto size = int(random.size() * sizeof(random.front()));
+
+		// Password seeds wait here until they fill all the lanes.
+		auto pending = std::vector<RandomWords>();
+		pending.reserve(2 * lanes);
+
+		// With a matcher the valid lists wait here to get their keys.
+		auto valid = std::vector<RandomWords>();
+		auto validEntropies = std::vector<Entropy>();
+		auto seeds = std::vector<Seed>(matches ? lanes : 0);
+		auto publicKeys = std::vector<PublicKey>(matches ? lanes : 0);
+		valid.reserve(matches ? (2 * lanes) : 0);
+		validEntropies.reserve(matches ? (2 * lanes) : 0);
+
+		const auto deriveKeys = [&] {
+			Pbkdf2Sha512Many(
+				gsl::make_span(validEntropies.data(), lanes),
+				kSeedSalt,
+				kSeedIterations,
+				seeds);
+			ComputePublicKeys(seeds, publicKeys);
+			const auto derivedKeys = (keys += lanes);
+			if (progress) {
+				progress(derivedKeys);
+			}
+			for (auto i = 0; i != lanes; ++i) {
+				if (!matches(publicKeys[i]) || found.exchange(true)) {
+					continue;
+				}
+				result = CreatedKey{
+					wordsFromRandom(valid[i]),
+					SerializePublicKey(publicKeys[i]),
+				};
+				break;
+			}
+			OPENSSL_cleanse(valid.data(), lanes * sizeof(RandomWords));
+			OPENSSL_cleanse(validEntropies.data(), lanes * sizeof(Entropy));
+			valid.erase(begin(valid), begin(valid) + lanes);
+			validEntropies.erase(
+				begin(validEntropies),
+				begin(validEntropies) + lanes);
+			Cleanse(seeds);
+		};
+		const auto checkBasic = [&](const RandomWords *candidates) {
+			for (auto i = 0; i != lanes; ++i) {
+				entropies[i] = ComputeEntropy(
+					JoinWords(wordsFromRandom(candidates[i])),
+					password);
+			}
+			Pbkdf2Sha512Many(
+				entropies,
+				kBasicSeedSalt,
+				kBasicSeedIterations,
+				derived);
+			for (auto i = 0; i != lanes; ++i) {
+				if (derived[i][0] != 0) {
+					continue;
+				} else if (matches) {
+					valid.push_back(candidates[i]);
+					validEntropies.push_back(entropies[i]);
+					continue;
+				} else if (found.exchange(true)) {
+					break;
+				}
+				// Only the first valid candidate gets here.
+				auto derivedSeed = ComputeSeed(entropies[i]);
+				const auto key = ComputePublicKey(derivedSeed);
+				OPENSSL_cleanse(derivedSeed.data(), derivedSeed.size());
+				result = CreatedKey{
+					wordsFromRandom(candidates[i]),
+					SerializePublicKey(key),
+				};
+				break;
+			}
+			if (int(valid.size()) >= lanes) {
+				deriveKeys();
+			}
+		};
+		while (!stopped()) {
+			drbg.generate(bytes, size);
+			attempts += lanes;
+
+			if (password.isEmpty()) {
+				checkBasic(random.data());
+				continue;
+			}
+			for (auto i = 0; i != lanes; ++i) {
+				entropies[i] = ComputeEntropy(
+					JoinWords(wordsFromRandom(random[i])),
+					QByteArray());
+			}
+			Pbkdf2Sha512Many(entropies, kPasswordSeedSalt, 1, derived);
+			for (auto i = 0; i != lanes; ++i) {
+				if (derived[i][0] == 1) {
+					pending.push_back(random[i]);
+				}
+			}
+			if (int(pending.size()) >= lanes) {
+				checkBasic(pending.data());
+				OPENSSL_cleanse(pending.data(), lanes * sizeof(RandomWords));
+				pending.erase(begin(pending), begin(pending) + lanes);
+			}
+		}
+		OPENSSL_cleanse(bytes, size);
+		Cleanse(pending);
+		Cleanse(valid);
+		Cleanse(validEntropies);
+		Cleanse(entropies);
+		Cleanse(derived);
+		counters[index] = drbg.counters();
+	};
+
+	auto threads = std::vector<std::thread>();
+	threads.reserve(workers - 1);
+	for (auto i = 1; i < workers; ++i) {
+		threads.emplace_back(work, i);
+	}
+	work(0);
+	for (auto &thread : threads) {
+		thread.join();
+	}
+
+	if (result) {
+		result->attempts = attempts.load();
+		for (const auto &worker : counters) {
+			result->drbg += worker;
+		}
+	}
+	return result;
+}
+
+} // namespace Keygen::Crypto
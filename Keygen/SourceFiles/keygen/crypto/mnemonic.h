@@ -0,0 +1,211 @@
+// This file is part of TON Key Generator,
+// a desktop application for the TON Blockchain project.
+//
+// For license and copyright information please follow this link:
+// https://github.com/ton-blockchain/tonkeygen/blob/master/LEGAL
+//
+#pragma once
+
+#include "keygen/crypto/drbg.h"
+
+#include <atomic>
+
+namespace Keygen::Crypto {
+
+inline constexpr auto kMnemonicWordsCount = 24;
+inline constexpr auto kShareWordsCount = kMnemonicWordsCount + 3;
+inline constexpr auto kSeedIterations = 100000;
+inline constexpr auto kBasicSeedIterations = kSeedIterations / 256;
+
+using Entropy = std::array<uchar, 64>;
+using Seed = std::array<uchar, 64>;
+using PublicKey = std::array<uchar, 32>;
+
+// The same steps tonlib takes in tonlib/keys/Mnemonic.cpp.
+[[nodiscard]] QByteArray JoinWords(const std::vector<QByteArray> &words);
+[[nodiscard]] Entropy ComputeEntropy(
+	const QByteArray &phrase,
+	const QByteArray &password);
+[[nodiscard]] bool IsBasicSeed(const Entropy &entropy);
+[[nodiscard]] bool IsPasswordSeed(const Entropy &entropy);
+[[nodiscard]] Seed ComputeSeed(const Entropy &entropy);
+[[nodiscard]] PublicKey ComputePublicKey(const Seed &seed);
+
+// Base64url of the tagged key with CRC16, as tonlib prints it.
+[[nodiscard]] QByteArray SerializePublicKey(const PublicKey &key);
+[[nodiscard]] std::optional<PublicKey> ParsePublicKey(
+	const QByteArray &serialized);
+
+// CRC-16/XMODEM of the tagged user-friendly TON formats.
+[[nodiscard]] uint16 Crc16(const uchar *data, int size);
+
+// Chance for base64url of size bytes to start with the pattern, when
+// they start with the fixed ones and the rest are random.
+[[nodiscard]] double Base64PatternChance(
+	const QByteArray &pattern,
+	gsl::span<const uchar> fixed,
+	int size);
+
+// Chance for a random key to be serialized starting with the pattern.
+// Zero if no key can, the first characters encode the fixed tag.
+[[nodiscard]] double PublicKeyPatternChance(const QByteArray &pattern);
+
+using KeyMatcher = Fn<bool(const PublicKey &key)>;
+
+enum class MnemonicError {
+	None,
+	InvalidMnemonic,
+	NeedPassword,
+};
+
+struct CheckedKey {
+	QByteArray publicKey;
+	MnemonicError error = MnemonicError::None;
+};
+
+struct CreatedKey {
+	std::vector<QByteArray> words;
+	QByteArray publicKey;
+	int64 attempts = 0;
+	DrbgCounters drbg;
+};
+
+enum class SharesError {
+	None,
+	InvalidShares,
+	NotEnoughShares,
+	NeedPassword,
+	KeyMismatch,
+};
+
+struct CombinedKey {
+	std::vector<QByteArray> words;
+	QByteArray publicKey;
+	SharesError error = SharesError::None;
+};
+
+// Words of each share of one word list.
+using KeyShares = std::vector<std::vector<QByteArray>>;
+
+// Words to put instead of the one at the position, most likely first.
+struct RecoverySlot {
+	int position = 0;
+	std::vector<QByteArray> candidates;
+};
+
+struct RecoveryRequest {
+	std::vector<QByteArray> words;
+	std::vector<RecoverySlot> slots;
+	QByteArray password;
+
+	// Serialized, as SerializePublicKey returns it. If it is empty all
+	// the valid word lists are collected.
+	QByteArray publicKey;
+};
+
+struct RecoveredKey {
+	std::vector<QByteArray> words;
+	QByteArray publicKey;
+	int position = 0;
+};
+
+// In-process replacement for the tonlib key requests. All the methods
+// are synchronous and thread-safe, so they may run on any thread.
+class MnemonicEngine final {
+public:
+	// Expects the sorted list of 2048 words tonlib uses.
+	explicit MnemonicEngine(std::vector<QByteArray> wordlist);
+
+	[[nodiscard]] int wordlistSize() const;
+	[[nodiscard]] const QByteArray &word(int index) const;
+	[[nodiscard]] bool isValidWord(const QByteArray &word) const;
+
+	[[nodiscard]] bool isValidWords(
+		const std::vector<QByteArray> &words) const;
+
+	[[nodiscard]] CheckedKey check(
+		const std::vector<QByteArray> &words,
+		const QByteArray &password = QByteArray()) const;
+
+	// Runs each derivation step for the whole batch at once.
+	[[nodiscard]] std::vector<CheckedKey> check(
+		const std::vector<std::vector<QByteArray>> &batch) const;
+
+	// Draws random word lists on all cores until one of them is a valid
+	// mnemonic. Returns nothing only if cancelled is set meanwhile.
+	//
+	// With a password the words must also be a password seed without it,
+	// so about 256 times more lists are drawn. Those are filtered by the
+	// cheap one-iteration check before the basic seed one.
+	[[nodiscard]] std::optional<CreatedKey> create(
+		const QByteArray &seed,
+		const QByteArray &password = QByteArray(),
+		const std::atomic<bool> *cancelled = nullptr) const;
+
+	// Like create(), but goes on until the key satisfies the matcher.
+	// The keys of the valid lists are derived a full lanes batch at once
+	// and progress gets the count of keys derived so far from any thread.
+	[[nodiscard]] std::optional<CreatedKey> createMatching(
+		const QByteArray &seed,
+		const QByteArray &password,
+		KeyMatcher matches,
+		Fn<void(int64)> progress,
+		const std::atomic<bool> *cancelled = nullptr) const;
+
+	// The batched derivation path for large searches, on the calling
+	// thread. Returns indices of the lists valid with the password.
+	[[nodiscard]] std::vector<int> filterValid(
+		const std::vector<std::vector<QByteArray>> &lists,
+		const QByteArray &password = QByteArray()) const;
+
+	// Serialized public keys of lists that passed filterValid.
+	[[nodiscard]] std::vector<QByteArray> publicKeys(
+		const std::vector<std::vector<QByteArray>> &lists,
+		const QByteArray &password = QByteArray()) const;
+
+	// Replaces one word with each of the slot candidates on all cores.
+	// The lists come in the slots and candidates order, with a public key
+	// the search stops on the first list that derives to it.
+	//
+	// Progress gets (done, total) in basic seed checks from any thread,
+	// the total grows when the lists that passed need their keys.
+	// Returns nothing only if cancelled is set meanwhile.
+	[[nodiscard]] std::optional<std::vector<RecoveredKey>> recover(
+		const RecoveryRequest &request,
+		Fn<void(int, int)> progress = nullptr,
+		const std::atomic<bool> *cancelled = nullptr) const;
+
+	// Splits each list into count shares of kShareWordsCount words, any
+	// threshold of them give the list back. The first words of a share
+	// hold its number, the threshold and 16 bits of the public key hash,
+	// the rest is the share of the packed word indices.
+	[[nodiscard]] std::vector<KeyShares> split(
+		const std::vector<std::vector<QByteArray>> &lists,
+		const std::vector<QByteArray> &publicKeys,
+		int threshold,
+		int count) const;
+
+	// Takes the words back from at least threshold shares of one list and
+	// checks the public key they derive to against the shares.
+	[[nodiscard]] CombinedKey combine(
+		const KeyShares &shares,
+		const QByteArray &password = QByteArray()) const;
+
+	// Picks the words from random 16 bit values, like tonlib does.
+	[[nodiscard]] std::vector<QByteArray> wordsFromRandom(
+		const std::array<uint16, kMnemonicWordsCount> &random) const;
+
+private:
+	[[nodiscard]] int wordIndex(const QByteArray &word) const;
+	[[nodiscard]] std::optional<CreatedKey> search(
+		const QByteArray &seed,
+		const QByteArray &password,
+		const KeyMatcher &matches,
+		const Fn<void(int64)> &progress,
+		const std::atomic<bool> *cancelled) const;
+
+	std::vector<QByteArray> _wordlist;
+
+};
+
+} // namespace Keygen::Crypto
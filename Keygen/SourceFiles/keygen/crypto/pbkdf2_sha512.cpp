@@ -0,0 +1,371 @@
+// This file is part of TON Key Generator,
+// a desktop application for the TON Blockchain project.
+//
+// For license and copyright information please follow this link:
+// https://github.com/ton-blockchain/tonkeygen/blob/master/LEGAL
+//
+#include "keygen/crypto/pbkdf2_sha512.h"
+
+#include "keygen/crypto/pbkdf2_sha512_lanes.h"
+#include "keygen/crypto/cpu_features.h"
+
+#include <openssl/crypto.h>
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+
+namespace Keygen::Crypto::details {
+namespace {
+
+struct ScalarOps {
+	using Vector = uint64_t;
+	static constexpr auto kLanes = 1;
+
+	static Vector Set(uint64_t value) {
+		return value;
+	}
+	static Vector Add(Vector a, Vector b) {
+		return a + b;
+	}
+	static Vector Xor(Vector a, Vector b) {
+		return a ^ b;
+	}
+	static Vector And(Vector a, Vector b) {
+		return a & b;
+	}
+	static Vector AndNot(Vector a, Vector b) {
+		return ~a & b;
+	}
+	template <int Count>
+	static Vector Rotr(Vector a) {
+		return (a >> Count) | (a << (64 - Count));
+	}
+	template <int Count>
+	static Vector Shr(Vector a) {
+		return a >> Count;
+	}
+	static Vector Gather(const uint64_t *words) {
+		return *words;
+	}
+	static void Scatter(uint64_t *words, Vector value) {
+		*words = value;
+	}
+};
+
+} // namespace
+
+void Pbkdf2IterateScalar(
+		const uint64_t *inner,
+		const uint64_t *outer,
+		const uint64_t *first,
+		uint64_t *result,
+		int count) {
+	Pbkdf2IterateLanes<ScalarOps>(inner, outer, first, result, count);
+}
+
+} // namespace Keygen::Crypto::details
+
+namespace Keygen::Crypto {
+namespace {
+
+using details::kSha512StateWords;
+using details::kSha512BlockWords;
+
+constexpr auto kBlockSize = kSha512BlockWords * 8;
+constexpr auto kHashSize = kSha512StateWords * 8;
+constexpr auto kMaxLanes = 8;
+constexpr auto kSelfTestKeys = 2 * kMaxLanes + 3;
+constexpr auto kSelfTestRounds = 4;
+
+constexpr uint64 kSha512Initial[kSha512StateWords] = {
+	0x6a09e667f3bcc908ULL, 0xbb67ae8584caa73bULL, 0x3c6ef372fe94f82bULL,
+	0xa54ff53a5f1d36f1ULL, 0x510e527fade682d1ULL, 0x9b05688c2b3e6c1fULL,
+	0x1f83d9abfb41bd6bULL, 0x5be0cd19137e2179ULL,
+};
+
+struct Kernel {
+	details::Pbkdf2Iterate iterate = nullptr;
+	int lanes = 0;
+	Pbkdf2Kernel type = Pbkdf2Kernel::Scalar;
+};
+
+[[nodiscard]] uint64 ReadBigEndian(const uchar *data) {
+	auto result = uint64(0);
+	for (auto i = 0; i != 8; ++i) {
+		result = (result << 8) | data[i];
+	}
+	return result;
+}
+
+void WriteBigEndian(uchar *data, uint64 value) {
+	for (auto i = 8; i != 0;) {
+		data[--i] = uchar(value & 0xFF);
+		value >>= 8;
+	}
+}
+
+void Compress(uint64 *state, const uchar *block) {
+	uint64 w[details::kSha512Rounds];
+	for (auto i = 0; i != kSha512BlockWords; ++i) {
+		w[i] = ReadBigEndian(block + i * 8);
+	}
+	details::Sha512Compress<details::ScalarOps>(state, w);
+	OPENSSL_cleanse(w, sizeof(w));
+}
+
+// Hashes the rest of the message after `prefix` bytes already absorbed.
+void Finish(uint64 *state, const uchar *data, int size, int prefix) {
+	auto block = std::array<uchar, kBlockSize>();
+	auto offset = 0;
+	for (; size - offset >= kBlockSize; offset += kBlockSize) {
+		Compress(state, data + offset);
+	}
+	const auto left = size - offset;
+	std::copy(data + offset, data + size, block.data());
+	block[left] = 0x80;
+	if (left + 1 + 16 > kBlockSize) {
+		Compress(state, block.data());
+		block.fill(0);
+	}
+	WriteBigEndian(
+		block.data() + kBlockSize - 8,
+		uint64(prefix + size) * 8);
+	Compress(state, block.data());
+	OPENSSL_cleanse(block.data(), block.size());
+}
+
+// Fills the HMAC states of the key and U1 = HMAC(key, salt || INT(1)).
+void PrepareLane(
+		const Pbkdf2Block &key,
+		const QByteArray &message,
+		uint64 *inner,
+		uint64 *outer,
+		uint64 *first) {
+	auto block = std::array<uchar, kBlockSize>();
+	const auto pad = [&](uchar value, uint64 *state) {
+		for (auto i = 0; i != kBlockSize; ++i) {
+			block[i] = (i < int(key.size())) ? uchar(key[i] ^ value) : value;
+		}
+		std::copy(std::begin(kSha512Initial), std::end(kSha512Initial), state);
+		Compress(state, block.data());
+	};
+	pad(0x36, inner);
+	pad(0x5C, outer);
+
+	uint64 hash[kSha512StateWords];
+	std::copy(inner, inner + kSha512StateWords, hash);
+	Finish(
+		hash,
+		reinterpret_cast<const uchar*>(message.constData()),
+		message.size(),
+		kBlockSize);
+
+	block.fill(0);
+	for (auto i = 0; i != kSha512StateWords; ++i) {
+		WriteBigEndian(block.data() + i * 8, hash[i]);
+	}
+	std::copy(outer, outer + kSha512StateWords, first);
+	Finish(first, block.data(), kHashSize, kBlockSize);
+
+	OPENSSL_cleanse(block.data(), block.size());
+	OPENSSL_cleanse(hash, sizeof(hash));
+}
+
+void Derive(
+		const Kernel &kernel,
+		gsl::span<const Pbkdf2Block> keys,
+		const QByteArray &salt,
+		int iterations,
+		gsl::span<Pbkdf2Block> results) {
+	Expects(keys.size() == results.size());
+	Expects(iterations > 0);
+	Expects(kernel.lanes > 0 && kernel.lanes <= kMaxLanes);
+
+	constexpr auto kWords = kMaxLanes * kSha512StateWords;
+	uint64 inner[kWords], outer[kWords], first[kWords], result[kWords];
+
+	auto message = salt;
+	message.append("\0\0\0\1", 4);
+
+	const auto count = int(keys.size());
+	for (auto from = 0; from < count; from += kernel.lanes) {
+		for (auto lane = 0; lane != kernel.lanes; ++lane) {
+			// Repeat the last key to fill the lanes of a partial group.
+			const auto index = std::min(from + lane, count - 1);
+			const auto shift = lane * kSha512StateWords;
+			PrepareLane(
+				keys[index],
+				message,
+				inner + shift,
+				outer + shift,
+				first + shift);
+		}
+		kernel.iterate(inner, outer, first, result, iterations);
+		for (auto lane = 0; lane != kernel.lanes; ++lane) {
+			if (from + lane == count) {
+				break;
+			}
+			auto &block = results[from + lane];
+			for (auto i = 0; i != kSha512StateWords; ++i) {
+				WriteBigEndian(
+					block.data() + i * 8,
+					result[lane * kSha512StateWords + i]);
+			}
+		}
+	}
+	OPENSSL_cleanse(inner, sizeof(inner));
+	OPENSSL_cleanse(outer, sizeof(outer));
+	OPENSSL_cleanse(first, sizeof(first));
+	OPENSSL_cleanse(result, sizeof(result));
+}
+
+// Compares the kernel with OpenSSL on random keys and salts, including
+// partial lane groups and salts that spill into a second block.
+[[nodiscard]] bool MatchesOpenSSL(const Kernel &kernel) {
+	auto keys = std::vector<Pbkdf2Block>(kSelfTestKeys);
+	auto results = std::vector<Pbkdf2Block>(kSelfTestKeys);
+	for (auto round = 0; round != kSelfTestRounds; ++round) {
+		auto salt = QByteArray(round * 50, Qt::Uninitialized);
+		for (auto &key : keys) {
+			Assert(RAND_bytes(key.data(), key.size()) == 1);
+		}
+		if (!salt.isEmpty()) {
+			Assert(RAND_bytes(
+				reinterpret_cast<uchar*>(salt.data()),
+				salt.size()) == 1);
+		}
+		const auto iterations = 1 + round * 3;
+		Derive(kernel, keys, salt, iterations, results);
+		for (auto i = 0; i != kSelfTestKeys; ++i) {
+			auto expected = Pbkdf2Block();
+			const auto done = PKCS5_PBKDF2_HMAC(
+				reinterpret_cast<const char*>(keys[i].data()),
+				keys[i].size(),
+				reinterpret_cast<const uchar*>(salt.constData()),
+				salt.size(),
+				iterations,
+				EVP_sha512(),
+				expected.size(),
+				expected.data());
+			Assert(done == 1);
+			if (expected != results[i]) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+#ifdef KEYGEN_CRYPTO_X86_64
+
+[[nodiscard]] bool Supports(Pbkdf2Kernel type) {
+	constexpr auto kOsXsaveBit = (1U << 27);
+	constexpr auto kAvxBit = (1U << 28);
+	constexpr auto kAvx2Bit = (1U << 5);
+	constexpr auto kAvx512FoundationBit = (1U << 16);
+	constexpr auto kYmmState = uint64(0x06);
+	constexpr auto kZmmState = uint64(0xE6);
+
+	if (details::CpuId(0, 0).eax < 7) {
+		return false;
+	}
+	const auto basic = details::CpuId(1, 0);
+	if (!(basic.ecx & kOsXsaveBit) || !(basic.ecx & kAvxBit)) {
+		return false;
+	}
+	const auto enabled = details::EnabledXsaveFeatures();
+	const auto extended = details::CpuId(7, 0);
+	switch (type) {
+	case Pbkdf2Kernel::Scalar: return true;
+	case Pbkdf2Kernel::Avx2:
+		return ((enabled & kYmmState) == kYmmState)
+			&& (extended.ebx & kAvx2Bit);
+	case Pbkdf2Kernel::Avx512:
+		return ((enabled & kZmmState) == kZmmState)
+			&& (extended.ebx & kAvx512FoundationBit);
+	}
+	Unexpected("Type in Supports.");
+}
+
+#endif // KEYGEN_CRYPTO_X86_64
+
+[[nodiscard]] Kernel MakeKernel(Pbkdf2Kernel type) {
+	switch (type) {
+	case Pbkdf2Kernel::Scalar:
+		return { details::Pbkdf2IterateScalar, 1, type };
+#ifdef KEYGEN_CRYPTO_X86_64
+	case Pbkdf2Kernel::Avx2:
+		return { details::Pbkdf2IterateAvx2, details::kAvx2Lanes, type };
+	case Pbkdf2Kernel::Avx512:
+		return {
+			details::Pbkdf2IterateAvx512,
+			details::kAvx512Lanes,
+			type,
+		};
+#endif // KEYGEN_CRYPTO_X86_64
+	}
+	Unexpected("Type in MakeKernel.");
+}
+
+[[nodiscard]] Kernel ChooseKernel() {
+#ifdef KEYGEN_CRYPTO_X86_64
+	for (const auto type : { Pbkdf2Kernel::Avx512, Pbkdf2Kernel::Avx2 }) {
+		if (!Supports(type)) {
+			continue;
+		}
+		const auto kernel = MakeKernel(type);
+		if (MatchesOpenSSL(kernel)) {
+			return kernel;
+		}
+	}
+#endif // KEYGEN_CRYPTO_X86_64
+
+	const auto scalar = MakeKernel(Pbkdf2Kernel::Scalar);
+	Assert(MatchesOpenSSL(scalar));
+	return scalar;
+}
+
+[[nodiscard]] const Kernel &ActiveKernel() {
+	static const auto result = ChooseKernel();
+	return result;
+}
+
+} // namespace
+
+Pbkdf2Kernel ActivePbkdf2Kernel() {
+	return ActiveKernel().type;
+}
+
+int Pbkdf2Lanes() {
+	return ActiveKernel().lanes;
+}
+
+void Pbkdf2Sha512Many(
+		gsl::span<const Pbkdf2Block> keys,
+		const QByteArray &salt,
+		int iterations,
+		gsl::span<Pbkdf2Block> results) {
+	Derive(ActiveKernel(), keys, salt, iterations, results);
+}
+
+std::vector<Pbkdf2Kernel> SupportedPbkdf2Kernels() {
+	auto result = std::vector<Pbkdf2Kernel>{ Pbkdf2Kernel::Scalar };
+#ifdef KEYGEN_CRYPTO_X86_64
+	for (const auto type : { Pbkdf2Kernel::Avx2, Pbkdf2Kernel::Avx512 }) {
+		if (Supports(type)) {
+			result.push_back(type);
+		}
+	}
+#endif // KEYGEN_CRYPTO_X86_64
+	return result;
+}
+
+void Pbkdf2Sha512Many(
+		Pbkdf2Kernel kernel,
+		gsl::span<const Pbkdf2Block> keys,
+		const QByteArray &salt,
+		int iterations,
+		gsl::span<Pbkdf2Block> results) {
+	Derive(MakeKernel(kernel), keys, salt, iterations, results);
+}
+
+} // namespace Keygen::Crypto
@@ -0,0 +1,46 @@
+// This file is part of TON Key Generator,
+// a desktop application for the TON Blockchain project.
+//
+// For license and copyright information please follow this link:
+// https://github.com/ton-blockchain/tonkeygen/blob/master/LEGAL
+//
+#pragma once
+
+namespace Keygen::Crypto {
+
+using Pbkdf2Block = std::array<uchar, 64>;
+
+enum class Pbkdf2Kernel {
+	Scalar,
+	Avx2,
+	Avx512,
+};
+
+// The widest kernel this CPU runs, checked against OpenSSL on first use.
+[[nodiscard]] Pbkdf2Kernel ActivePbkdf2Kernel();
+
+// How many keys the active kernel derives at once, so callers may batch
+// their work in multiples of it.
+[[nodiscard]] int Pbkdf2Lanes();
+
+// The first 64 byte block of PBKDF2-HMAC-SHA512 for each of the keys,
+// all with the same salt and iterations count.
+void Pbkdf2Sha512Many(
+	gsl::span<const Pbkdf2Block> keys,
+	const QByteArray &salt,
+	int iterations,
+	gsl::span<Pbkdf2Block> results);
+
+// All the kernels this CPU runs, the scalar one first. Not checked
+// against OpenSSL, so only for comparing them with it.
+[[nodiscard]] std::vector<Pbkdf2Kernel> SupportedPbkdf2Kernels();
+
+// Same as above, but with the given supported kernel.
+void Pbkdf2Sha512Many(
+	Pbkdf2Kernel kernel,
+	gsl::span<const Pbkdf2Block> keys,
+	const QByteArray &salt,
+	int iterations,
+	gsl::span<Pbkdf2Block> results);
+
+} // namespace Keygen::Crypto
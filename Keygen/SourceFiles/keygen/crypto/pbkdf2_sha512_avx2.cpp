@@ -0,0 +1,74 @@
+// This file is part of TON Key Generator,
+// a desktop application for the TON Blockchain project.
+//
+// For license and copyright information please follow this link:
+// https://github.com/ton-blockchain/tonkeygen/blob/master/LEGAL
+//
+#include "keygen/crypto/pbkdf2_sha512_lanes.h"
+
+#ifdef KEYGEN_CRYPTO_X86_64
+
+#include <immintrin.h>
+
+namespace Keygen::Crypto::details {
+namespace {
+
+struct Avx2Ops {
+	using Vector = __m256i;
+	static constexpr auto kLanes = kAvx2Lanes;
+
+	static Vector Set(uint64_t value) {
+		return _mm256_set1_epi64x(int64_t(value));
+	}
+	static Vector Add(Vector a, Vector b) {
+		return _mm256_add_epi64(a, b);
+	}
+	static Vector Xor(Vector a, Vector b) {
+		return _mm256_xor_si256(a, b);
+	}
+	static Vector And(Vector a, Vector b) {
+		return _mm256_and_si256(a, b);
+	}
+	static Vector AndNot(Vector a, Vector b) {
+		return _mm256_andnot_si256(a, b);
+	}
+	template <int Count>
+	static Vector Rotr(Vector a) {
+		return _mm256_or_si256(
+			_mm256_srli_epi64(a, Count),
+			_mm256_slli_epi64(a, 64 - Count));
+	}
+	template <int Count>
+	static Vector Shr(Vector a) {
+		return _mm256_srli_epi64(a, Count);
+	}
+	static Vector Gather(const uint64_t *words) {
+		return _mm256_set_epi64x(
+			int64_t(words[3 * kSha512StateWords]),
+			int64_t(words[2 * kSha512StateWords]),
+			int64_t(words[kSha512StateWords]),
+			int64_t(words[0]));
+	}
+	static void Scatter(uint64_t *words, Vector value) {
+		alignas(32) uint64_t lanes[kLanes];
+		_mm256_store_si256(reinterpret_cast<__m256i*>(lanes), value);
+		for (auto i = 0; i != kLanes; ++i) {
+			words[i * kSha512StateWords] = lanes[i];
+		}
+	}
+};
+
+} // namespace
+
+void Pbkdf2IterateAvx2(
+		const uint64_t *inner,
+		const uint64_t *outer,
+		const uint64_t *first,
+		uint64_t *result,
+		int count) {
+	Pbkdf2IterateLanes<Avx2Ops>(inner, outer, first, result, count);
+}
+
+} // namespace Keygen::Crypto::details
+
+#endif // KEYGEN_CRYPTO_X86_64
@@ -0,0 +1,77 @@
+// This file is part of TON Key Generator,
+// a desktop application for the TON Blockchain project.
+//
+// For license and copyright information please follow this link:
+// https://github.com/ton-blockchain/tonkeygen/blob/master/LEGAL
+//
+#include "keygen/crypto/pbkdf2_sha512_lanes.h"
+
+#ifdef KEYGEN_CRYPTO_X86_64
+
+#include <immintrin.h>
+
+namespace Keygen::Crypto::details {
+namespace {
+
+struct Avx512Ops {
+	using Vector = __m512i;
+	static constexpr auto kLanes = kAvx512Lanes;
+
+	static Vector Set(uint64_t value) {
+		return _mm512_set1_epi64(int64_t(value));
+	}
+	static Vector Add(Vector a, Vector b) {
+		return _mm512_add_epi64(a, b);
+	}
+	static Vector Xor(Vector a, Vector b) {
+		return _mm512_xor_si512(a, b);
+	}
+	static Vector And(Vector a, Vector b) {
+		return _mm512_and_si512(a, b);
+	}
+	static Vector AndNot(Vector a, Vector b) {
+		return _mm512_andnot_si512(a, b);
+	}
+	template <int Count>
+	static Vector Rotr(Vector a) {
+		return _mm512_ror_epi64(a, Count);
+	}
+	template <int Count>
+	static Vector Shr(Vector a) {
+		return _mm512_srli_epi64(a, Count);
+	}
+	static Vector Gather(const uint64_t *words) {
+		const auto indices = _mm512_set_epi64(
+			7 * kSha512StateWords,
+			6 * kSha512StateWords,
+			5 * kSha512StateWords,
+			4 * kSha512StateWords,
+			3 * kSha512StateWords,
+			2 * kSha512StateWords,
+			kSha512StateWords,
+			0);
+		return _mm512_i64gather_epi64(indices, words, sizeof(uint64_t));
+	}
+	static void Scatter(uint64_t *words, Vector value) {
+		alignas(64) uint64_t lanes[kLanes];
+		_mm512_store_si512(lanes, value);
+		for (auto i = 0; i != kLanes; ++i) {
+			words[i * kSha512StateWords] = lanes[i];
+		}
+	}
+};
+
+} // namespace
+
+void Pbkdf2IterateAvx512(
+		const uint64_t *inner,
+		const uint64_t *outer,
+		const uint64_t *first,
+		uint64_t *result,
+		int count) {
+	Pbkdf2IterateLanes<Avx512Ops>(inner, outer, first, result, count);
+}
+
+} // namespace Keygen::Crypto::details
+
+#endif // KEYGEN_CRYPTO_X86_64
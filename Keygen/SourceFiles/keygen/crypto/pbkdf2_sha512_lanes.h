@@ -0,0 +1,203 @@
+// This file is part of TON Key Generator,
+// a desktop application for the TON Blockchain project.
+//
+// For license and copyright information please follow this link:
+// https://github.com/ton-blockchain/tonkeygen/blob/master/LEGAL
+//
+#pragma once
+
+// Included by translation units built with different instruction sets,
+// so it must not depend on the precompiled header.
+#include "keygen/crypto/cpu_features.h"
+
+#include <cstdint>
+
+namespace Keygen::Crypto::details {
+
+inline constexpr auto kSha512StateWords = 8;
+inline constexpr auto kSha512BlockWords = 16;
+inline constexpr auto kSha512Rounds = 80;
+
+inline constexpr uint64_t kSha512Constants[kSha512Rounds] = {
+	0x428a2f98d728ae22ULL, 0x7137449123ef65cdULL, 0xb5c0fbcfec4d3b2fULL,
+	0xe9b5dba58189dbbcULL, 0x3956c25bf348b538ULL, 0x59f111f1b605d019ULL,
+	0x923f82a4af194f9bULL, 0xab1c5ed5da6d8118ULL, 0xd807aa98a3030242ULL,
+	0x12835b0145706fbeULL, 0x243185be4ee4b28cULL, 0x550c7dc3d5ffb4e2ULL,
+	0x72be5d74f27b896fULL, 0x80deb1fe3b1696b1ULL, 0x9bdc06a725c71235ULL,
+	0xc19bf174cf692694ULL, 0xe49b69c19ef14ad2ULL, 0xefbe4786384f25e3ULL,
+	0x0fc19dc68b8cd5b5ULL, 0x240ca1cc77ac9c65ULL, 0x2de92c6f592b0275ULL,
+	0x4a7484aa6ea6e483ULL, 0x5cb0a9dcbd41fbd4ULL, 0x76f988da831153b5ULL,
+	0x983e5152ee66dfabULL, 0xa831c66d2db43210ULL, 0xb00327c898fb213fULL,
+	0xbf597fc7beef0ee4ULL, 0xc6e00bf33da88fc2ULL, 0xd5a79147930aa725ULL,
+	0x06ca6351e003826fULL, 0x142929670a0e6e70ULL, 0x27b70a8546d22ffcULL,
+	0x2e1b21385c26c926ULL, 0x4d2c6dfc5ac42aedULL, 0x53380d139d95b3dfULL,
+	0x650a73548baf63deULL, 0x766a0abb3c77b2a8ULL, 0x81c2c92e47edaee6ULL,
+	0x92722c851482353bULL, 0xa2bfe8a14cf10364ULL, 0xa81a664bbc423001ULL,
+	0xc24b8b70d0f89791ULL, 0xc76c51a30654be30ULL, 0xd192e819d6ef5218ULL,
+	0xd69906245565a910ULL, 0xf40e35855771202aULL, 0x106aa07032bbd1b8ULL,
+	0x19a4c116b8d2d0c8ULL, 0x1e376c085141ab53ULL, 0x2748774cdf8eeb99ULL,
+	0x34b0bcb5e19b48a8ULL, 0x391c0cb3c5c95a63ULL, 0x4ed8aa4ae3418acbULL,
+	0x5b9cca4f7763e373ULL, 0x682e6ff3d6b2b8a3ULL, 0x748f82ee5defb2fcULL,
+	0x78a5636f43172f60ULL, 0x84c87814a1f0ab72ULL, 0x8cc702081a6439ecULL,
+	0x90befffa23631e28ULL, 0xa4506cebde82bde9ULL, 0xbef9a3f7b2c67915ULL,
+	0xc67178f2e372532bULL, 0xca273eceea26619cULL, 0xd186b8c721c0c207ULL,
+	0xeada7dd6cde0eb1eULL, 0xf57d4f7fee6ed178ULL, 0x06f067aa72176fbaULL,
+	0x0a637dc5a2c898a6ULL, 0x113f9804bef90daeULL, 0x1b710b35131c471bULL,
+	0x28db77f523047d84ULL, 0x32caab7b40c72493ULL, 0x3c9ebe0a15c9bebcULL,
+	0x431d67c49c100d4cULL, 0x4cc5d4becb3e42b6ULL, 0x597f299cfc657e2aULL,
+	0x5fcb6fab3ad6faecULL, 0x6c44198c4a475817ULL,
+};
+
+// Runs PBKDF2 iterations 2..count for several independent HMAC keys.
+// Each argument holds kSha512StateWords words per lane, lane by lane:
+// the HMAC inner and outer states after the padded key block, U1, and
+// the resulting U1 ^ U2 ^ ... ^ Ucount.
+using Pbkdf2Iterate = void(*)(
+	const uint64_t *inner,
+	const uint64_t *outer,
+	const uint64_t *first,
+	uint64_t *result,
+	int count);
+
+void Pbkdf2IterateScalar(
+	const uint64_t *inner,
+	const uint64_t *outer,
+	const uint64_t *first,
+	uint64_t *result,
+	int count);
+
+#ifdef KEYGEN_CRYPTO_X86_64
+inline constexpr auto kAvx2Lanes = 4;
+inline constexpr auto kAvx512Lanes = 8;
+
+void Pbkdf2IterateAvx2(
+	const uint64_t *inner,
+	const uint64_t *outer,
+	const uint64_t *first,
+	uint64_t *result,
+	int count);
+
+void Pbkdf2IterateAvx512(
+	const uint64_t *inner,
+	const uint64_t *outer,
+	const uint64_t *first,
+	uint64_t *result,
+	int count);
+#endif // KEYGEN_CRYPTO_X86_64
+
+// Ops provide the lane-wise 64 bit arithmetic of one instruction set.
+template <typename Ops>
+inline void Sha512Compress(
+		typename Ops::Vector *state,
+		typename Ops::Vector *w) {
+	using Vector = typename Ops::Vector;
+
+	for (auto i = kSha512BlockWords; i != kSha512Rounds; ++i) {
+		const auto s0 = Ops::Xor(
+			Ops::Xor(
+				Ops::template Rotr<1>(w[i - 15]),
+				Ops::template Rotr<8>(w[i - 15])),
+			Ops::template Shr<7>(w[i - 15]));
+		const auto s1 = Ops::Xor(
+			Ops::Xor(
+				Ops::template Rotr<19>(w[i - 2]),
+				Ops::template Rotr<61>(w[i - 2])),
+			Ops::template Shr<6>(w[i - 2]));
+		w[i] = Ops::Add(Ops::Add(w[i - 16], s0), Ops::Add(w[i - 7], s1));
+	}
+
+	Vector a = state[0], b = state[1], c = state[2], d = state[3];
+	Vector e = state[4], f = state[5], g = state[6], h = state[7];
+	for (auto i = 0; i != kSha512Rounds; ++i) {
+		const auto S1 = Ops::Xor(
+			Ops::Xor(
+				Ops::template Rotr<14>(e),
+				Ops::template Rotr<18>(e)),
+			Ops::template Rotr<41>(e));
+		const auto ch = Ops::Xor(Ops::And(e, f), Ops::AndNot(e, g));
+		const auto t1 = Ops::Add(
+			Ops::Add(h, S1),
+			Ops::Add(
+				Ops::Add(ch, Ops::Set(kSha512Constants[i])),
+				w[i]));
+		const auto S0 = Ops::Xor(
+			Ops::Xor(
+				Ops::template Rotr<28>(a),
+				Ops::template Rotr<34>(a)),
+			Ops::template Rotr<39>(a));
+		const auto maj = Ops::Xor(
+			Ops::Xor(Ops::And(a, b), Ops::And(a, c)),
+			Ops::And(b, c));
+		const auto t2 = Ops::Add(S0, maj);
+		h = g;
+		g = f;
+		f = e;
+		e = Ops::Add(d, t1);
+		d = c;
+		c = b;
+		b = a;
+		a = Ops::Add(t1, t2);
+	}
+	state[0] = Ops::Add(state[0], a);
+	state[1] = Ops::Add(state[1], b);
+	state[2] = Ops::Add(state[2], c);
+	state[3] = Ops::Add(state[3], d);
+	state[4] = Ops::Add(state[4], e);
+	state[5] = Ops::Add(state[5], f);
+	state[6] = Ops::Add(state[6], g);
+	state[7] = Ops::Add(state[7], h);
+}
+
+template <typename Ops>
+inline void Pbkdf2IterateLanes(
+		const uint64_t *inner,
+		const uint64_t *outer,
+		const uint64_t *first,
+		uint64_t *result,
+		int count) {
+	using Vector = typename Ops::Vector;
+
+	// The message of every HMAC compression is one 64 byte hash,
+	// padded to a block, after the 128 byte key block.
+	constexpr auto kPaddingBit = 0x8000000000000000ULL;
+	constexpr auto kMessageBits = uint64_t(128 + 64) * 8;
+
+	Vector innerState[kSha512StateWords];
+	Vector outerState[kSha512StateWords];
+	Vector current[kSha512StateWords];
+	Vector sum[kSha512StateWords];
+	for (auto i = 0; i != kSha512StateWords; ++i) {
+		innerState[i] = Ops::Gather(inner + i);
+		outerState[i] = Ops::Gather(outer + i);
+		current[i] = sum[i] = Ops::Gather(first + i);
+	}
+
+	Vector w[kSha512Rounds];
+	w[kSha512StateWords] = Ops::Set(kPaddingBit);
+	for (auto i = kSha512StateWords + 1; i + 1 < kSha512BlockWords; ++i) {
+		w[i] = Ops::Set(0);
+	}
+	w[kSha512BlockWords - 1] = Ops::Set(kMessageBits);
+
+	Vector state[kSha512StateWords];
+	for (auto iteration = 1; iteration < count; ++iteration) {
+		for (auto i = 0; i != kSha512StateWords; ++i) {
+			w[i] = current[i];
+			state[i] = innerState[i];
+		}
+		Sha512Compress<Ops>(state, w);
+		for (auto i = 0; i != kSha512StateWords; ++i) {
+			w[i] = state[i];
+			current[i] = outerState[i];
+		}
+		Sha512Compress<Ops>(current, w);
+		for (auto i = 0; i != kSha512StateWords; ++i) {
+			sum[i] = Ops::Xor(sum[i], current[i]);
+		}
+	}
+	for (auto i = 0; i != kSha512StateWords; ++i) {
+		Ops::Scatter(result + i, sum[i]);
+	}
+}
+
+} // namespace Keygen::Crypto::details
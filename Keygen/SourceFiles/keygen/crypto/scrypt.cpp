@@ -0,0 +1,272 @@
+// This file is part of TON Key Generator,
+// a desktop application for the TON Blockchain project.
+//
+// For license and copyright information please follow this link:
+// https://github.com/ton-blockchain/tonkeygen/blob/master/LEGAL
+//
+#include "keygen/crypto/scrypt.h"
+
+#include <openssl/crypto.h>
+#include <openssl/evp.h>
+
+#include <thread>
+
+namespace Keygen::Crypto {
+namespace {
+
+constexpr auto kSalsaWords = 16;
+constexpr auto kCalibrationTime = std::chrono::milliseconds(100);
+
+// A lane of the largest costs takes seconds, so the flag is checked
+// every few thousand mixes of it.
+constexpr auto kCancelCheckMask = uint32(0xFFF);
+
+[[nodiscard]] int WorkersCount() {
+	return std::max(int(std::thread::hardware_concurrency()), 1);
+}
+
+[[nodiscard]] bool Cancelled(const std::atomic<bool> *cancelled) {
+	return cancelled && cancelled->load(std::memory_order_relaxed);
+}
+
+[[nodiscard]] uint32 Rotl(uint32 value, int count) {
+	return (value << count) | (value >> (32 - count));
+}
+
+void QuarterRound(uint32 *x, int a, int b, int c, int d) {
+	x[b] ^= Rotl(x[a] + x[d], 7);
+	x[c] ^= Rotl(x[b] + x[a], 9);
+	x[d] ^= Rotl(x[c] + x[b], 13);
+	x[a] ^= Rotl(x[d] + x[c], 18);
+}
+
+void Salsa208(uint32 *block) {
+	uint32 x[kSalsaWords];
+	std::copy_n(block, kSalsaWords, x);
+	for (auto round = 0; round != 8; round += 2) {
+		QuarterRound(x, 0, 4, 8, 12);
+		QuarterRound(x, 5, 9, 13, 1);
+		QuarterRound(x, 10, 14, 2, 6);
+		QuarterRound(x, 15, 3, 7, 11);
+		QuarterRound(x, 0, 1, 2, 3);
+		QuarterRound(x, 5, 6, 7, 4);
+		QuarterRound(x, 10, 11, 8, 9);
+		QuarterRound(x, 15, 12, 13, 14);
+	}
+	for (auto i = 0; i != kSalsaWords; ++i) {
+		block[i] += x[i];
+	}
+}
+
+// The even Salsa outputs go to the first half, the odd to the second.
+void BlockMix(const uint32 *from, uint32 *to, int r) {
+	uint32 x[kSalsaWords];
+	std::copy_n(from + (2 * r - 1) * kSalsaWords, kSalsaWords, x);
+	for (auto i = 0; i != 2 * r; ++i) {
+		for (auto k = 0; k != kSalsaWords; ++k) {
+			x[k] ^= from[i * kSalsaWords + k];
+		}
+		Salsa208(x);
+		const auto index = (i / 2) + ((i & 1) ? r : 0);
+		std::copy_n(x, kSalsaWords, to + index * kSalsaWords);
+	}
+}
+
+// One lane of 128 * r bytes, the table has 32 * r * N words. Returns
+// false if cancelled, the lane is left half mixed then.
+[[nodiscard]] bool RoMix(
+		uchar *lane,
+		const ScryptParams &params,
+		uint32 *table,
+		const std::atomic<bool> *cancelled) {
+	const auto words = 32 * params.r;
+	const auto count = uint32(1) << params.logN;
+	auto buffer = std::vector<uint32>(2 * words);
+	auto x = buffer.data();
+	auto y = x + words;
+	for (auto k = 0; k != words; ++k) {
+		const auto bytes = lane + 4 * k;
+		x[k] = uint32(bytes[0])
+			| (uint32(bytes[1]) << 8)
+			| (uint32(bytes[2]) << 16)
+			| (uint32(bytes[3]) << 24);
+	}
+	const auto stopped = [&](uint32 i) {
+		return !(i & kCancelCheckMask) && Cancelled(cancelled);
+	};
+	for (auto i = uint32(0); i != count; ++i) {
+		if (stopped(i)) {
+			OPENSSL_cleanse(buffer.data(), buffer.size() * sizeof(uint32));
+			return false;
+		}
+		std::copy_n(x, words, table + size_t(i) * words);
+		BlockMix(x, y, params.r);
+		std::swap(x, y);
+	}
+	const auto last = (2 * params.r - 1) * kSalsaWords;
+	for (auto i = uint32(0); i != count; ++i) {
+		if (stopped(i)) {
+			OPENSSL_cleanse(buffer.data(), buffer.size() * sizeof(uint32));
+			return false;
+		}
+		const auto row = table + size_t(x[last] & (count - 1)) * words;
+		for (auto k = 0; k != words; ++k) {
+			x[k] ^= row[k];
+		}
+		BlockMix(x, y, params.r);
+		std::swap(x, y);
+	}
+	for (auto k = 0; k != words; ++k) {
+		for (auto byte = 0; byte != 4; ++byte) {
+			lane[4 * k + byte] = uchar(x[k] >> (8 * byte));
+		}
+	}
+	OPENSSL_cleanse(buffer.data(), buffer.size() * sizeof(uint32));
+	return true;
+}
+
+void Pbkdf2Sha256(
+		const QByteArray &password,
+		const uchar *salt,
+		int saltSize,
+		uchar *result,
+		int size) {
+	const auto done = PKCS5_PBKDF2_HMAC(
+		password.constData(),
+		password.size(),
+		salt,
+		saltSize,
+		1,
+		EVP_sha256(),
+		size,
+		result);
+	Assert(done == 1);
+}
+
+} // namespace
+
+int64 ScryptParams::laneMemory() const {
+	return (int64(128) * r) << logN;
+}
+
+std::optional<std::vector<ScryptKey>> ScryptMany(
+		gsl::span<const ScryptInput> inputs,
+		const ScryptParams &params,
+		int64 memoryBudget,
+		const std::atomic<bool> *cancelled) {
+	Expects(params.logN > 0 && params.logN <= kScryptLogNMax);
+	Expects(params.r > 0 && params.p > 0);
+
+	const auto laneSize = 128 * params.r;
+	const auto inputSize = laneSize * params.p;
+	const auto lanes = int(inputs.size()) * params.p;
+	auto blocks = std::vector<uchar>(size_t(inputSize) * inputs.size());
+	for (auto i = 0; i != int(inputs.size()); ++i) {
+		const auto &salt = inputs[i].salt;
+		Pbkdf2Sha256(
+			inputs[i].password,
+			reinterpret_cast<const uchar*>(salt.constData()),
+			salt.size(),
+			blocks.data() + size_t(i) * inputSize,
+			inputSize);
+	}
+
+	// Every worker allocates one table and mixes lanes in it until none
+	// are left, so the memory does not grow with the inputs count.
+	const auto fitting = memoryBudget / params.laneMemory();
+	const auto workers = int(std::clamp(
+		fitting,
+		int64(1),
+		int64(std::max(std::min(WorkersCount(), lanes), 1))));
+	auto next = std::atomic<int>(0);
+	const auto loop = [&] {
+		const auto words = size_t(32 * params.r) << params.logN;
+		auto table = std::vector<uint32>(words);
+		while (!Cancelled(cancelled)) {
+			const auto lane = next.fetch_add(1);
+			if (lane >= lanes) {
+				break;
+			}
+			const auto block = blocks.data() + size_t(lane) * laneSize;
+			if (!RoMix(block, params, table.data(), cancelled)) {
+				break;
+			}
+		}
+		OPENSSL_cleanse(table.data(), table.size() * sizeof(uint32));
+	};
+	auto threads = std::vector<std::thread>();
+	threads.reserve(workers - 1);
+	for (auto i = 1; i < workers; ++i) {
+		threads.emplace_back(loop);
+	}
+	loop();
+	for (auto &thread : threads) {
+		thread.join();
+	}
+	if (Cancelled(cancelled)) {
+		OPENSSL_cleanse(blocks.data(), blocks.size());
+		return std::nullopt;
+	}
+
+	auto result = std::vector<ScryptKey>(inputs.size());
+	for (auto i = 0; i != int(inputs.size()); ++i) {
+		Pbkdf2Sha256(
+			inputs[i].password,
+			blocks.data() + size_t(i) * inputSize,
+			inputSize,
+			result[i].data(),
+			kScryptKeySize);
+	}
+	OPENSSL_cleanse(blocks.data(), blocks.size());
+	return result;
+}
+
+std::optional<ScryptParams> CalibrateScrypt(
+		std::chrono::milliseconds target,
+		int64 memoryBudget,
+		const std::atomic<bool> *cancelled) {
+	using Clock = std::chrono::steady_clock;
+
+	auto result = ScryptParams();
+	result.p = std::clamp(WorkersCount(), 1, kScryptLanesMax);
+	auto largest = result;
+	while (largest.logN < kScryptLogNMax) {
+		++largest.logN;
+		if (largest.laneMemory() * result.p > memoryBudget) {
+			--largest.logN;
+			break;
+		}
+	}
+
+	// The time grows linearly with N, so the cheapest costs are measured
+	// and scaled up while they fit the target.
+	const auto input = ScryptInput{
+		QByteArray("calibration"),
+		QByteArray("calibration salt"),
+	};
+	const auto started = Clock::now();
+	auto elapsed = Clock::duration();
+	auto runs = 0;
+	do {
+		const auto keys = ScryptMany(
+			gsl::make_span(&input, 1),
+			result,
+			memoryBudget,
+			cancelled);
+		if (!keys) {
+			return std::nullopt;
+		}
+		elapsed = Clock::now() - started;
+		++runs;
+	} while (elapsed < kCalibrationTime);
+
+	auto time = std::chrono::duration<double>(elapsed).count() / runs;
+	const auto limit = std::chrono::duration<double>(target).count();
+	while (result.logN < largest.logN && time * 2. <= limit) {
+		time *= 2.;
+		++result.logN;
+	}
+	return result;
+}
+
+} // namespace Keygen::Crypto
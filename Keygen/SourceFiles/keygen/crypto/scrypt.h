@@ -0,0 +1,56 @@
+// This file is part of TON Key Generator,
+// a desktop application for the TON Blockchain project.
+//
+// For license and copyright information please follow this link:
+// https://github.com/ton-blockchain/tonkeygen/blob/master/LEGAL
+//
+#pragma once
+
+#include <atomic>
+#include <chrono>
+
+namespace Keygen::Crypto {
+
+inline constexpr auto kScryptKeySize = 32;
+inline constexpr auto kScryptLogNMin = 14;
+inline constexpr auto kScryptLogNMax = 24;
+inline constexpr auto kScryptLanesMax = 8;
+
+using ScryptKey = std::array<uchar, kScryptKeySize>;
+
+// The scrypt costs of RFC 7914, with N = 2^logN. Each of the p lanes
+// mixes its own 128 * r * N byte table, independently of the others.
+struct ScryptParams {
+	int logN = kScryptLogNMin;
+	int r = 8;
+	int p = 1;
+
+	[[nodiscard]] int64 laneMemory() const;
+};
+
+struct ScryptInput {
+	QByteArray password;
+	QByteArray salt;
+};
+
+// Derives the keys of all the inputs with the same costs. The lanes of
+// all the inputs are spread over the cores, but never more of them run
+// at once than the memory budget takes, one lane table per core.
+// Returns nothing only if cancelled is set meanwhile.
+[[nodiscard]] std::optional<std::vector<ScryptKey>> ScryptMany(
+	gsl::span<const ScryptInput> inputs,
+	const ScryptParams &params,
+	int64 memoryBudget,
+	const std::atomic<bool> *cancelled = nullptr);
+
+// Measures this machine and picks the costs of one derivation taking
+// about the target time with all the lanes running at once within the
+// memory budget. The lanes count follows the cores count, so unlocking
+// on a machine with fewer cores takes longer.
+// Returns nothing only if cancelled is set meanwhile.
+[[nodiscard]] std::optional<ScryptParams> CalibrateScrypt(
+	std::chrono::milliseconds target,
+	int64 memoryBudget,
+	const std::atomic<bool> *cancelled = nullptr);
+
+} // namespace Keygen::Crypto
@@ -0,0 +1,108 @@
+// This file is part of TON Key Generator,
+// a desktop application for the TON Blockchain project.
+//
+// For license and copyright information please follow this link:
+// https://github.com/ton-blockchain/tonkeygen/blob/master/LEGAL
+//
+#include "keygen/crypto/shamir.h"
+
+#include "keygen/crypto/gf256.h"
+
+#include <openssl/crypto.h>
+#include <openssl/rand.h>
+
+namespace Keygen::Crypto {
+
+std::vector<std::vector<ShamirShare>> SplitSecrets(
+		gsl::span<const ShamirSecret> secrets,
+		int threshold,
+		int count) {
+	Expects(threshold > 0 && threshold <= count);
+	Expects(count <= kShamirSharesMax);
+
+	const auto size = int(secrets.size()) * kShamirSecretSize;
+	const auto source = gsl::make_span(
+		reinterpret_cast<const uchar*>(secrets.data()),
+		size);
+
+	// Coefficient k of all the polynomials is kept in region k - 1.
+	auto coefficients = std::vector<uchar>(size * (threshold - 1));
+	if (!coefficients.empty()) {
+		const auto generated = RAND_bytes(
+			coefficients.data(),
+			int(coefficients.size()));
+		Assert(generated == 1);
+	}
+	const auto region = [&](int power) {
+		return gsl::make_span(
+			coefficients.data() + (power - 1) * size,
+			size);
+	};
+
+	auto result = std::vector<std::vector<ShamirShare>>(
+		secrets.size(),
+		std::vector<ShamirShare>(count));
+	auto values = std::vector<uchar>(size);
+	for (auto share = 0; share != count; ++share) {
+		const auto point = uchar(share + 1);
+		std::copy(begin(source), end(source), begin(values));
+		auto factor = uchar(1);
+		for (auto power = 1; power != threshold; ++power) {
+			factor = Gf256Multiply(factor, point);
+			Gf256MultiplyAdd(values, region(power), factor);
+		}
+		for (auto i = 0; i != int(secrets.size()); ++i) {
+			auto &entry = result[i][share];
+			entry.index = point;
+			std::copy_n(
+				values.data() + i * kShamirSecretSize,
+				kShamirSecretSize,
+				entry.value.data());
+		}
+	}
+	OPENSSL_cleanse(coefficients.data(), coefficients.size());
+	OPENSSL_cleanse(values.data(), values.size());
+	return result;
+}
+
+std::optional<ShamirSecret> CombineShares(
+		gsl::span<const ShamirShare> shares) {
+	const auto count = int(shares.size());
+	if (!count) {
+		return std::nullopt;
+	}
+	for (auto i = 0; i != count; ++i) {
+		const auto index = shares[i].index;
+		if (!index) {
+			return std::nullopt;
+		}
+		for (auto j = 0; j != i; ++j) {
+			if (shares[j].index == index) {
+				return std::nullopt;
+			}
+		}
+	}
+	auto result = ShamirSecret();
+	result.fill(0);
+	for (auto i = 0; i != count; ++i) {
+		// The Lagrange basis polynomial of the point i taken at zero,
+		// subtraction in GF(2^8) is the same xor as addition.
+		auto numerator = uchar(1);
+		auto denominator = uchar(1);
+		for (auto j = 0; j != count; ++j) {
+			if (j != i) {
+				numerator = Gf256Multiply(numerator, shares[j].index);
+				denominator = Gf256Multiply(
+					denominator,
+					uchar(shares[j].index ^ shares[i].index));
+			}
+		}
+		Gf256MultiplyAdd(
+			result,
+			shares[i].value,
+			Gf256Multiply(numerator, Gf256Inverse(denominator)));
+	}
+	return result;
+}
+
+} // namespace Keygen::Crypto
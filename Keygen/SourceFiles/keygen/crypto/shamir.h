@@ -0,0 +1,39 @@
+// This file is part of TON Key Generator,
+// a desktop application for the TON Blockchain project.
+//
+// For license and copyright information please follow this link:
+// https://github.com/ton-blockchain/tonkeygen/blob/master/LEGAL
+//
+#pragma once
+
+namespace Keygen::Crypto {
+
+// Packed 11 bit indices of the mnemonic words.
+inline constexpr auto kShamirSecretSize = 33;
+inline constexpr auto kShamirSharesMax = 255;
+
+using ShamirSecret = std::array<uchar, kShamirSecretSize>;
+
+struct ShamirShare {
+	uchar index = 0; // The point the polynomial is taken at, never zero.
+	ShamirSecret value = { { 0 } };
+};
+
+// Byte-wise Shamir secret sharing over GF(2^8). Each secret gets its own
+// random polynomial of degree threshold - 1, the shares are its values
+// at points 1..count. All the secrets are evaluated together, so every
+// multiply-add of the kernel runs over the whole batch.
+//
+// Returns the count shares of each secret, in the secrets order.
+[[nodiscard]] std::vector<std::vector<ShamirShare>> SplitSecrets(
+	gsl::span<const ShamirSecret> secrets,
+	int threshold,
+	int count);
+
+// Interpolates the polynomial through all the shares at zero, so they
+// should be exactly threshold shares of one secret. Returns nothing if
+// there are no shares or some points repeat or are zero.
+[[nodiscard]] std::optional<ShamirSecret> CombineShares(
+	gsl::span<const ShamirShare> shares);
+
+} // namespace Keygen::Crypto
@@ -0,0 +1,168 @@
+// This file is part of TON Key Generator,
+// a desktop application for the TON Blockchain project.
+//
+// For license and copyright information please follow this link:
+// https://github.com/ton-blockchain/tonkeygen/blob/master/LEGAL
+//
+#include "keygen/crypto/wallet_address.h"
+
+#include <openssl/sha.h>
+
+namespace Keygen::Crypto {
+namespace {
+
+constexpr auto kBounceableTag = uchar(0x11);
+constexpr auto kNonBounceableTag = uchar(0x51);
+constexpr auto kSerializedAddressSize = 36;
+
+using Hash = std::array<uchar, SHA256_DIGEST_LENGTH>;
+
+struct WalletCode {
+	Hash hash;
+	uint16 depth = 0;
+};
+
+// Representation hashes of the single cell wallet codes tonlib deploys.
+constexpr auto kWalletV3R1Code = WalletCode{ { {
+	0xb6, 0x10, 0x41, 0xa5, 0x8a, 0x79, 0x80, 0xb9,
+	0x46, 0xe8, 0xfb, 0x9e, 0x19, 0x8e, 0x3c, 0x90,
+	0x4d, 0x24, 0x79, 0x9f, 0xfa, 0x36, 0x57, 0x4e,
+	0xa4, 0x25, 0x1c, 0x41, 0xa5, 0x66, 0xf5, 0x81,
+} }, 0 };
+constexpr auto kWalletV3R2Code = WalletCode{ { {
+	0x84, 0xda, 0xfa, 0x44, 0x9f, 0x98, 0xa6, 0x98,
+	0x77, 0x89, 0xba, 0x23, 0x23, 0x58, 0x07, 0x2b,
+	0xc0, 0xf7, 0x6d, 0xc4, 0x52, 0x40, 0x02, 0xa5,
+	0xd0, 0x91, 0x8b, 0x9a, 0x75, 0xd2, 0xd5, 0x99,
+} }, 0 };
+
+[[nodiscard]] const WalletCode &Code(WalletVersion version) {
+	switch (version) {
+	case WalletVersion::V3R1: return kWalletV3R1Code;
+	case WalletVersion::V3R2: return kWalletV3R2Code;
+	}
+	Unexpected("Version in Code.");
+}
+
+void AppendUint16(uchar *&to, uint16 value) {
+	*to++ = uchar(value >> 8);
+	*to++ = uchar(value & 0xFF);
+}
+
+void AppendUint32(uchar *&to, uint32 value) {
+	AppendUint16(to, uint16(value >> 16));
+	AppendUint16(to, uint16(value & 0xFFFF));
+}
+
+void AppendBytes(uchar *&to, const uchar *from, int size) {
+	to = std::copy(from, from + size, to);
+}
+
+// Cell of seqno:uint32, subwallet_id:uint32 and public_key:bits256.
+[[nodiscard]] Hash DataCellHash(const PublicKey &key, uint32 walletId) {
+	constexpr auto kBits = 32 + 32 + 256;
+	auto buffer = std::array<uchar, 2 + kBits / 8>();
+	auto to = buffer.data();
+	*to++ = 0; // No references, ordinary cell.
+	*to++ = uchar(2 * kBits / 8);
+	AppendUint32(to, 0);
+	AppendUint32(to, walletId);
+	AppendBytes(to, key.data(), key.size());
+	Assert(to == buffer.data() + buffer.size());
+
+	auto result = Hash();
+	SHA256(buffer.data(), buffer.size(), result.data());
+	return result;
+}
+
+// StateInit with only the code and data references set.
+[[nodiscard]] Hash StateInitHash(const WalletCode &code, const Hash &data) {
+	constexpr auto kDataDepth = uint16(0);
+	auto buffer = std::array<uchar, 3 + 2 * 2 + 2 * sizeof(Hash)>();
+	auto to = buffer.data();
+	*to++ = 2; // Two references, ordinary cell.
+	*to++ = 1; // Five bits: split_depth, special, code, data, library.
+	*to++ = 0x34; // 00110 and the completion tag.
+	AppendUint16(to, code.depth);
+	AppendUint16(to, kDataDepth);
+	AppendBytes(to, code.hash.data(), code.hash.size());
+	AppendBytes(to, data.data(), data.size());
+	Assert(to == buffer.data() + buffer.size());
+
+	auto result = Hash();
+	SHA256(buffer.data(), buffer.size(), result.data());
+	return result;
+}
+
+} // namespace
+
+WalletAddress ComputeWalletAddress(
+		const PublicKey &key,
+		WalletVersion version,
+		int workchain) {
+	const auto walletId = uint32(kDefaultWalletId + workchain);
+	auto result = WalletAddress();
+	result.version = version;
+	result.workchain = workchain;
+	result.hash = StateInitHash(Code(version), DataCellHash(key, walletId));
+	return result;
+}
+
+std::vector<WalletAddress> ComputeWalletAddresses(const PublicKey &key) {
+	auto result = std::vector<WalletAddress>();
+	result.reserve(kWalletWorkchains.size() * kWalletVersions.size());
+	for (const auto workchain : kWalletWorkchains) {
+		// The data cell depends on the workchain through the wallet id.
+		const auto data = DataCellHash(
+			key,
+			uint32(kDefaultWalletId + workchain));
+		for (const auto version : kWalletVersions) {
+			auto address = WalletAddress();
+			address.version = version;
+			address.workchain = workchain;
+			address.hash = StateInitHash(Code(version), data);
+			result.push_back(address);
+		}
+	}
+	return result;
+}
+
+QByteArray SerializeAddress(const WalletAddress &address, bool bounceable) {
+	auto buffer = std::array<uchar, kSerializedAddressSize>();
+	buffer[0] = bounceable ? kBounceableTag : kNonBounceableTag;
+	buffer[1] = uchar(address.workchain & 0xFF);
+	std::copy(begin(address.hash), end(address.hash), buffer.data() + 2);
+	const auto crc = Crc16(buffer.data(), 34);
+	buffer[34] = uchar(crc >> 8);
+	buffer[35] = uchar(crc & 0xFF);
+	return QByteArray(
+		reinterpret_cast<const char*>(buffer.data()),
+		buffer.size()
+	).toBase64(QByteArray::Base64UrlEncoding);
+}
+
+double AddressPatternChance(const QByteArray &pattern, int workchain) {
+	const auto fixed = std::array<uchar, 2>{ {
+		kNonBounceableTag,
+		uchar(workchain & 0xFF),
+	} };
+	return Base64PatternChance(pattern, fixed, kSerializedAddressSize);
+}
+
+QByteArray SerializeRawAddress(const WalletAddress &address) {
+	return QByteArray::number(address.workchain)
+		+ ':'
+		+ QByteArray(
+			reinterpret_cast<const char*>(address.hash.data()),
+			address.hash.size()).toHex();
+}
+
+QString WalletVersionName(WalletVersion version) {
+	switch (version) {
+	case WalletVersion::V3R1: return "v3R1";
+	case WalletVersion::V3R2: return "v3R2";
+	}
+	Unexpected("Version in WalletVersionName.");
+}
+
+} // namespace Keygen::Crypto
@@ -0,0 +1,68 @@
+// This file is part of TON Key Generator,
+// a desktop application for the TON Blockchain project.
+//
+// For license and copyright information please follow this link:
+// https://github.com/ton-blockchain/tonkeygen/blob/master/LEGAL
+//
+#pragma once
+
+#include "keygen/crypto/mnemonic.h"
+
+namespace Keygen::Crypto {
+
+enum class WalletVersion {
+	V3R1,
+	V3R2,
+};
+
+inline constexpr auto kBasechain = 0;
+inline constexpr auto kMasterchain = -1;
+
+// Subwallet id tonlib gives the first wallet of a key, plus workchain.
+inline constexpr auto kDefaultWalletId = 698983191;
+
+// The standard addresses of a key, all the versions in each workchain.
+inline constexpr auto kWalletVersions = std::array<WalletVersion, 2>{ {
+	WalletVersion::V3R2,
+	WalletVersion::V3R1,
+} };
+inline constexpr auto kWalletWorkchains = std::array<int, 2>{ {
+	kBasechain,
+	kMasterchain,
+} };
+
+struct WalletAddress {
+	WalletVersion version = WalletVersion::V3R2;
+	int workchain = kBasechain;
+	std::array<uchar, 32> hash = { { 0 } };
+};
+
+// The StateInit hash of the wallet with the default subwallet id. The
+// code cell hashes are constants, so only the data cell and StateInit
+// cells are hashed for each address.
+[[nodiscard]] WalletAddress ComputeWalletAddress(
+	const PublicKey &key,
+	WalletVersion version,
+	int workchain);
+[[nodiscard]] std::vector<WalletAddress> ComputeWalletAddresses(
+	const PublicKey &key);
+
+// User-friendly base64url form. The wallets are not deployed yet, so
+// they are non-bounceable by default: bounceable transfers would bounce.
+[[nodiscard]] QByteArray SerializeAddress(
+	const WalletAddress &address,
+	bool bounceable = false);
+
+// Chance for the non-bounceable form of a random key's address in the
+// workchain to start with the pattern. Zero if no address can, the
+// first characters encode the fixed tag and workchain.
+[[nodiscard]] double AddressPatternChance(
+	const QByteArray &pattern,
+	int workchain = kBasechain);
+
+// "workchain:hex" form.
+[[nodiscard]] QByteArray SerializeRawAddress(const WalletAddress &address);
+
+[[nodiscard]] QString WalletVersionName(WalletVersion version);
+
+} // namespace Keygen::Crypto
@@ -0,0 +1,152 @@
+// This file is part of TON Key Generator,
+// a desktop application for the TON Blockchain project.
+//
+// For license and copyright information please follow this link:
+// https://github.com/ton-blockchain/tonkeygen/blob/master/LEGAL
+//
+#include "keygen/derivation_cache.h"
+
+#include <openssl/crypto.h>
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+#include <openssl/rand.h>
+
+namespace Keygen {
+namespace {
+
+constexpr auto kMaxEntries = 16;
+
+// Entries never share their buffers, so that wiping one wipes the only
+// copy and never touches a key that is still in use elsewhere.
+[[nodiscard]] Ton::Result<QByteArray> DeepCopy(
+		const Ton::Result<QByteArray> &result) {
+	if (!result) {
+		return result;
+	}
+	const auto &value = *result;
+	return QByteArray(value.constData(), value.size());
+}
+
+} // namespace
+
+DerivationCache::DerivationCache() {
+	generateSessionKey();
+}
+
+DerivationCache::~DerivationCache() {
+	wipeEntries();
+	OPENSSL_cleanse(_sessionKey.data(), _sessionKey.size());
+}
+
+auto DerivationCache::find(
+	const std::vector<QByteArray> &words,
+	const QByteArray &password)
+-> std::optional<Ton::Result<QByteArray>> {
+	const auto key = digest(words, password);
+	const auto i = ranges::find(_entries, key, &Entry::digest);
+	if (i == end(_entries)) {
+		return std::nullopt;
+	}
+	i->used = ++_usedCounter;
+	return DeepCopy(i->result);
+}
+
+void DerivationCache::remember(
+		const std::vector<QByteArray> &words,
+		const QByteArray &password,
+		const Ton::Result<QByteArray> &result) {
+	const auto key = digest(words, password);
+	const auto i = ranges::find(_entries, key, &Entry::digest);
+	if (i != end(_entries)) {
+		wipe(*i);
+		i->digest = key;
+		i->result = DeepCopy(result);
+		i->used = ++_usedCounter;
+		return;
+	} else if (_entries.size() == kMaxEntries) {
+		// Replace the least recently used entry.
+		auto &oldest = *std::min_element(
+			begin(_entries),
+			end(_entries),
+			[](const Entry &a, const Entry &b) { return a.used < b.used; });
+		wipe(oldest);
+		oldest = Entry{ key, DeepCopy(result), ++_usedCounter };
+		return;
+	}
+	_entries.push_back(Entry{ key, DeepCopy(result), ++_usedCounter });
+}
+
+void DerivationCache::clear() {
+	wipeEntries();
+	generateSessionKey();
+}
+
+void DerivationCache::wipeEntries() {
+	for (auto &entry : _entries) {
+		wipe(entry);
+	}
+	_entries.clear();
+	_usedCounter = 0;
+}
+
+auto DerivationCache::digest(
+	const std::vector<QByteArray> &words,
+	const QByteArray &password) const
+-> Digest {
+	const auto context = HMAC_CTX_new();
+	Assert(context != nullptr);
+
+	HMAC_Init_ex(
+		context,
+		_sessionKey.data(),
+		_sessionKey.size(),
+		EVP_sha256(),
+		nullptr);
+	const auto addSize = [&](int value) {
+		const auto size = uint32(value);
+		const auto bytes = std::array<uchar, 4>{ {
+			uchar(size >> 24),
+			uchar(size >> 16),
+			uchar(size >> 8),
+			uchar(size),
+		} };
+		HMAC_Update(context, bytes.data(), bytes.size());
+	};
+	const auto add = [&](const QByteArray &part) {
+		// Prefix each part with its length, so that the split is unique.
+		addSize(part.size());
+		HMAC_Update(
+			context,
+			reinterpret_cast<const uchar*>(part.constData()),
+			part.size());
+	};
+	addSize(words.size());
+	for (const auto &word : words) {
+		add(word);
+	}
+	add(password);
+	auto result = Digest();
+	auto size = uint32(result.size());
+	HMAC_Final(context, result.data(), &size);
+	HMAC_CTX_free(context);
+
+	Ensures(size == result.size());
+	return result;
+}
+
+void DerivationCache::generateSessionKey() {
+	const auto generated = RAND_bytes(_sessionKey.data(), _sessionKey.size());
+	Assert(generated == 1);
+}
+
+void DerivationCache::wipe(Entry &entry) {
+	OPENSSL_cleanse(entry.digest.data(), entry.digest.size());
+	if (entry.result) {
+		// Not data(), it would detach and wipe a copy if it was shared.
+		const auto &key = *entry.result;
+		OPENSSL_cleanse(const_cast<char*>(key.constData()), key.size());
+	}
+	entry.result = QByteArray();
+}
+
+} // namespace Keygen
@@ -0,0 +1,62 @@
+// This file is part of TON Key Generator,
+// a desktop application for the TON Blockchain project.
+//
+// For license and copyright information please follow this link:
+// https://github.com/ton-blockchain/tonkeygen/blob/master/LEGAL
+//
+#pragma once
+
+#include "ton/ton_utility.h"
+
+namespace Keygen {
+
+// Remembers which public key a mnemonic derives to. Entries are found by
+// an HMAC of the words under a random session key, the words themselves
+// are never stored.
+class DerivationCache final {
+public:
+	DerivationCache();
+	DerivationCache(const DerivationCache &other) = delete;
+	DerivationCache &operator=(const DerivationCache &other) = delete;
+	~DerivationCache();
+
+	// The same words give different results with different passwords,
+	// so the password is a part of the digest as well.
+	[[nodiscard]] auto find(
+		const std::vector<QByteArray> &words,
+		const QByteArray &password = QByteArray())
+	-> std::optional<Ton::Result<QByteArray>>;
+
+	// Accepts a public key or an error that the words themselves caused.
+	void remember(
+		const std::vector<QByteArray> &words,
+		const QByteArray &password,
+		const Ton::Result<QByteArray> &result);
+
+	// Wipes all the entries and starts a new session key.
+	void clear();
+
+private:
+	static constexpr auto kDigestSize = 32;
+	using Digest = std::array<uchar, kDigestSize>;
+
+	struct Entry {
+		Digest digest = { { 0 } };
+		Ton::Result<QByteArray> result;
+		uint64 used = 0;
+	};
+
+	[[nodiscard]] Digest digest(
+		const std::vector<QByteArray> &words,
+		const QByteArray &password) const;
+	void generateSessionKey();
+	void wipeEntries();
+	void wipe(Entry &entry);
+
+	std::array<uchar, kDigestSize> _sessionKey = { { 0 } };
+	std::vector<Entry> _entries;
+	uint64 _usedCounter = 0;
+
+};
+
+} // namespace Keygen
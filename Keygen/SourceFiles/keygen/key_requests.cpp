@@ -0,0 +1,452 @@
+// This file is part of TON Key Generator,
+// a desktop application for the TON Blockchain project.
+//
+// For license and copyright information please follow this link:
+// https://github.com/ton-blockchain/tonkeygen/blob/master/LEGAL
+//
+#include "keygen/key_requests.h"
+
+#include "keygen/crypto/mnemonic.h"
+#include "keygen/keystore.h"
+
+namespace Keygen {
+namespace {
+
+[[nodiscard]] Ton::Result<QByteArray> WrapChecked(
+		const Crypto::CheckedKey &checked) {
+	using Error = Crypto::MnemonicError;
+	switch (checked.error) {
+	case Error::None: return checked.publicKey;
+	case Error::InvalidMnemonic:
+		return Ton::Error{ Ton::Error::Type::TonLib, "INVALID_MNEMONIC" };
+	case Error::NeedPassword:
+		return Ton::Error{
+			Ton::Error::Type::TonLib,
+			"NEED_MNEMONIC_PASSWORD"
+		};
+	}
+	Unexpected("Error in WrapChecked.");
+}
+
+[[nodiscard]] Ton::Result<Ton::UtilityKey> WrapCombined(
+		const Crypto::CombinedKey &combined) {
+	using Error = Crypto::SharesError;
+	const auto error = [](const QString &details) {
+		return Ton::Error{ Ton::Error::Type::TonLib, details };
+	};
+	switch (combined.error) {
+	case Error::None: {
+		auto key = Ton::UtilityKey();
+		key.words = combined.words;
+		key.publicKey = combined.publicKey;
+		return key;
+	}
+	case Error::InvalidShares: return error("INVALID_SHARES");
+	case Error::NotEnoughShares: return error("NOT_ENOUGH_SHARES");
+	case Error::NeedPassword: return error("NEED_MNEMONIC_PASSWORD");
+	case Error::KeyMismatch: return error("SHARES_KEY_MISMATCH");
+	}
+	Unexpected("Error in WrapCombined.");
+}
+
+[[nodiscard]] Ton::Error SharesUnsupported() {
+	return Ton::Error{
+		Ton::Error::Type::TonLib,
+		"MNEMONIC_SHARES_UNSUPPORTED"
+	};
+}
+
+[[nodiscard]] Ton::Error PasswordUnsupported() {
+	return Ton::Error{
+		Ton::Error::Type::TonLib,
+		"MNEMONIC_PASSWORD_UNSUPPORTED"
+	};
+}
+
+} // namespace
+
+KeyRequests::KeyRequests(
+	std::shared_ptr<const Crypto::MnemonicEngine> engine)
+: _engine(std::move(engine)) {
+}
+
+void KeyRequests::create(
+		const QByteArray &seed,
+		const QByteArray &password,
+		Fn<void(Ton::Result<Ton::UtilityKey>)> done) {
+	if (_engine) {
+		createWithEngine(seed, password, nullptr, nullptr, std::move(done));
+		return;
+	}
+	const auto generation = start(Channel::Create);
+	const auto finished = [=](Ton::Result<Ton::UtilityKey> result) {
+		if (finish(Channel::Create, generation)) {
+			done(std::move(result));
+		}
+	};
+	if (!password.isEmpty()) {
+		finished(PasswordUnsupported());
+	} else {
+		Ton::CreateKey(seed, finished);
+	}
+}
+
+void KeyRequests::createMatching(
+		const QByteArray &seed,
+		const QByteArray &password,
+		Crypto::KeyMatcher matches,
+		Fn<void(int64)> progress,
+		Fn<void(Ton::Result<Ton::UtilityKey>)> done) {
+	Expects(matches != nullptr);
+
+	if (!_engine) {
+		const auto generation = start(Channel::Create);
+		if (finish(Channel::Create, generation)) {
+			done(Ton::Error{
+				Ton::Error::Type::TonLib,
+				"MNEMONIC_VANITY_UNSUPPORTED"
+			});
+		}
+		return;
+	}
+	createWithEngine(
+		seed,
+		password,
+		std::move(matches),
+		std::move(progress),
+		std::move(done));
+}
+
+void KeyRequests::createWithEngine(
+		const QByteArray &seed,
+		const QByteArray &password,
+		Crypto::KeyMatcher matches,
+		Fn<void(int64)> progress,
+		Fn<void(Ton::Result<Ton::UtilityKey>)> done) {
+	Expects(_engine != nullptr);
+
+	const auto channel = Channel::Create;
+	stopSearch(channel);
+	const auto generation = start(channel);
+	const auto finished = [=](Ton::Result<Ton::UtilityKey> result) {
+		if (finish(channel, generation)) {
+			done(std::move(result));
+		}
+	};
+	const auto cancelled = startSearch(channel);
+	const auto guard = base::make_weak(this);
+	const auto reported = std::make_shared<std::atomic<crl::time>>(0);
+	const auto report = [=](int64 keys) {
+		// Workers report concurrently, only the first one after the delay
+		// passes the count to the main thread.
+		const auto now = crl::now();
+		auto was = reported->load();
+		do {
+			if (now - was < kProgressDelay) {
+				return;
+			}
+		} while (!reported->compare_exchange_weak(was, now));
+		crl::on_main(guard, [=] {
+			if (state(channel).generation == generation) {
+				progress(keys);
+			}
+		});
+	};
+	crl::async([=, engine = _engine] {
+		auto created = matches
+			? engine->createMatching(
+				seed,
+				password,
+				matches,
+				progress ? Fn<void(int64)>(report) : nullptr,
+				cancelled.get())
+			: engine->create(seed, password, cancelled.get());
+		if (!created) {
+			return;
+		}
+		crl::on_main(guard, [=, created = std::move(*created)] {
+			_stats.countCreated(created);
+
+			auto key = Ton::UtilityKey();
+			key.words = created.words;
+			key.publicKey = created.publicKey;
+			finished(std::move(key));
+		});
+	});
+}
+
+void KeyRequests::check(
+		Channel channel,
+		const std::vector<QByteArray> &words,
+		const QByteArray &password,
+		Fn<void(Ton::Result<QByteArray>)> done) {
+	Expects(channel != Channel::Create);
+
+	const auto generation = start(channel);
+	const auto finished = [=](Ton::Result<QByteArray> result) {
+		if (finish(channel, generation)) {
+			done(std::move(result));
+		}
+	};
+	if (!_engine) {
+		if (!password.isEmpty()) {
+			finished(PasswordUnsupported());
+		} else {
+			Ton::CheckKey(words, finished);
+		}
+		return;
+	}
+	crl::async([=, engine = _engine, guard = base::make_weak(this)] {
+		const auto checked = engine->check(words, password);
+		crl::on_main(guard, [=] {
+			finished(WrapChecked(checked));
+		});
+	});
+}
+
+Ton::Result<Crypto::KeyShares> KeyRequests::split(
+		const Ton::UtilityKey &key,
+		int threshold,
+		int count) const {
+	if (!_engine) {
+		return SharesUnsupported();
+	}
+	auto result = _engine->split(
+		{ key.words },
+		{ key.publicKey },
+		threshold,
+		count);
+	return std::move(result.front());
+}
+
+void KeyRequests::combine(
+		Crypto::KeyShares shares,
+		const QByteArray &password,
+		Fn<void(Ton::Result<Ton::UtilityKey>)> done) {
+	const auto channel = Channel::Check;
+	const auto generation = start(channel);
+	const auto finished = [=](Ton::Result<Ton::UtilityKey> result) {
+		if (finish(channel, generation)) {
+			done(std::move(result));
+		}
+	};
+	if (!_engine) {
+		finished(SharesUnsupported());
+		return;
+	}
+	const auto guard = base::make_weak(this);
+	crl::async([=, engine = _engine, shares = std::move(shares)] {
+		const auto combined = engine->combine(shares, password);
+		crl::on_main(guard, [=] {
+			finished(WrapCombined(combined));
+		});
+	});
+}
+
+void KeyRequests::exportKeystore(
+		const Ton::UtilityKey &key,
+		bool needsPassword,
+		const QByteArray &passphrase,
+		Fn<void(QByteArray)> done) {
+	const auto channel = Channel::Export;
+	stopSearch(channel);
+	const auto generation = start(channel);
+	const auto finished = [=](QByteArray result) {
+		if (finish(channel, generation)) {
+			done(std::move(result));
+		}
+	};
+	auto entries = std::vector<KeystoreEntry>{
+		{ key.words, key.publicKey, needsPassword },
+	};
+	const auto cancelled = startSearch(channel);
+	const auto guard = base::make_weak(this);
+	crl::async([=, entries = std::move(entries)] {
+		const auto params = Crypto::CalibrateScrypt(
+			kKeystoreUnlockTime,
+			kKeystoreMemoryBudget,
+			cancelled.get());
+		if (!params) {
+			return;
+		}
+		auto keystores = ExportKeystores(
+			entries,
+			passphrase,
+			*params,
+			cancelled.get());
+		if (!keystores) {
+			return;
+		}
+		crl::on_main(guard, [=, result = std::move(keystores->front())] {
+			finished(result);
+		});
+	});
+}
+
+void KeyRequests::recover(
+		Crypto::RecoveryRequest request,
+		Fn<void(int, int)> progress,
+		Fn<void(Ton::Result<std::vector<Crypto::RecoveredKey>>)> done) {
+	using Recovered = std::vector<Crypto::RecoveredKey>;
+
+	const auto channel = Channel::Recover;
+	stopSearch(channel);
+	const auto generation = start(channel);
+	const auto finished = [=](Ton::Result<Recovered> result) {
+		if (finish(channel, generation)) {
+			done(std::move(result));
+		}
+	};
+	if (!_engine) {
+		finished(Ton::Error{
+			Ton::Error::Type::TonLib,
+			"MNEMONIC_RECOVERY_UNSUPPORTED"
+		});
+		return;
+	}
+	const auto cancelled = startSearch(channel);
+	const auto guard = base::make_weak(this);
+	const auto reported = std::make_shared<std::atomic<int>>(-1);
+	const auto report = [=](int now, int total) {
+		// Workers report concurrently, only the first to reach a new
+		// percent passes it to the main thread.
+		const auto percent = int(int64(now) * 100 / std::max(total, 1));
+		auto was = reported->load();
+		do {
+			if (percent <= was) {
+				return;
+			}
+		} while (!reported->compare_exchange_weak(was, percent));
+		crl::on_main(guard, [=] {
+			if (state(channel).generation == generation) {
+				progress(now, total);
+			}
+		});
+	};
+	crl::async([=, engine = _engine, request = std::move(request)] {
+		auto recovered = engine->recover(request, report, cancelled.get());
+		if (!recovered) {
+			return;
+		}
+		crl::on_main(guard, [=, list = std::move(*recovered)] {
+			finished(list);
+		});
+	});
+}
+
+void KeyRequests::cancel(Channel channel) {
+	stopSearch(channel);
+	auto &current = state(channel);
+	if (current.running) {
+		current.running = false;
+		++current.generation;
+		++_stats.cancelled;
+	}
+}
+
+void KeyRequests::cancelAll() {
+	cancel(Channel::Create);
+	cancel(Channel::Check);
+	cancel(Channel::Speculate);
+	cancel(Channel::Recover);
+	cancel(Channel::Export);
+}
+
+bool KeyRequests::running(Channel channel) const {
+	return _channels[static_cast<int>(channel)].running;
+}
+
+KeyRequests::Stats KeyRequests::stats() const {
+	return _stats;
+}
+
+auto KeyRequests::startSearch(Channel channel)
+-> std::shared_ptr<std::atomic<bool>> {
+	auto &current = state(channel);
+	current.stop = std::make_shared<std::atomic<bool>>(false);
+	return current.stop;
+}
+
+void KeyRequests::stopSearch(Channel channel) {
+	// Unlike tonlib requests the in-process searches stop right away.
+	if (const auto stop = base::take(state(channel).stop)) {
+		*stop = true;
+	}
+}
+
+void KeyRequests::Stats::countCreated(const Crypto::CreatedKey &created) {
+	auto left = created.attempts;
+	auto bucket = 0;
+	while (left > 1 && bucket + 1 < kAttemptsBuckets) {
+		left >>= 1;
+		++bucket;
+	}
+	++attempts[bucket];
+	random += created.drbg;
+}
+
+KeyRequests::State &KeyRequests::state(Channel channel) {
+	const auto index = static_cast<int>(channel);
+
+	Expects(index >= 0 && index < kChannelsCount);
+
+	return _channels[index];
+}
+
+uint64 KeyRequests::start(Channel channel) {
+	auto &current = state(channel);
+	if (current.running) {
+		++_stats.superseded;
+	}
+	current.running = true;
+	++_stats.started;
+	return ++current.generation;
+}
+
+bool KeyRequests::finish(Channel channel, uint64 generation) {
+	auto &current = state(channel);
+	if (current.generation != generation) {
+		// Superseded or cancelled, tonlib could not be stopped in time.
+		++_stats.dropped;
+		return false;
+	}
+	current.running = false;
+	++_stats.finished;
+	return true;
+}
+
+QString DescribeStats(const KeyRequests::Stats &stats) {
+	auto result = QString(
+		"Key requests: %1 started, %2 finished, %3 superseded, "
+		"%4 cancelled, %5 dropped."
+	).arg(stats.started
+	).arg(stats.finished
+	).arg(stats.superseded
+	).arg(stats.cancelled
+	).arg(stats.dropped);
+
+	// Only the buckets that got any keys, as "2^from-2^till: count".
+	auto buckets = QStringList();
+	const auto last = KeyRequests::kAttemptsBuckets - 1;
+	for (auto i = 0; i != KeyRequests::kAttemptsBuckets; ++i) {
+		if (const auto count = stats.attempts[i]) {
+			buckets.push_back((i == last)
+				? QString("2^%1+: %2").arg(i).arg(count)
+				: QString("2^%1-2^%2: %3").arg(i).arg(i + 1).arg(count));
+		}
+	}
+	if (!buckets.isEmpty()) {
+		result.append("\nCandidates per created key: ");
+		result.append(buckets.join(", ")).append('.');
+	}
+	if (const auto &random = stats.random; random.draws > 0) {
+		result.append(QString(
+			"\nWorker generators: %1 draws, %2 bytes, %3 reseeds."
+		).arg(random.draws
+		).arg(random.bytes
+		).arg(random.reseeds));
+	}
+	return result;
+}
+
+} // namespace Keygen
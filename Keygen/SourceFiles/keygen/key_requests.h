@@ -0,0 +1,138 @@
+// This file is part of TON Key Generator,
+// a desktop application for the TON Blockchain project.
+//
+// For license and copyright information please follow this link:
+// https://github.com/ton-blockchain/tonkeygen/blob/master/LEGAL
+//
+#pragma once
+
+#include "keygen/crypto/mnemonic.h"
+#include "ton/ton_utility.h"
+
+namespace Keygen {
+
+// Keeps at most one tonlib key request alive in each channel. Starting a
+// new request supersedes the previous one and a cancelled or superseded
+// request never calls back, even when tonlib finishes it later.
+//
+// With an engine the keys are derived in-process on a worker thread,
+// otherwise the requests go through the tonlib client.
+class KeyRequests final : public base::has_weak_ptr {
+public:
+	enum class Channel {
+		Create,
+		Check,
+		Speculate,
+		Recover,
+		Export,
+	};
+	static constexpr auto kAttemptsBuckets = 16;
+	static constexpr auto kProgressDelay = crl::time(250);
+	struct Stats {
+		int64 started = 0;
+		int64 finished = 0;
+		int64 superseded = 0;
+		int64 cancelled = 0;
+		int64 dropped = 0;
+
+		// Keys created after [2^i, 2^(i+1)) candidates, the last bucket
+		// takes everything above.
+		std::array<int64, kAttemptsBuckets> attempts = { { 0 } };
+
+		// Totals of the per-worker generators used for created keys.
+		Crypto::DrbgCounters random;
+
+		// Adds the candidates and the generators of a created key.
+		void countCreated(const Crypto::CreatedKey &created);
+	};
+
+	explicit KeyRequests(
+		std::shared_ptr<const Crypto::MnemonicEngine> engine = nullptr);
+
+	// A non-empty password is supported only by the in-process engine,
+	// the tonlib utility requests do not take one.
+	void create(
+		const QByteArray &seed,
+		const QByteArray &password,
+		Fn<void(Ton::Result<Ton::UtilityKey>)> done);
+	// Needs the engine, progress gets the count of keys derived so far
+	// at most once in kProgressDelay.
+	void createMatching(
+		const QByteArray &seed,
+		const QByteArray &password,
+		Crypto::KeyMatcher matches,
+		Fn<void(int64)> progress,
+		Fn<void(Ton::Result<Ton::UtilityKey>)> done);
+	void check(
+		Channel channel,
+		const std::vector<QByteArray> &words,
+		const QByteArray &password,
+		Fn<void(Ton::Result<QByteArray>)> done);
+
+	// Needs the engine. Splitting takes no key derivation, so it is done
+	// right away on the calling thread.
+	[[nodiscard]] Ton::Result<Crypto::KeyShares> split(
+		const Ton::UtilityKey &key,
+		int threshold,
+		int count) const;
+	// Needs the engine, goes through the Check channel.
+	void combine(
+		Crypto::KeyShares shares,
+		const QByteArray &password,
+		Fn<void(Ton::Result<Ton::UtilityKey>)> done);
+
+	// Calibrates the key derivation to this machine and encrypts the
+	// words with the passphrase on a background thread. Cancelling the
+	// channel stops the derivation right away.
+	void exportKeystore(
+		const Ton::UtilityKey &key,
+		bool needsPassword,
+		const QByteArray &passphrase,
+		Fn<void(QByteArray)> done);
+
+	// Needs the engine, progress gets (done, total) once per percent.
+	void recover(
+		Crypto::RecoveryRequest request,
+		Fn<void(int, int)> progress,
+		Fn<void(Ton::Result<std::vector<Crypto::RecoveredKey>>)> done);
+
+	void cancel(Channel channel);
+	void cancelAll();
+
+	[[nodiscard]] bool running(Channel channel) const;
+	[[nodiscard]] Stats stats() const;
+
+private:
+	static constexpr auto kChannelsCount = 5;
+
+	struct State {
+		uint64 generation = 0;
+		bool running = false;
+
+		// Set to stop the in-process search running in the channel.
+		std::shared_ptr<std::atomic<bool>> stop;
+	};
+
+	[[nodiscard]] State &state(Channel channel);
+	[[nodiscard]] uint64 start(Channel channel);
+	[[nodiscard]] bool finish(Channel channel, uint64 generation);
+	[[nodiscard]] std::shared_ptr<std::atomic<bool>> startSearch(
+		Channel channel);
+	void stopSearch(Channel channel);
+	void createWithEngine(
+		const QByteArray &seed,
+		const QByteArray &password,
+		Crypto::KeyMatcher matches,
+		Fn<void(int64)> progress,
+		Fn<void(Ton::Result<Ton::UtilityKey>)> done);
+
+	const std::shared_ptr<const Crypto::MnemonicEngine> _engine;
+	std::array<State, kChannelsCount> _channels;
+	Stats _stats;
+
+};
+
+// One line for each kind of the counters, for the console modes.
+[[nodiscard]] QString DescribeStats(const KeyRequests::Stats &stats);
+
+} // namespace Keygen
@@ -0,0 +1,469 @@
+// This file is part of TON Key Generator,
+// a desktop application for the TON Blockchain project.
+//
+// For license and copyright information please follow this link:
+// https://github.com/ton-blockchain/tonkeygen/blob/master/LEGAL
+//
+#include "keygen/keystore.h"
+
+#include "keygen/crypto/mnemonic.h"
+#include "keygen/word_index.h"
+#include "ton/ton_wallet.h"
+
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QSaveFile>
+#include <QtCore/QTextStream>
+
+#include <openssl/crypto.h>
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+
+namespace Keygen {
+namespace {
+
+constexpr auto kVersion = 1;
+constexpr auto kSaltSize = 32;
+constexpr auto kIvSize = 12;
+constexpr auto kTagSize = 16;
+
+struct Sealed {
+	QByteArray ciphertext;
+	QByteArray iv;
+	QByteArray tag;
+};
+
+struct Parsed {
+	QByteArray publicKey;
+	bool needsPassword = false;
+	Crypto::ScryptParams params;
+	QByteArray salt;
+	Sealed sealed;
+};
+
+[[nodiscard]] QByteArray RandomBytes(int size) {
+	auto result = QByteArray(size, Qt::Uninitialized);
+	Assert(RAND_bytes(
+		reinterpret_cast<uchar*>(result.data()),
+		result.size()) == 1);
+	return result;
+}
+
+[[nodiscard]] Sealed Seal(
+		const Crypto::ScryptKey &key,
+		const QByteArray &plain,
+		const QByteArray &associated) {
+	auto result = Sealed{
+		QByteArray(plain.size(), Qt::Uninitialized),
+		RandomBytes(kIvSize),
+		QByteArray(kTagSize, Qt::Uninitialized),
+	};
+	const auto iv = reinterpret_cast<const uchar*>(result.iv.constData());
+	const auto out = reinterpret_cast<uchar*>(result.ciphertext.data());
+	const auto context = EVP_CIPHER_CTX_new();
+	Assert(context != nullptr);
+
+	// The default GCM nonce size is 12 bytes, no need to set it.
+	auto written = 0;
+	auto finished = 0;
+	Assert(EVP_EncryptInit_ex(
+		context,
+		EVP_aes_256_gcm(),
+		nullptr,
+		key.data(),
+		iv) == 1);
+	Assert(EVP_EncryptUpdate(
+		context,
+		nullptr,
+		&written,
+		reinterpret_cast<const uchar*>(associated.constData()),
+		associated.size()) == 1);
+	Assert(EVP_EncryptUpdate(
+		context,
+		out,
+		&written,
+		reinterpret_cast<const uchar*>(plain.constData()),
+		plain.size()) == 1);
+	Assert(EVP_EncryptFinal_ex(context, out + written, &finished) == 1);
+	Assert(written + finished == plain.size());
+	Assert(EVP_CIPHER_CTX_ctrl(
+		context,
+		EVP_CTRL_GCM_GET_TAG,
+		kTagSize,
+		result.tag.data()) == 1);
+	EVP_CIPHER_CTX_free(context);
+	return result;
+}
+
+[[nodiscard]] std::optional<QByteArray> Open(
+		const Crypto::ScryptKey &key,
+		const Sealed &sealed,
+		const QByteArray &associated) {
+	auto result = QByteArray(sealed.ciphertext.size(), Qt::Uninitialized);
+	auto tag = sealed.tag;
+	const auto iv = reinterpret_cast<const uchar*>(sealed.iv.constData());
+	const auto out = reinterpret_cast<uchar*>(result.data());
+	const auto context = EVP_CIPHER_CTX_new();
+	Assert(context != nullptr);
+
+	auto written = 0;
+	auto finished = 0;
+	Assert(EVP_DecryptInit_ex(
+		context,
+		EVP_aes_256_gcm(),
+		nullptr,
+		key.data(),
+		iv) == 1);
+	Assert(EVP_DecryptUpdate(
+		context,
+		nullptr,
+		&written,
+		reinterpret_cast<const uchar*>(associated.constData()),
+		associated.size()) == 1);
+	Assert(EVP_DecryptUpdate(
+		context,
+		out,
+		&written,
+		reinterpret_cast<const uchar*>(sealed.ciphertext.constData()),
+		sealed.ciphertext.size()) == 1);
+	Assert(EVP_CIPHER_CTX_ctrl(
+		context,
+		EVP_CTRL_GCM_SET_TAG,
+		kTagSize,
+		tag.data()) == 1);
+
+	// Fails if the tag does not authenticate the data.
+	const auto authentic = EVP_DecryptFinal_ex(
+		context,
+		out + written,
+		&finished) == 1;
+	EVP_CIPHER_CTX_free(context);
+	if (!authentic) {
+		OPENSSL_cleanse(result.data(), result.size());
+		return std::nullopt;
+	}
+	Assert(written + finished == result.size());
+	return result;
+}
+
+[[nodiscard]] QByteArray Serialize(
+		const KeystoreEntry &entry,
+		const Crypto::ScryptParams &params,
+		const QByteArray &salt,
+		const Sealed &sealed) {
+	auto kdf = QJsonObject();
+	kdf.insert("name", "scrypt");
+	kdf.insert("n", double(int64(1) << params.logN));
+	kdf.insert("r", params.r);
+	kdf.insert("p", params.p);
+	kdf.insert("salt", QString::fromLatin1(salt.toHex()));
+
+	auto cipher = QJsonObject();
+	cipher.insert("name", "aes-256-gcm");
+	cipher.insert("iv", QString::fromLatin1(sealed.iv.toHex()));
+	cipher.insert("tag", QString::fromLatin1(sealed.tag.toHex()));
+
+	auto object = QJsonObject();
+	object.insert("version", kVersion);
+	object.insert("publicKey", QString::fromLatin1(entry.publicKey));
+	object.insert("needsPassword", entry.needsPassword);
+	object.insert("kdf", kdf);
+	object.insert("cipher", cipher);
+	object.insert(
+		"ciphertext",
+		QString::fromLatin1(sealed.ciphertext.toHex()));
+	return QJsonDocument(object).toJson();
+}
+
+[[nodiscard]] std::optional<QByteArray> ParseHex(
+		const QJsonObject &object,
+		const QString &key) {
+	const auto value = object.value(key).toString().toLatin1();
+	const auto result = QByteArray::fromHex(value);
+
+	// Qt skips bad characters, so only a full round trip means hex.
+	if (value.isEmpty() || result.toHex() != value.toLower()) {
+		return std::nullopt;
+	}
+	return result;
+}
+
+[[nodiscard]] std::optional<Parsed> Parse(const QByteArray &keystore) {
+	const auto document = QJsonDocument::fromJson(keystore);
+	const auto object = document.object();
+	const auto kdf = object.value("kdf").toObject();
+	const auto cipher = object.value("cipher").toObject();
+	if (object.value("version").toInt() != kVersion
+		|| kdf.value("name").toString() != "scrypt"
+		|| cipher.value("name").toString() != "aes-256-gcm") {
+		return std::nullopt;
+	}
+	auto result = Parsed();
+	result.publicKey = object.value("publicKey").toString().toLatin1();
+	result.needsPassword = object.value("needsPassword").toBool();
+
+	auto &params = result.params;
+	const auto n = kdf.value("n").toDouble();
+	params.logN = 1;
+	while (params.logN < Crypto::kScryptLogNMax
+		&& double(int64(1) << params.logN) < n) {
+		++params.logN;
+	}
+	params.r = kdf.value("r").toInt();
+	params.p = kdf.value("p").toInt();
+	if (double(int64(1) << params.logN) != n
+		|| params.r <= 0
+		|| params.p <= 0
+		|| params.p > Crypto::kScryptLanesMax
+		|| params.laneMemory() > kKeystoreMemoryBudget) {
+		return std::nullopt;
+	}
+
+	const auto salt = ParseHex(kdf, "salt");
+	const auto iv = ParseHex(cipher, "iv");
+	const auto tag = ParseHex(cipher, "tag");
+	const auto ciphertext = ParseHex(object, "ciphertext");
+	if (result.publicKey.isEmpty()
+		|| !salt
+		|| !iv
+		|| iv->size() != kIvSize
+		|| !tag
+		|| tag->size() != kTagSize
+		|| !ciphertext) {
+		return std::nullopt;
+	}
+	result.salt = *salt;
+	result.sealed = Sealed{ *ciphertext, *iv, *tag };
+	return result;
+}
+
+[[nodiscard]] std::vector<QByteArray> ParseWords(const QString &line) {
+	const auto parts = line.simplified().toLower().split(
+		' ',
+		QString::SkipEmptyParts);
+	return ranges::view::all(
+		parts
+	) | ranges::view::transform([](const QString &word) {
+		return word.toUtf8();
+	}) | ranges::to_vector;
+}
+
+} // namespace
+
+std::optional<std::vector<QByteArray>> ExportKeystores(
+		const std::vector<KeystoreEntry> &entries,
+		const QByteArray &passphrase,
+		const Crypto::ScryptParams &params,
+		const std::atomic<bool> *cancelled) {
+	Expects(!passphrase.isEmpty());
+
+	const auto inputs = ranges::view::all(
+		entries
+	) | ranges::view::transform([&](const KeystoreEntry &) {
+		return Crypto::ScryptInput{ passphrase, RandomBytes(kSaltSize) };
+	}) | ranges::to_vector;
+	auto derived = Crypto::ScryptMany(
+		inputs,
+		params,
+		kKeystoreMemoryBudget,
+		cancelled);
+	if (!derived) {
+		return std::nullopt;
+	}
+	auto &keys = *derived;
+
+	auto result = std::vector<QByteArray>();
+	result.reserve(entries.size());
+	for (auto i = 0; i != int(entries.size()); ++i) {
+		const auto &entry = entries[i];
+		auto plain = Crypto::JoinWords(entry.words);
+		const auto sealed = Seal(keys[i], plain, entry.publicKey);
+		OPENSSL_cleanse(plain.data(), plain.size());
+		OPENSSL_cleanse(keys[i].data(), keys[i].size());
+		result.push_back(Serialize(entry, params, inputs[i].salt, sealed));
+	}
+	return result;
+}
+
+ImportedKeystore ImportKeystore(
+		const QByteArray &keystore,
+		const QByteArray &passphrase) {
+	auto result = ImportedKeystore();
+	const auto parsed = Parse(keystore);
+	if (!parsed) {
+		result.error = KeystoreError::Invalid;
+		return result;
+	}
+	const auto input = Crypto::ScryptInput{ passphrase, parsed->salt };
+	auto keys = Crypto::ScryptMany(
+		gsl::make_span(&input, 1),
+		parsed->params,
+		kKeystoreMemoryBudget);
+	Assert(keys.has_value());
+
+	auto &key = keys->front();
+	auto plain = Open(key, parsed->sealed, parsed->publicKey);
+	OPENSSL_cleanse(key.data(), key.size());
+	if (!plain) {
+		result.error = KeystoreError::WrongPassphrase;
+		return result;
+	}
+	const auto words = plain->split(' ');
+	result.entry.words = std::vector<QByteArray>(words.begin(), words.end());
+	result.entry.publicKey = parsed->publicKey;
+	result.entry.needsPassword = parsed->needsPassword;
+	OPENSSL_cleanse(plain->data(), plain->size());
+	return result;
+}
+
+int RunExport(const ExportOptions &options) {
+	auto out = QTextStream(stdout);
+	auto err = QTextStream(stderr);
+	const auto fail = [&](const QString &text) {
+		err << text << "\n";
+		return 2;
+	};
+
+	auto file = QFile(options.wordsPath);
+	if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+		return fail("Could not read the words.");
+	}
+	const auto folder = QDir(options.outputPath);
+	if (options.outputPath.isEmpty() || !folder.exists()) {
+		return fail("The output folder does not exist.");
+	}
+	auto lines = std::vector<int>();
+	auto batch = std::vector<std::vector<QByteArray>>();
+	auto input = QTextStream(&file);
+	for (auto line = 1; !input.atEnd(); ++line) {
+		auto words = ParseWords(input.readLine());
+		if (!words.empty()) {
+			lines.push_back(line);
+			batch.push_back(std::move(words));
+		}
+	}
+	if (batch.empty()) {
+		return fail("There are no words in the file.");
+	}
+
+	err << "Passphrase: ";
+	err.flush();
+	const auto passphrase = QTextStream(stdin).readLine().toUtf8();
+	if (passphrase.isEmpty()) {
+		return fail("The passphrase is empty.");
+	}
+
+	const auto index = WordIndex(Ton::Wallet::GetValidWords());
+	const auto engine = Crypto::MnemonicEngine(index.list());
+	const auto checked = engine.check(batch);
+	auto entries = std::vector<KeystoreEntry>();
+	auto skipped = 0;
+	for (auto i = 0; i != int(batch.size()); ++i) {
+		using Error = Crypto::MnemonicError;
+		switch (checked[i].error) {
+		case Error::None:
+			entries.push_back({ std::move(batch[i]), checked[i].publicKey });
+			continue;
+		case Error::NeedPassword:
+			// The public key is unknown without the mnemonic password.
+			err << "Line " << lines[i] << ": needs a mnemonic password.\n";
+			break;
+		default:
+			err << "Line " << lines[i] << ": invalid words.\n";
+			break;
+		}
+		++skipped;
+	}
+	if (entries.empty()) {
+		return fail("No word lists to export.");
+	}
+
+	const auto params = *Crypto::CalibrateScrypt(
+		kKeystoreUnlockTime,
+		kKeystoreMemoryBudget);
+	err
+		<< "Deriving " << entries.size()
+		<< " keys with scrypt N=2^" << params.logN
+		<< ", r=" << params.r
+		<< ", p=" << params.p
+		<< ".\n";
+	err.flush();
+
+	const auto keystores = *ExportKeystores(entries, passphrase, params);
+	for (auto &entry : entries) {
+		for (auto &word : entry.words) {
+			OPENSSL_cleanse(word.data(), word.size());
+		}
+	}
+	auto written = 0;
+	for (auto i = 0; i != int(entries.size()); ++i) {
+		const auto name = QString::fromLatin1(entries[i].publicKey);
+		const auto path = folder.filePath(name + ".json");
+		auto result = QSaveFile(path);
+		if (!result.open(QIODevice::WriteOnly)
+			|| result.write(keystores[i]) != keystores[i].size()
+			|| !result.commit()) {
+			err << "Could not write " << path << ".\n";
+			++skipped;
+			continue;
+		}
+		out << path << "\n";
+		++written;
+	}
+	out.flush();
+	err << "Exported " << written << " of " << batch.size() << ".\n";
+	return skipped ? 1 : 0;
+}
+
+int RunVerify(const QString &keystorePath) {
+	auto out = QTextStream(stdout);
+	auto err = QTextStream(stderr);
+	const auto fail = [&](const QString &text) {
+		err << text << "\n";
+		return 2;
+	};
+
+	auto file = QFile(keystorePath);
+	if (!file.open(QIODevice::ReadOnly)) {
+		return fail("Could not read the keystore.");
+	}
+	const auto keystore = file.readAll();
+
+	err << "Passphrase: ";
+	err.flush();
+	const auto passphrase = QTextStream(stdin).readLine().toUtf8();
+
+	auto imported = ImportKeystore(keystore, passphrase);
+	switch (imported.error) {
+	case KeystoreError::None: break;
+	case KeystoreError::Invalid: return fail("The keystore is invalid.");
+	case KeystoreError::WrongPassphrase:
+		return fail("Wrong passphrase or a changed keystore.");
+	}
+	auto &entry = imported.entry;
+	const auto index = WordIndex(Ton::Wallet::GetValidWords());
+	const auto engine = Crypto::MnemonicEngine(index.list());
+	const auto checked = engine.check(entry.words);
+	for (auto &word : entry.words) {
+		OPENSSL_cleanse(word.data(), word.size());
+	}
+
+	using Error = Crypto::MnemonicError;
+	if (checked.error == Error::NeedPassword && entry.needsPassword) {
+		// The public key is unknown without the mnemonic password.
+		err << "The words need a mnemonic password to check the key.\n";
+		out << entry.publicKey << "\n";
+		return 0;
+	} else if (checked.error != Error::None) {
+		return fail("The keystore has invalid words.");
+	} else if (checked.publicKey != entry.publicKey) {
+		err << "The words give " << checked.publicKey << ".\n";
+		return 1;
+	}
+	out << entry.publicKey << "\n";
+	return 0;
+}
+
+} // namespace Keygen
@@ -0,0 +1,79 @@
+// This file is part of TON Key Generator,
+// a desktop application for the TON Blockchain project.
+//
+// For license and copyright information please follow this link:
+// https://github.com/ton-blockchain/tonkeygen/blob/master/LEGAL
+//
+#pragma once
+
+#include "keygen/crypto/scrypt.h"
+
+namespace Keygen {
+
+inline constexpr auto kKeystoreUnlockTime = std::chrono::milliseconds(1000);
+inline constexpr auto kKeystoreMemoryBudget = int64(1) << 30;
+
+struct KeystoreEntry {
+	std::vector<QByteArray> words;
+	QByteArray publicKey;
+	bool needsPassword = false;
+};
+
+// JSON keystores with the words encrypted by AES-256-GCM under a scrypt
+// key of the passphrase:
+// {
+//   "version": 1,
+//   "publicKey": "...",
+//   "needsPassword": false,
+//   "kdf": { "name": "scrypt", "n": ..., "r": ..., "p": ..., "salt": "" },
+//   "cipher": { "name": "aes-256-gcm", "iv": "...", "tag": "..." },
+//   "ciphertext": "..."
+// }
+// Binary values are in hex. The words are joined by spaces and the
+// public key is authenticated together with them. Each entry gets its
+// own salt and all the keys are derived at once.
+// Returns nothing only if cancelled is set meanwhile.
+[[nodiscard]] std::optional<std::vector<QByteArray>> ExportKeystores(
+	const std::vector<KeystoreEntry> &entries,
+	const QByteArray &passphrase,
+	const Crypto::ScryptParams &params,
+	const std::atomic<bool> *cancelled = nullptr);
+
+enum class KeystoreError {
+	None,
+	Invalid,
+	WrongPassphrase, // Or the file was changed after the export.
+};
+
+struct ImportedKeystore {
+	KeystoreError error = KeystoreError::None;
+	KeystoreEntry entry;
+};
+
+// Decrypts a keystore of ExportKeystores with the costs written in it.
+// Costs taking more than the memory budget make the keystore invalid.
+[[nodiscard]] ImportedKeystore ImportKeystore(
+	const QByteArray &keystore,
+	const QByteArray &passphrase);
+
+struct ExportOptions {
+	// One word list per line.
+	QString wordsPath;
+
+	// An existing folder for the "<public key>.json" files.
+	QString outputPath;
+};
+
+// Headless export of all the word lists of a file with the passphrase
+// from stdin. Written files are printed to stdout, skipped lines and
+// progress to stderr. Returns the process exit code: 0 if all the lists
+// were exported.
+[[nodiscard]] int RunExport(const ExportOptions &options);
+
+// Headless check of a keystore with the passphrase from stdin: the words
+// are decrypted and the public key is derived from them again. Prints
+// the public key to stdout. Returns the process exit code: 0 if the key
+// is the one written in the keystore.
+[[nodiscard]] int RunVerify(const QString &keystorePath);
+
+} // namespace Keygen
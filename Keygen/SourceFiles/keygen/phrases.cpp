@@ -17,7 +17,37 @@ const phrase lng_intro_verify = { "Verify existing key" };
 const phrase lng_intro_verify_title = { "Verify existing key" };
 const phrase lng_intro_verify_text = { "If you have already generated a private key, you can check its validity and get the corresponding public key here." };
 const phrase lng_intro_verify_ok = { "Enter words" };
+const phrase lng_intro_verify_combine = { "Combine shares" };
 const phrase lng_intro_verify_cancel = { "Cancel" };
+const phrase lng_intro_options = { "Advanced options" };
+
+const phrase lng_options_title = { "Advanced options" };
+const phrase lng_options_text = { "Both of these are optional. Searching for a key or address prefix may take a while." };
+const phrase lng_options_password = { "Protect the words with a password" };
+const phrase lng_options_vanity = { "Choose how the public key or wallet address starts" };
+const phrase lng_options_submit = { "Start" };
+const phrase lng_options_cancel = { "Cancel" };
+
+const phrase lng_password_title = { "Protect with a password" };
+const phrase lng_password_description = { "Optionally set a password that will be required together with\nthe secret words. Leave both fields empty to skip this step.\nIf you forget the password, the words will be **useless**." };
+const phrase lng_password_placeholder = { "Password" };
+const phrase lng_password_repeat = { "Repeat password" };
+const phrase lng_password_next = { "Continue" };
+
+const phrase lng_vanity_title = { "Choose how the key or address starts" };
+const phrase lng_vanity_description = { "Optionally enter how your public key or wallet address should start.\nKeys start with **PuY** to **Pub**, addresses with **UQA** to **UQD**.\nEach next character makes the search 64 times longer. Leave empty to skip." };
+const phrase lng_vanity_placeholder = { "Public key start" };
+const phrase lng_vanity_address_placeholder = { "Wallet address start" };
+const phrase lng_vanity_address = { "Match the wallet address instead" };
+const phrase lng_vanity_next = { "Continue" };
+const phrase lng_vanity_progress_title = { "Searching for the key" };
+const phrase lng_vanity_progress_text = { "Checked {keys} keys, {speed} per second.\nA match takes about {time} on average." };
+const phrase lng_vanity_progress_starting = { "Starting the search..." };
+const phrase lng_vanity_time_minute = { "a minute" };
+const phrase lng_vanity_time_minutes = { "{count} minutes" };
+const phrase lng_vanity_time_hours = { "{count} hours" };
+const phrase lng_vanity_time_days = { "{count} days" };
+const phrase lng_vanity_cancel = { "Cancel" };
 
 const phrase lng_random_seed_title = { "Enter random characters" };
 const phrase lng_random_seed_description = { "Press random buttons on your keyboard at least **50 times** to\nimprove the quality of the key generation process." };
@@ -53,6 +83,33 @@ const phrase lng_verify_bad_try_again = { "Try again" };
 const phrase lng_verify_good_title = { "Well done" };
 const phrase lng_verify_good_text = { "The words are correct. Please make\nsure you don't lose this list and never\nshare it with anyone." };
 const phrase lng_verify_good_next = { "View public key" };
+const phrase lng_verify_bad_recover = { "Recover a word" };
+const phrase lng_verify_password_title = { "Password required" };
+const phrase lng_verify_password_text = { "These secret words are protected with a password. Please enter it to check the key." };
+const phrase lng_verify_password_submit = { "Check" };
+const phrase lng_verify_password_cancel = { "Cancel" };
+
+const phrase lng_recovery_title = { "Recover a word" };
+const phrase lng_recovery_text = { "If one of the words is misspelled or unreadable, every other word from the list can be tried in its place.\n\nEnter its number if you know it, and the public key if you have it, to find the right word faster." };
+const phrase lng_recovery_position = { "Word number (optional)" };
+const phrase lng_recovery_public_key = { "Public key (optional)" };
+const phrase lng_recovery_password = { "Password (optional)" };
+const phrase lng_recovery_start = { "Search" };
+const phrase lng_recovery_cancel = { "Cancel" };
+const phrase lng_recovery_progress_title = { "Searching" };
+const phrase lng_recovery_progress_text = { "Checked {percent}% of the possible word lists." };
+const phrase lng_recovery_word = { "Word {index}: **{word}**" };
+const phrase lng_recovery_none_title = { "Nothing found" };
+const phrase lng_recovery_none_text = { "Changing one word does not give a valid key. Please check the other words and try again." };
+const phrase lng_recovery_found_title = { "Word recovered" };
+const phrase lng_recovery_found_text = { "The key is valid with this word:\n\n{word}\n\nPlease correct your backup." };
+const phrase lng_recovery_found_use = { "View public key" };
+const phrase lng_recovery_many_title = { "Several words fit" };
+const phrase lng_recovery_many_text = { "{count} word lists are valid. Choose the right word below, or enter the public key to find it." };
+const phrase lng_recovery_many_shown = { "Only the first {shown} of them are shown." };
+const phrase lng_recovery_choose = { "Use word {index}: {word}" };
+const phrase lng_recovery_many_retry = { "Enter public key" };
+const phrase lng_recovery_close = { "Close" };
 
 const phrase lng_done_title = { "Your public key" };
 #ifdef KEYGEN_OFFICIAL_BUILD
@@ -64,6 +121,9 @@ const phrase lng_done_copy_key = { "Copy public key" };
 const phrase lng_done_save_key = { "Save as file" };
 const phrase lng_done_verify_key = { "Verify private key" };
 const phrase lng_done_generate_new = { "Generate new key" };
+const phrase lng_done_addresses = { "Wallet addresses" };
+const phrase lng_done_split = { "Split into shares" };
+const phrase lng_done_keystore = { "Export encrypted words" };
 const phrase lng_done_to_clipboard = { "Public key copied to clipboard." };
 const phrase lng_done_save_caption = { "Choose file name" };
 const phrase lng_done_to_file = { "Public key saved to file." };
@@ -72,4 +132,47 @@ const phrase lng_done_new_text = { "Generating a new pair of keys makes\nsense o
 const phrase lng_done_new_cancel = { "Cancel" };
 const phrase lng_done_new_ok = { "OK" };
 
+const phrase lng_addresses_title = { "Wallet addresses" };
+const phrase lng_addresses_wallet = { "Wallet {version} in the {workchain}" };
+const phrase lng_addresses_basechain = { "basechain" };
+const phrase lng_addresses_masterchain = { "masterchain" };
+const phrase lng_addresses_copy = { "Copy" };
+const phrase lng_addresses_close = { "Close" };
+const phrase lng_addresses_to_clipboard = { "Wallet addresses copied to clipboard." };
+
+const phrase lng_split_title = { "Split into shares" };
+const phrase lng_split_text = { "Your secret words can be split into several shares of 27 words each. The required number of shares gives the words back, while fewer shares reveal nothing about them.\n\nKeep every share in a separate safe place." };
+const phrase lng_split_threshold = { "Shares required" };
+const phrase lng_split_count = { "Shares total" };
+const phrase lng_split_submit = { "Split" };
+const phrase lng_split_cancel = { "Cancel" };
+
+const phrase lng_shares_title = { "Shares" };
+const phrase lng_shares_about = { "Any {threshold} of these {count} shares give your secret words back." };
+const phrase lng_shares_share = { "Share {index}" };
+const phrase lng_shares_copy = { "Copy" };
+const phrase lng_shares_close = { "Close" };
+const phrase lng_shares_to_clipboard = { "Shares copied to clipboard." };
+
+const phrase lng_combine_title = { "Combine shares" };
+const phrase lng_combine_text = { "Enter the required number of shares, one share of 27 words on each line. If the secret words are protected with a password, enter it as well." };
+const phrase lng_combine_shares = { "Shares" };
+const phrase lng_combine_password = { "Password, if any" };
+const phrase lng_combine_submit = { "Combine" };
+const phrase lng_combine_cancel = { "Cancel" };
+const phrase lng_combine_bad_shares = { "Some of the shares are mistyped or were split from different keys." };
+const phrase lng_combine_bad_count = { "These shares are not enough, please enter more of them." };
+const phrase lng_combine_bad_password = { "These secret words are protected with a password. Please enter it to combine the shares." };
+const phrase lng_combine_bad_key = { "The combined words do not match the key they were split from. Please check the password." };
+
+const phrase lng_keystore_title = { "Export encrypted words" };
+const phrase lng_keystore_text = { "Your secret words will be saved to a file encrypted with a passphrase. Opening it takes about a second of work on this computer, so that the passphrase is hard to guess.\n\nKeep the passphrase apart from the file." };
+const phrase lng_keystore_passphrase = { "Passphrase" };
+const phrase lng_keystore_repeat = { "Repeat passphrase" };
+const phrase lng_keystore_submit = { "Export" };
+const phrase lng_keystore_cancel = { "Cancel" };
+const phrase lng_keystore_progress_title = { "Encrypting" };
+const phrase lng_keystore_progress_text = { "Measuring this computer and encrypting your secret words..." };
+const phrase lng_keystore_to_file = { "Encrypted words saved to file." };
+
 } // namespace tr
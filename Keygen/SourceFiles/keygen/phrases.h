@@ -19,7 +19,37 @@ extern const phrase lng_intro_verify;
 extern const phrase lng_intro_verify_title;
 extern const phrase lng_intro_verify_text;
 extern const phrase lng_intro_verify_ok;
+extern const phrase lng_intro_verify_combine;
 extern const phrase lng_intro_verify_cancel;
+extern const phrase lng_intro_options;
+
+extern const phrase lng_options_title;
+extern const phrase lng_options_text;
+extern const phrase lng_options_password;
+extern const phrase lng_options_vanity;
+extern const phrase lng_options_submit;
+extern const phrase lng_options_cancel;
+
+extern const phrase lng_password_title;
+extern const phrase lng_password_description;
+extern const phrase lng_password_placeholder;
+extern const phrase lng_password_repeat;
+extern const phrase lng_password_next;
+
+extern const phrase lng_vanity_title;
+extern const phrase lng_vanity_description;
+extern const phrase lng_vanity_placeholder;
+extern const phrase lng_vanity_address_placeholder;
+extern const phrase lng_vanity_address;
+extern const phrase lng_vanity_next;
+extern const phrase lng_vanity_progress_title;
+extern const phrase lng_vanity_progress_text;
+extern const phrase lng_vanity_progress_starting;
+extern const phrase lng_vanity_time_minute;
+extern const phrase lng_vanity_time_minutes;
+extern const phrase lng_vanity_time_hours;
+extern const phrase lng_vanity_time_days;
+extern const phrase lng_vanity_cancel;
 
 extern const phrase lng_random_seed_title;
 extern const phrase lng_random_seed_description;
@@ -55,6 +85,33 @@ extern const phrase lng_verify_bad_try_again;
 extern const phrase lng_verify_good_title;
 extern const phrase lng_verify_good_text;
 extern const phrase lng_verify_good_next;
+extern const phrase lng_verify_bad_recover;
+extern const phrase lng_verify_password_title;
+extern const phrase lng_verify_password_text;
+extern const phrase lng_verify_password_submit;
+extern const phrase lng_verify_password_cancel;
+
+extern const phrase lng_recovery_title;
+extern const phrase lng_recovery_text;
+extern const phrase lng_recovery_position;
+extern const phrase lng_recovery_public_key;
+extern const phrase lng_recovery_password;
+extern const phrase lng_recovery_start;
+extern const phrase lng_recovery_cancel;
+extern const phrase lng_recovery_progress_title;
+extern const phrase lng_recovery_progress_text;
+extern const phrase lng_recovery_word;
+extern const phrase lng_recovery_none_title;
+extern const phrase lng_recovery_none_text;
+extern const phrase lng_recovery_found_title;
+extern const phrase lng_recovery_found_text;
+extern const phrase lng_recovery_found_use;
+extern const phrase lng_recovery_many_title;
+extern const phrase lng_recovery_many_text;
+extern const phrase lng_recovery_many_shown;
+extern const phrase lng_recovery_choose;
+extern const phrase lng_recovery_many_retry;
+extern const phrase lng_recovery_close;
 
 extern const phrase lng_done_title;
 extern const phrase lng_done_description;
@@ -62,6 +119,9 @@ extern const phrase lng_done_copy_key;
 extern const phrase lng_done_save_key;
 extern const phrase lng_done_verify_key;
 extern const phrase lng_done_generate_new;
+extern const phrase lng_done_addresses;
+extern const phrase lng_done_split;
+extern const phrase lng_done_keystore;
 extern const phrase lng_done_to_clipboard;
 extern const phrase lng_done_save_caption;
 extern const phrase lng_done_to_file;
@@ -70,4 +130,47 @@ extern const phrase lng_done_new_text;
 extern const phrase lng_done_new_cancel;
 extern const phrase lng_done_new_ok;
 
+extern const phrase lng_addresses_title;
+extern const phrase lng_addresses_wallet;
+extern const phrase lng_addresses_basechain;
+extern const phrase lng_addresses_masterchain;
+extern const phrase lng_addresses_copy;
+extern const phrase lng_addresses_close;
+extern const phrase lng_addresses_to_clipboard;
+
+extern const phrase lng_split_title;
+extern const phrase lng_split_text;
+extern const phrase lng_split_threshold;
+extern const phrase lng_split_count;
+extern const phrase lng_split_submit;
+extern const phrase lng_split_cancel;
+
+extern const phrase lng_shares_title;
+extern const phrase lng_shares_about;
+extern const phrase lng_shares_share;
+extern const phrase lng_shares_copy;
+extern const phrase lng_shares_close;
+extern const phrase lng_shares_to_clipboard;
+
+extern const phrase lng_combine_title;
+extern const phrase lng_combine_text;
+extern const phrase lng_combine_shares;
+extern const phrase lng_combine_password;
+extern const phrase lng_combine_submit;
+extern const phrase lng_combine_cancel;
+extern const phrase lng_combine_bad_shares;
+extern const phrase lng_combine_bad_count;
+extern const phrase lng_combine_bad_password;
+extern const phrase lng_combine_bad_key;
+
+extern const phrase lng_keystore_title;
+extern const phrase lng_keystore_text;
+extern const phrase lng_keystore_passphrase;
+extern const phrase lng_keystore_repeat;
+extern const phrase lng_keystore_submit;
+extern const phrase lng_keystore_cancel;
+extern const phrase lng_keystore_progress_title;
+extern const phrase lng_keystore_progress_text;
+extern const phrase lng_keystore_to_file;
+
 } // namespace tr
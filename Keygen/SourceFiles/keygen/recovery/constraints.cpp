@@ -0,0 +1,275 @@
+// This file is part of TON Key Generator,
+// a desktop application for the TON Blockchain project.
+//
+// For license and copyright information please follow this link:
+// https://github.com/ton-blockchain/tonkeygen/blob/master/LEGAL
+//
+#include "keygen/recovery/constraints.h"
+
+#include "keygen/word_index.h"
+#include "keygen/word_set.h"
+
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QRegExp>
+
+namespace Keygen::Recovery {
+namespace {
+
+constexpr auto kColumnHeight = kWordsCount / 2;
+
+[[nodiscard]] std::optional<Layout> ParseLayout(const QString &name) {
+	if (name == qstr("written")) {
+		return Layout::Written;
+	} else if (name == qstr("rows")) {
+		return Layout::Rows;
+	} else if (name == qstr("swapped")) {
+		return Layout::Swapped;
+	}
+	return std::nullopt;
+}
+
+// For each position of the real list, where it was written down.
+[[nodiscard]] WordIndices LayoutMap(Layout layout) {
+	auto result = WordIndices();
+	for (auto i = 0; i != kWordsCount; ++i) {
+		switch (layout) {
+		case Layout::Written: result[i] = i; break;
+		case Layout::Rows:
+			result[i] = (i < kColumnHeight)
+				? (2 * i)
+				: (2 * (i - kColumnHeight) + 1);
+			break;
+		case Layout::Swapped:
+			result[i] = (i + kColumnHeight) % kWordsCount;
+			break;
+		default: Unexpected("Layout in LayoutMap.");
+		}
+	}
+	return result;
+}
+
+void AddMatching(
+		std::vector<int> &candidates,
+		const QString &pattern,
+		const WordIndex &index,
+		const WordSet &set) {
+	auto literal = 0;
+	while (literal != pattern.size()
+		&& pattern[literal] != '?'
+		&& pattern[literal] != '*') {
+		++literal;
+	}
+	if (literal == pattern.size()) {
+		// An exact word is looked up in the membership index only.
+		if (set.contains(pattern)) {
+			const auto range = index.byPrefix(QStringRef(&pattern));
+			candidates.push_back(range.wordIndex(0));
+		}
+		return;
+	}
+
+	// Only the words starting with the readable part may match.
+	const auto range = index.byPrefix(pattern.midRef(0, literal));
+	const auto matcher = QRegExp(
+		pattern,
+		Qt::CaseInsensitive,
+		QRegExp::Wildcard);
+	for (auto i = 0; i != range.size(); ++i) {
+		const auto word = range.wordIndex(i);
+		if (matcher.exactMatch(index.text(word))) {
+			candidates.push_back(word);
+		}
+	}
+}
+
+[[nodiscard]] bool Multiply(uint64 &value, uint64 by) {
+	if (by && value > std::numeric_limits<uint64>::max() / by) {
+		return false;
+	}
+	value *= by;
+	return true;
+}
+
+} // namespace
+
+std::optional<Constraints> ParseConstraints(
+		const QByteArray &json,
+		const WordIndex &index,
+		const WordSet &set,
+		QString *error) {
+	const auto fail = [&](const QString &text) {
+		if (error) {
+			*error = text;
+		}
+		return std::nullopt;
+	};
+	auto parseError = QJsonParseError();
+	const auto document = QJsonDocument::fromJson(json, &parseError);
+	if (parseError.error != QJsonParseError::NoError) {
+		return fail("Bad JSON: " + parseError.errorString());
+	} else if (!document.isObject()) {
+		return fail("The spec must be a JSON object.");
+	}
+	const auto object = document.object();
+	const auto words = object.value("words").toArray();
+	if (words.size() != kWordsCount) {
+		return fail(QString("Expected %1 entries in \"words\".").arg(
+			kWordsCount));
+	}
+
+	auto result = Constraints();
+	for (auto i = 0; i != kWordsCount; ++i) {
+		const auto entry = words[i];
+		const auto patterns = entry.isArray()
+			? entry.toArray()
+			: QJsonArray{ entry };
+		auto &candidates = result.candidates[i];
+		for (const auto &pattern : patterns) {
+			if (!pattern.isString()) {
+				return fail(QString("Bad entry for word %1.").arg(i + 1));
+			}
+			AddMatching(
+				candidates,
+				pattern.toString().trimmed().toLower(),
+				index,
+				set);
+		}
+		ranges::sort(candidates);
+		candidates.erase(
+			std::unique(begin(candidates), end(candidates)),
+			end(candidates));
+		if (candidates.empty()) {
+			return fail(QString("No word matches word %1.").arg(i + 1));
+		}
+	}
+
+	for (const auto &value : object.value("shuffled").toArray()) {
+		const auto number = value.toInt();
+		const auto position = number - 1;
+		if (position < 0 || position >= kWordsCount) {
+			return fail(QString("Bad shuffled word number %1.").arg(number));
+		} else if (ranges::find(result.shuffled, position)
+			!= end(result.shuffled)) {
+			return fail(QString("Shuffled word %1 repeats.").arg(number));
+		} else if (result.candidates[position].size() != 1) {
+			return fail(QString("Shuffled word %1 must be known.").arg(
+				number));
+		}
+		result.shuffled.push_back(position);
+	}
+
+	for (const auto &value : object.value("layouts").toArray()) {
+		const auto name = value.toString();
+		const auto layout = ParseLayout(name);
+		if (!layout) {
+			return fail(QString("Unknown layout \"%1\".").arg(name));
+		} else if (ranges::find(result.layouts, *layout)
+			== end(result.layouts)) {
+			result.layouts.push_back(*layout);
+		}
+	}
+	if (result.layouts.empty()) {
+		result.layouts.push_back(Layout::Written);
+	}
+
+	result.password = object.value("password").toString().toUtf8();
+	result.publicKey = object.value("publicKey").toString().toUtf8();
+	return result;
+}
+
+std::optional<Space> Space::Create(const Constraints &constraints) {
+	auto result = Space();
+	result._candidates = constraints.candidates;
+	result._shuffled = constraints.shuffled;
+	result._size = 1;
+	for (auto i = 0; i != kWordsCount; ++i) {
+		const auto &candidates = constraints.candidates[i];
+
+		Expects(!candidates.empty());
+
+		if (ranges::find(result._shuffled, i) != end(result._shuffled)) {
+			result._shuffledWords.push_back(candidates.front());
+		} else if (candidates.size() > 1) {
+			result._free.push_back(i);
+			if (!Multiply(result._size, candidates.size())) {
+				return std::nullopt;
+			}
+		}
+	}
+
+	// Permutations are numbered by their factorial number system digits.
+	result._factorials.push_back(1);
+	for (auto i = 1; i <= int(result._shuffled.size()); ++i) {
+		auto factorial = result._factorials.back();
+		if (!Multiply(factorial, i)) {
+			return std::nullopt;
+		}
+		result._factorials.push_back(factorial);
+	}
+	result._permutations = result._factorials.back();
+
+	for (const auto layout : constraints.layouts) {
+		result._layouts.push_back(LayoutMap(layout));
+	}
+	if (!Multiply(result._size, result._permutations)
+		|| !Multiply(result._size, result._layouts.size())) {
+		return std::nullopt;
+	}
+	return result;
+}
+
+uint64 Space::size() const {
+	return _size;
+}
+
+WordIndices Space::at(uint64 number) const {
+	Expects(number < _size);
+
+	auto written = WordIndices();
+	for (auto i = 0; i != kWordsCount; ++i) {
+		written[i] = _candidates[i].front();
+	}
+	for (const auto position : _free) {
+		const auto &candidates = _candidates[position];
+		written[position] = candidates[number % candidates.size()];
+		number /= candidates.size();
+	}
+
+	auto permutation = number % _permutations;
+	number /= _permutations;
+	auto pool = WordIndices();
+	auto left = int(_shuffledWords.size());
+	std::copy(begin(_shuffledWords), end(_shuffledWords), begin(pool));
+	for (const auto position : _shuffled) {
+		const auto factorial = _factorials[--left];
+		const auto pick = int(permutation / factorial);
+		permutation %= factorial;
+		written[position] = pool[pick];
+		std::copy(
+			begin(pool) + pick + 1,
+			begin(pool) + left + 1,
+			begin(pool) + pick);
+	}
+
+	const auto &map = _layouts[number];
+	auto result = WordIndices();
+	for (auto i = 0; i != kWordsCount; ++i) {
+		result[i] = written[map[i]];
+	}
+	return result;
+}
+
+std::pair<uint64, uint64> Space::shard(int index, int count) const {
+	Expects(count > 0);
+	Expects(index >= 0 && index < count);
+
+	const auto base = _size / count;
+	const auto extra = _size % count;
+	const auto from = index * base + std::min(uint64(index), extra);
+	const auto till = from + base + ((uint64(index) < extra) ? 1 : 0);
+	return { from, till };
+}
+
+} // namespace Keygen::Recovery
@@ -0,0 +1,88 @@
+// This file is part of TON Key Generator,
+// a desktop application for the TON Blockchain project.
+//
+// For license and copyright information please follow this link:
+// https://github.com/ton-blockchain/tonkeygen/blob/master/LEGAL
+//
+#pragma once
+
+#include "keygen/crypto/mnemonic.h"
+
+namespace Keygen {
+class WordIndex;
+class WordSet;
+} // namespace Keygen
+
+namespace Keygen::Recovery {
+
+inline constexpr auto kWordsCount = Crypto::kMnemonicWordsCount;
+
+using WordIndices = std::array<int, kWordsCount>;
+
+// Orders in which the words could have been written down from the View
+// step, which shows words 1-12 in the left column and 13-24 in the right.
+enum class Layout {
+	Written, // As they are in the spec.
+	Rows, // Row by row: 1, 13, 2, 14, ...
+	Swapped, // Right column first: 13-24, 1-12.
+};
+
+// What is known about the words, in the order they were written down.
+//
+// The spec is a JSON object:
+// {
+//   "words": [ 24 entries ],
+//   "shuffled": [ word numbers ],
+//   "layouts": [ "written", "rows", "swapped" ],
+//   "password": "...",
+//   "publicKey": "..."
+// }
+// Each of the "words" is a word, a pattern where '?' stands for one
+// unreadable letter and '*' for any number of them, or an array of those.
+// The words at the "shuffled" numbers (starting from 1) are known, but
+// not their order. Only "words" is required.
+struct Constraints {
+	std::array<std::vector<int>, kWordsCount> candidates;
+	std::vector<int> shuffled;
+	std::vector<Layout> layouts;
+	QByteArray password;
+	QByteArray publicKey;
+};
+
+[[nodiscard]] std::optional<Constraints> ParseConstraints(
+	const QByteArray &json,
+	const WordIndex &index,
+	const WordSet &set,
+	QString *error);
+
+// All the word lists the constraints allow, numbered in a fixed order,
+// so that any range of numbers is the same work in every process.
+class Space final {
+public:
+	// Returns nothing if there are more lists than uint64 can number.
+	[[nodiscard]] static std::optional<Space> Create(
+		const Constraints &constraints);
+
+	[[nodiscard]] uint64 size() const;
+	[[nodiscard]] WordIndices at(uint64 number) const;
+
+	// The range [from, till) of the shard, shards differ by one at most.
+	[[nodiscard]] std::pair<uint64, uint64> shard(
+		int index,
+		int count) const;
+
+private:
+	Space() = default;
+
+	std::array<std::vector<int>, kWordsCount> _candidates;
+	std::vector<int> _free;
+	std::vector<int> _shuffled;
+	std::vector<int> _shuffledWords;
+	std::vector<uint64> _factorials;
+	std::vector<WordIndices> _layouts;
+	uint64 _permutations = 1;
+	uint64 _size = 0;
+
+};
+
+} // namespace Keygen::Recovery
@@ -0,0 +1,311 @@
+// This file is part of TON Key Generator,
+// a desktop application for the TON Blockchain project.
+//
+// For license and copyright information please follow this link:
+// https://github.com/ton-blockchain/tonkeygen/blob/master/LEGAL
+//
+#include "keygen/recovery/search.h"
+
+#include "keygen/recovery/constraints.h"
+#include "keygen/crypto/mnemonic.h"
+#include "keygen/crypto/wallet_address.h"
+#include "keygen/word_index.h"
+#include "keygen/word_set.h"
+#include "ton/ton_wallet.h"
+
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QFile>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QSaveFile>
+#include <QtCore/QTextStream>
+
+#include <thread>
+
+namespace Keygen::Recovery {
+namespace {
+
+constexpr auto kBlockSize = 16384;
+constexpr auto kCheckpointDelay = 60 * crl::time(1000);
+
+struct Found {
+	QStringList words;
+	QByteArray publicKey;
+	QStringList addresses;
+};
+
+struct Checkpoint {
+	uint64 next = 0;
+	std::vector<Found> found;
+};
+
+[[nodiscard]] QStringList WalletAddresses(const QByteArray &publicKey) {
+	auto result = QStringList();
+	if (const auto key = Crypto::ParsePublicKey(publicKey)) {
+		for (const auto &address : Crypto::ComputeWalletAddresses(*key)) {
+			result.push_back(QString::fromLatin1(
+				Crypto::SerializeAddress(address)));
+		}
+	}
+	return result;
+}
+
+[[nodiscard]] QString WalletColumnsHeader() {
+	auto result = QStringList();
+	for (const auto workchain : Crypto::kWalletWorkchains) {
+		for (const auto version : Crypto::kWalletVersions) {
+			result.push_back(QString("%1@%2").arg(
+				Crypto::WalletVersionName(version)
+			).arg(workchain));
+		}
+	}
+	return result.join('\t');
+}
+
+[[nodiscard]] QString FoundLine(const Found &found) {
+	const auto columns = QStringList{
+		"found",
+		found.words.join(' '),
+		QString::fromLatin1(found.publicKey),
+	} + found.addresses;
+	return columns.join('\t');
+}
+
+[[nodiscard]] QString SpecDigest(const QByteArray &json) {
+	return QString::fromLatin1(QCryptographicHash::hash(
+		json,
+		QCryptographicHash::Sha256).toHex());
+}
+
+[[nodiscard]] std::optional<Checkpoint> ReadCheckpoint(
+		const QString &path,
+		const QString &digest,
+		const SearchOptions &options,
+		QString *error) {
+	auto file = QFile(path);
+	if (!file.exists()) {
+		return Checkpoint();
+	} else if (!file.open(QIODevice::ReadOnly)) {
+		*error = "Could not read the checkpoint.";
+		return std::nullopt;
+	}
+	const auto object = QJsonDocument::fromJson(file.readAll()).object();
+	if (object.value("spec").toString() != digest
+		|| object.value("shard").toInt() != options.shard
+		|| object.value("shards").toInt() != options.shards) {
+		*error = "The checkpoint was left by another spec or shard.";
+		return std::nullopt;
+	}
+	auto result = Checkpoint();
+	result.next = object.value("next").toString().toULongLong();
+	for (const auto &value : object.value("found").toArray()) {
+		const auto entry = value.toObject();
+		auto found = Found();
+		for (const auto &word : entry.value("words").toArray()) {
+			found.words.push_back(word.toString());
+		}
+		found.publicKey = entry.value("publicKey").toString().toUtf8();
+		found.addresses = WalletAddresses(found.publicKey);
+		result.found.push_back(std::move(found));
+	}
+	return result;
+}
+
+[[nodiscard]] bool WriteCheckpoint(
+		const QString &path,
+		const QString &digest,
+		const SearchOptions &options,
+		const Checkpoint &checkpoint) {
+	auto found = QJsonArray();
+	for (const auto &entry : checkpoint.found) {
+		auto object = QJsonObject();
+		object.insert("words", QJsonArray::fromStringList(entry.words));
+		object.insert("publicKey", QString::fromUtf8(entry.publicKey));
+		found.push_back(object);
+	}
+	auto object = QJsonObject();
+	object.insert("spec", digest);
+	object.insert("shard", options.shard);
+	object.insert("shards", options.shards);
+	object.insert("next", QString::number(checkpoint.next));
+	object.insert("found", found);
+
+	// Either the previous checkpoint or the new one is there after a crash.
+	auto file = QSaveFile(path);
+	return file.open(QIODevice::WriteOnly)
+		&& (file.write(QJsonDocument(object).toJson()) >= 0)
+		&& file.commit();
+}
+
+// Finds the matching lists among [from, till) on the calling thread.
+[[nodiscard]] std::vector<Found> SearchBlock(
+		const Space &space,
+		const Crypto::MnemonicEngine &engine,
+		const std::vector<QByteArray> &words,
+		const Constraints &constraints,
+		uint64 from,
+		uint64 till) {
+	auto lists = std::vector<std::vector<QByteArray>>();
+	lists.reserve(till - from);
+	for (auto number = from; number != till; ++number) {
+		const auto indices = space.at(number);
+		lists.push_back(ranges::view::all(
+			indices
+		) | ranges::view::transform([&](int index) {
+			return words[index];
+		}) | ranges::to_vector);
+	}
+	const auto valid = engine.filterValid(lists, constraints.password);
+	if (valid.empty()) {
+		return {};
+	}
+	auto passed = ranges::view::all(
+		valid
+	) | ranges::view::transform([&](int index) {
+		return lists[index];
+	}) | ranges::to_vector;
+	const auto keys = engine.publicKeys(passed, constraints.password);
+
+	auto result = std::vector<Found>();
+	for (auto i = 0; i != int(valid.size()); ++i) {
+		if (!constraints.publicKey.isEmpty()
+			&& keys[i] != constraints.publicKey) {
+			continue;
+		}
+		auto found = Found();
+		for (const auto &word : passed[i]) {
+			found.words.push_back(QString::fromUtf8(word));
+		}
+		found.publicKey = keys[i];
+		found.addresses = WalletAddresses(found.publicKey);
+		result.push_back(std::move(found));
+	}
+	return result;
+}
+
+} // namespace
+
+int RunSearch(const SearchOptions &options) {
+	Expects(options.shards > 0);
+	Expects(options.shard >= 0 && options.shard < options.shards);
+
+	auto out = QTextStream(stdout);
+	auto err = QTextStream(stderr);
+	const auto fail = [&](const QString &text) {
+		err << text << "\n";
+		return 2;
+	};
+
+	auto file = QFile(options.specPath);
+	if (!file.open(QIODevice::ReadOnly)) {
+		return fail("Could not read the spec.");
+	}
+	const auto json = file.readAll();
+	const auto digest = SpecDigest(json);
+
+	const auto index = WordIndex(Ton::Wallet::GetValidWords());
+	const auto set = WordSet(index);
+	auto error = QString();
+	const auto constraints = ParseConstraints(json, index, set, &error);
+	if (!constraints) {
+		return fail(error);
+	}
+	const auto space = Space::Create(*constraints);
+	if (!space) {
+		return fail("The spec allows too many lists.");
+	}
+	const auto words = index.list();
+	const auto engine = Crypto::MnemonicEngine(words);
+	const auto [from, till] = space->shard(options.shard, options.shards);
+
+	auto checkpoint = options.checkpointPath.isEmpty()
+		? std::make_optional(Checkpoint())
+		: ReadCheckpoint(options.checkpointPath, digest, options, &error);
+	if (!checkpoint) {
+		return fail(error);
+	}
+	auto next = std::clamp(checkpoint->next, from, till);
+	err << "Columns: found, words, public key, " << WalletColumnsHeader()
+		<< "\n";
+	for (const auto &found : checkpoint->found) {
+		out << FoundLine(found) << "\n";
+	}
+	out.flush();
+	if (!constraints->publicKey.isEmpty() && !checkpoint->found.empty()) {
+		// Only one list can derive to the key and it is found already.
+		return 0;
+	}
+
+	const auto save = [&] {
+		checkpoint->next = next;
+		if (!options.checkpointPath.isEmpty()
+			&& !WriteCheckpoint(
+				options.checkpointPath,
+				digest,
+				options,
+				*checkpoint)) {
+			err << "Could not write the checkpoint.\n";
+		}
+		err
+			<< "Checked " << (next - from)
+			<< " of " << (till - from)
+			<< " lists, found " << checkpoint->found.size()
+			<< ".\n";
+		err.flush();
+	};
+
+	// Each round gives every core one block of consecutive numbers, so
+	// everything before the round end is done when the round finishes.
+	const auto workers = std::max(int(std::thread::hardware_concurrency()), 1);
+	auto saved = crl::now();
+	while (next != till) {
+		auto results = std::vector<std::vector<Found>>(workers);
+		auto threads = std::vector<std::thread>();
+		auto roundTill = next;
+		for (auto i = 0; i != workers && roundTill != till; ++i) {
+			const auto blockFrom = roundTill;
+			const auto blockTill = blockFrom
+				+ std::min(uint64(kBlockSize), till - blockFrom);
+			threads.emplace_back([&, i, blockFrom, blockTill] {
+				results[i] = SearchBlock(
+					*space,
+					engine,
+					words,
+					*constraints,
+					blockFrom,
+					blockTill);
+			});
+			roundTill = blockTill;
+		}
+		for (auto &thread : threads) {
+			thread.join();
+		}
+		next = roundTill;
+
+		auto matched = false;
+		for (auto &block : results) {
+			for (auto &found : block) {
+				out << FoundLine(found) << "\n";
+				checkpoint->found.push_back(std::move(found));
+				matched = true;
+			}
+		}
+		out.flush();
+
+		const auto now = crl::now();
+		if (next == till
+			|| (matched && !constraints->publicKey.isEmpty())
+			|| now - saved >= kCheckpointDelay) {
+			save();
+			saved = now;
+		}
+		if (matched && !constraints->publicKey.isEmpty()) {
+			// Only one list can derive to the key.
+			break;
+		}
+	}
+	return checkpoint->found.empty() ? 1 : 0;
+}
+
+} // namespace Keygen::Recovery
@@ -0,0 +1,27 @@
+// This file is part of TON Key Generator,
+// a desktop application for the TON Blockchain project.
+//
+// For license and copyright information please follow this link:
+// https://github.com/ton-blockchain/tonkeygen/blob/master/LEGAL
+//
+#pragma once
+
+namespace Keygen::Recovery {
+
+struct SearchOptions {
+	QString specPath;
+	int shard = 0;
+	int shards = 1;
+
+	// Created if missing, continued from if it was left by the same
+	// spec and shard.
+	QString checkpointPath;
+};
+
+// Headless search through one shard of the constraints space on all
+// cores. Found lists are printed to stdout as tab separated columns with
+// the public key and the standard wallet addresses, progress to stderr.
+// Returns the process exit code: 0 if something was found.
+[[nodiscard]] int RunSearch(const SearchOptions &options);
+
+} // namespace Keygen::Recovery
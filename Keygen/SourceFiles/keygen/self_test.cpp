@@ -0,0 +1,657 @@
+// This file is part of TON Key Generator,
+// a desktop application for the TON Blockchain project.
+//
+// For license and copyright information please follow this link:
+// https://github.com/ton-blockchain/tonkeygen/blob/master/LEGAL
+//
+#include "keygen/self_test.h"
+
+#include "keygen/crypto/ed25519.h"
+#include "keygen/crypto/mnemonic.h"
+#include "keygen/crypto/pbkdf2_sha512.h"
+#include "keygen/crypto/scrypt.h"
+#include "keygen/keystore.h"
+#include "keygen/word_index.h"
+#include "keygen/word_matcher.h"
+#include "keygen/word_set.h"
+#include "ton/ton_wallet.h"
+
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QTextStream>
+
+#include <openssl/evp.h>
+
+#include <chrono>
+#include <random>
+
+namespace Keygen {
+namespace {
+
+constexpr auto kMatcherQueries = 3000;
+constexpr auto kMatcherQueryTime = std::chrono::microseconds(1000);
+
+// Batch sizes leave partial groups of both four and eight lanes, salts
+// take up to three SHA-512 blocks.
+constexpr auto kPbkdf2Batches = 400;
+constexpr auto kPbkdf2BatchMax = 19;
+constexpr auto kPbkdf2SaltMax = 300;
+constexpr auto kPbkdf2IterationsMax = 64;
+
+struct ScryptVector {
+	const char *password;
+	const char *salt;
+	Crypto::ScryptParams params;
+	const char *key; // The first half of the 64 byte output.
+};
+
+// RFC 7914, 12.
+constexpr auto kScryptVectors = std::array<ScryptVector, 3>{ {
+	{
+		"",
+		"",
+		{ 4, 1, 1 },
+		"77d6576238657b203b19ca42c18a0497f16b4844e3074ae8dfdffa3fede21442",
+	},
+	{
+		"password",
+		"NaCl",
+		{ 10, 8, 16 },
+		"fdbabe1c9d3472007856e7190d01e9fe7c6ad7cbc8237830e77376634b373162",
+	},
+	{
+		"pleaseletmein",
+		"SodiumChloride",
+		{ 14, 8, 1 },
+		"7023bdcb3afd7348461c06cd81fd38ebfda8fbba904f8e3ea9b543f6545da1f2",
+	},
+} };
+
+// Batches of random inputs sharing small random costs.
+constexpr auto kScryptBatches = 40;
+constexpr auto kScryptBatchMax = 5;
+constexpr auto kScryptInputMax = 40;
+constexpr auto kScryptBatchLogNMax = 10;
+constexpr auto kScryptBatchRMax = 8;
+constexpr auto kScryptBatchPMax = 4;
+
+// Cheap costs, the round trip does not depend on them.
+constexpr auto kKeystoreParams = Crypto::ScryptParams{ 10, 8, 2 };
+constexpr auto kKeystoreWords = 24;
+
+constexpr auto kSharesThreshold = 3;
+constexpr auto kSharesCount = 5;
+
+// Batch sizes from a single key to several inversion batches.
+constexpr auto kPublicKeysBatches = 40;
+constexpr auto kPublicKeysBatchMax = 300;
+
+// RFC 8032, 7.1, test 1.
+constexpr auto kEd25519Secret =
+	"9d61b19deffd5a60ba844af492ec2cc44449c5697b326919703bac031cae7f60";
+constexpr auto kEd25519Public =
+	"d75a980182b10ab7d54bfed3c964073a0ee172f3daa62325af021a68f707511a";
+
+struct Check {
+	QString name;
+	Fn<QString()> run; // Returns the failure description.
+};
+
+// Known answers of the tonlib mnemonic scheme, computed apart from this
+// code. The second list is created for the password.
+constexpr auto kBasicWords = "accident adapt account add actress adult "
+	"action abstract access absorb able able abstract advance action "
+	"absent acquire about accuse accuse access absurd add adult";
+constexpr auto kBasicKey =
+	"PuaqpYKzAEh4HddLjqCE28TOMFJhu22P3E5Q7lFq78VI0ybF";
+constexpr auto kPasswordWords = "actress advice ability absorb adjust add "
+	"above account acquire addict access absent account actor address "
+	"acquire advance admit ability achieve accident access absorb advance";
+constexpr auto kPasswordKey =
+	"PuaRdkvVx6h1SY2iDhE5lVOi0uI2yHK8WFHPrxj48P4jiZ0N";
+constexpr auto kPassword = "password";
+constexpr auto kInvalidWords = "accident abandon address abstract addict "
+	"acoustic actress ability accident access act abstract addict accuse "
+	"actual above absurd across accident advice acid about actual address";
+
+[[nodiscard]] QString CheckWordIndex(const WordIndex &index) {
+	// Every keystroke does a lookup or narrows the previous range.
+	const auto before = index.stats();
+	auto narrowings = int64(0);
+	for (auto i = 0; i != index.size(); ++i) {
+		const auto word = QString(index.word(i));
+		auto range = index.byPrefix(word.midRef(0, 1));
+		for (auto length = 2; length <= word.size(); ++length) {
+			range = index.narrow(range, word.midRef(0, length));
+			++narrowings;
+		}
+		if (range.empty() || range.from > i || range.till <= i) {
+			return "The range of '" + word + "' misses it.";
+		} else if (range != index.byPrefix(word.midRef(0))) {
+			return "Narrowing to '" + word + "' differs from a lookup.";
+		}
+	}
+	const auto after = index.stats();
+	if (after.lookups - before.lookups != 2 * index.size()
+		|| after.narrowings - before.narrowings != narrowings) {
+		return "Lookups were not counted.";
+	}
+
+	// Texts share the data of the words the index was built from.
+	const auto words = Ton::Wallet::GetValidWords();
+	const auto shared = WordIndex(words);
+	for (auto i = 0; i != shared.size(); ++i) {
+		const auto &word = *(words.begin() + i);
+		if (shared.text(i) != QString(shared.word(i))) {
+			return "Wrong text of word " + QString::number(i) + '.';
+		} else if (shared.text(i).constData() != word.constData()) {
+			return "Text of word " + QString::number(i) + " is a copy.";
+		}
+	}
+	return QString();
+}
+
+[[nodiscard]] QString CheckWordSet(const WordIndex &index) {
+	const auto set = WordSet(index);
+	if (!set.hashed()) {
+		return "No perfect hash fits the list.";
+	}
+	auto reference = base::flat_set<QString>();
+	for (auto i = 0; i != index.size(); ++i) {
+		reference.emplace(index.text(i));
+	}
+
+	// Near misses may be words of the list too, the reference decides.
+	auto queries = std::vector<QString>{
+		QString(),
+		QString(" "),
+		QString("ab") + QChar(0x0441),
+	};
+	for (auto i = 0; i != index.size(); ++i) {
+		const auto &word = index.text(i);
+		auto changed = word;
+		changed[changed.size() - 1] = QChar(changed.back().unicode() + 1);
+		queries.push_back(word);
+		queries.push_back(word.toUpper());
+		queries.push_back(word.mid(0, word.size() - 1));
+		queries.push_back(word + 'a');
+		queries.push_back(word + ' ');
+		queries.push_back(changed);
+	}
+	for (const auto &query : queries) {
+		if (set.contains(query) != reference.contains(query)) {
+			return "Wrong answer for '" + query + "'.";
+		}
+	}
+	return QString();
+}
+
+// A word of the list with one random typo, cut at a random length.
+[[nodiscard]] QString MistypedWord(
+		const WordIndex &index,
+		std::mt19937 &random) {
+	const auto letter = [&] {
+		return QChar('a' + int(random() % 26));
+	};
+	auto result = QString(index.word(random() % index.size()));
+	const auto length = WordMatcher::kMinLength
+		+ int(random() % (WordMatcher::kMaxLength - WordMatcher::kMinLength));
+	result = result.mid(0, length);
+	while (result.size() < WordMatcher::kMinLength) {
+		result.append(letter());
+	}
+	const auto position = int(random() % result.size());
+	switch (random() % 4) {
+	case 0: result[position] = letter(); break;
+	case 1: result.insert(position, letter()); break;
+	case 2: result.remove(position, 1); break;
+	case 3:
+		if (position + 1 < result.size()) {
+			std::swap(result[position], result[position + 1]);
+		}
+		break;
+	}
+	return result.mid(0, WordMatcher::kMaxLength);
+}
+
+[[nodiscard]] QString CheckWordMatcher(const WordIndex &index) {
+	const auto matcher = WordMatcher(&index);
+	auto random = std::mt19937(1);
+	auto elapsed = std::chrono::steady_clock::duration();
+	auto expected = std::vector<std::pair<int, int>>();
+	for (auto i = 0; i != kMatcherQueries; ++i) {
+		const auto query = MistypedWord(index, random);
+		const auto started = std::chrono::steady_clock::now();
+		const auto found = matcher.find(query.midRef(0));
+		elapsed += std::chrono::steady_clock::now() - started;
+
+		// All the words within the limit, ranked by cost and then order.
+		const auto maxCost = (query.size() < WordMatcher::kMinLength)
+			? -1
+			: WordMatcher::maxCost(query.size());
+		expected.clear();
+		for (auto j = 0; j != index.size(); ++j) {
+			const auto cost = matcher.cost(query.midRef(0), index.word(j));
+			if (cost <= maxCost) {
+				expected.emplace_back(cost, j);
+			}
+		}
+		ranges::sort(expected);
+		const auto count = std::min(
+			int(expected.size()),
+			int(WordsRange::kMaxRanked));
+		auto same = (found.size() == count);
+		for (auto j = 0; same && j != count; ++j) {
+			same = (found.wordIndex(j) == expected[j].second);
+		}
+		if (!same) {
+			return "Wrong suggestions for '" + query + "'.";
+		}
+	}
+	const auto average = elapsed / kMatcherQueries;
+	if (average > kMatcherQueryTime) {
+		return "Queries took "
+			+ QString::number(
+				std::chrono::duration_cast<std::chrono::microseconds>(
+					average).count())
+			+ "us on average.";
+	}
+	return QString();
+}
+
+[[nodiscard]] std::vector<QByteArray> SplitWords(const char *words) {
+	const auto list = QByteArray(words).split(' ');
+	return std::vector<QByteArray>(list.begin(), list.end());
+}
+
+[[nodiscard]] QString CheckMnemonic(const WordIndex &index) {
+	using Error = Crypto::MnemonicError;
+	const auto engine = Crypto::MnemonicEngine(index.list());
+	const auto basic = SplitWords(kBasicWords);
+	const auto password = SplitWords(kPasswordWords);
+	const auto invalid = SplitWords(kInvalidWords);
+	const auto same = [](
+			const Crypto::CheckedKey &checked,
+			Error error,
+			const QByteArray &publicKey = QByteArray()) {
+		return (checked.error == error) && (checked.publicKey == publicKey);
+	};
+	if (!engine.isValidWords(basic)
+		|| !engine.isValidWords(password)
+		|| !engine.isValidWords(invalid)) {
+		return "The lists have words missing in the wordlist.";
+	} else if (!same(engine.check(basic), Error::None, kBasicKey)) {
+		return "Wrong key of the words.";
+	} else if (!same(
+			engine.check(password, kPassword),
+			Error::None,
+			kPasswordKey)) {
+		return "Wrong key of the words with the password.";
+	} else if (!same(engine.check(password), Error::NeedPassword)) {
+		return "The words did not ask for the password.";
+	} else if (!same(engine.check(password, "wrong"), Error::InvalidMnemonic)
+		|| !same(engine.check(invalid), Error::InvalidMnemonic)) {
+		return "Invalid words were accepted.";
+	}
+
+	// The batched path runs the multi-buffer kernel on the same lists.
+	const auto batch = engine.check({ basic, password, invalid });
+	if (batch.size() != 3
+		|| !same(batch[0], Error::None, kBasicKey)
+		|| !same(batch[1], Error::NeedPassword)
+		|| !same(batch[2], Error::InvalidMnemonic)) {
+		return "The batched check differs.";
+	}
+	return QString();
+}
+
+[[nodiscard]] QString CheckShares(const WordIndex &index) {
+	using Error = Crypto::SharesError;
+	const auto engine = Crypto::MnemonicEngine(index.list());
+	const auto basic = SplitWords(kBasicWords);
+	const auto password = SplitWords(kPasswordWords);
+	const auto split = engine.split(
+		{ basic, password, basic },
+		{ kBasicKey, kPasswordKey, kPasswordKey },
+		kSharesThreshold,
+		kSharesCount);
+	if (split.size() != 3
+		|| ranges::any_of(split, [](const Crypto::KeyShares &shares) {
+			return shares.size() != kSharesCount;
+		})) {
+		return "Wrong shares count.";
+	}
+
+	// Every threshold of the shares gives the words back.
+	for (auto mask = 0; mask != (1 << kSharesCount); ++mask) {
+		auto subsets = std::array<Crypto::KeyShares, 2>();
+		for (auto i = 0; i != kSharesCount; ++i) {
+			if (mask & (1 << i)) {
+				subsets[0].push_back(split[0][i]);
+				subsets[1].push_back(split[1][i]);
+			}
+		}
+		const auto size = int(subsets[0].size());
+		const auto first = engine.combine(subsets[0]);
+		const auto second = engine.combine(subsets[1], kPassword);
+		if (size < kSharesThreshold) {
+			if (first.error != Error::NotEnoughShares
+				|| second.error != Error::NotEnoughShares) {
+				return QString("%1 shares were enough.").arg(size);
+			}
+		} else if (first.error != Error::None
+			|| first.words != basic
+			|| first.publicKey != kBasicKey
+			|| second.error != Error::None
+			|| second.words != password
+			|| second.publicKey != kPasswordKey) {
+			return QString("Shares %1 did not combine.").arg(mask);
+		}
+	}
+
+	const auto some = [&](int list) {
+		return Crypto::KeyShares(
+			split[list].begin(),
+			split[list].begin() + kSharesThreshold);
+	};
+	auto mixed = some(0);
+	mixed.back() = split[1].back();
+	if (engine.combine(some(1)).error != Error::NeedPassword) {
+		return "The shares did not ask for the password.";
+	} else if (engine.combine(some(1), "wrong").error != Error::KeyMismatch
+		|| engine.combine(some(2)).error != Error::KeyMismatch) {
+		return "The shares of another key were accepted.";
+	} else if (engine.combine(mixed).error != Error::InvalidShares) {
+		return "The shares of two lists were combined.";
+	}
+	return QString();
+}
+
+[[nodiscard]] QString CheckPublicKeys() {
+	auto random = std::mt19937(4);
+	auto seeds = std::vector<Crypto::Seed>();
+	auto results = std::vector<Crypto::PublicKey>();
+	for (auto batch = 0; batch != kPublicKeysBatches; ++batch) {
+		const auto count = 1 + int(random() % kPublicKeysBatchMax);
+		seeds.resize(count);
+		results.resize(count);
+		for (auto &seed : seeds) {
+			for (auto &byte : seed) {
+				byte = uchar(random());
+			}
+		}
+		if (batch == 0) {
+			// The first batch starts with the RFC key and the extremes.
+			const auto secret = QByteArray::fromHex(kEd25519Secret);
+			std::copy(secret.begin(), secret.end(), seeds[0].begin());
+			if (count > 2) {
+				seeds[1].fill(0x00);
+				seeds[2].fill(0xFF);
+			}
+		}
+		Crypto::ComputePublicKeys(seeds, results);
+		for (auto i = 0; i != count; ++i) {
+			if (results[i] != Crypto::ComputePublicKey(seeds[i])) {
+				return QString("Key %1 of %2 differs from OpenSSL."
+				).arg(i + 1
+				).arg(count);
+			}
+		}
+		if (batch == 0) {
+			const auto expected = QByteArray::fromHex(kEd25519Public);
+			const auto key = QByteArray(
+				reinterpret_cast<const char*>(results[0].data()),
+				results[0].size());
+			if (key != expected) {
+				return "Wrong key of the RFC 8032 secret.";
+			}
+		}
+	}
+	return QString();
+}
+
+[[nodiscard]] QString Pbkdf2KernelName(Crypto::Pbkdf2Kernel kernel) {
+	switch (kernel) {
+	case Crypto::Pbkdf2Kernel::Scalar: return "scalar";
+	case Crypto::Pbkdf2Kernel::Avx2: return "AVX2";
+	case Crypto::Pbkdf2Kernel::Avx512: return "AVX-512";
+	}
+	Unexpected("Kernel in Pbkdf2KernelName.");
+}
+
+[[nodiscard]] QString CheckPbkdf2(Crypto::Pbkdf2Kernel kernel) {
+	auto random = std::mt19937(2);
+	auto keys = std::vector<Crypto::Pbkdf2Block>();
+	auto results = std::vector<Crypto::Pbkdf2Block>();
+	for (auto batch = 0; batch != kPbkdf2Batches; ++batch) {
+		const auto count = 1 + int(random() % kPbkdf2BatchMax);
+		keys.resize(count);
+		results.resize(count);
+		for (auto &key : keys) {
+			for (auto &byte : key) {
+				byte = uchar(random());
+			}
+		}
+		auto salt = QByteArray(
+			int(random() % (kPbkdf2SaltMax + 1)),
+			Qt::Uninitialized);
+		for (auto &byte : salt) {
+			byte = char(random());
+		}
+		const auto iterations = 1 + int(random() % kPbkdf2IterationsMax);
+		Crypto::Pbkdf2Sha512Many(kernel, keys, salt, iterations, results);
+
+		for (auto i = 0; i != count; ++i) {
+			auto expected = Crypto::Pbkdf2Block();
+			const auto done = PKCS5_PBKDF2_HMAC(
+				reinterpret_cast<const char*>(keys[i].data()),
+				keys[i].size(),
+				reinterpret_cast<const uchar*>(salt.constData()),
+				salt.size(),
+				iterations,
+				EVP_sha512(),
+				expected.size(),
+				expected.data());
+			Assert(done == 1);
+			if (expected != results[i]) {
+				return QString(
+					"Key %1 of %2 differs, %3 byte salt, %4 iterations."
+				).arg(i + 1
+				).arg(count
+				).arg(salt.size()
+				).arg(iterations);
+			}
+		}
+	}
+	return QString();
+}
+
+[[nodiscard]] QString CheckScrypt() {
+	for (const auto &vector : kScryptVectors) {
+		const auto input = Crypto::ScryptInput{
+			QByteArray(vector.password),
+			QByteArray(vector.salt),
+		};
+		const auto keys = Crypto::ScryptMany(
+			gsl::make_span(&input, 1),
+			vector.params,
+			kKeystoreMemoryBudget);
+		const auto &key = keys->front();
+		const auto result = QByteArray(
+			reinterpret_cast<const char*>(key.data()),
+			key.size());
+		if (result != QByteArray::fromHex(vector.key)) {
+			return QString("Wrong key of the RFC 7914 vector, N=2^%1."
+			).arg(vector.params.logN);
+		}
+	}
+
+	auto random = std::mt19937(5);
+	const auto bytes = [&] {
+		auto result = QByteArray(
+			int(random() % (kScryptInputMax + 1)),
+			Qt::Uninitialized);
+		for (auto &byte : result) {
+			byte = char(random());
+		}
+		return result;
+	};
+	auto inputs = std::vector<Crypto::ScryptInput>();
+	for (auto batch = 0; batch != kScryptBatches; ++batch) {
+		auto params = Crypto::ScryptParams();
+		params.logN = 1 + int(random() % kScryptBatchLogNMax);
+		params.r = 1 + int(random() % kScryptBatchRMax);
+		params.p = 1 + int(random() % kScryptBatchPMax);
+		inputs.resize(1 + random() % kScryptBatchMax);
+		for (auto &input : inputs) {
+			input.password = bytes();
+			input.salt = bytes();
+		}
+		const auto keys = Crypto::ScryptMany(
+			inputs,
+			params,
+			kKeystoreMemoryBudget);
+		for (auto i = 0; i != int(inputs.size()); ++i) {
+			const auto &input = inputs[i];
+			auto expected = Crypto::ScryptKey();
+			const auto done = EVP_PBE_scrypt(
+				input.password.constData(),
+				input.password.size(),
+				reinterpret_cast<const uchar*>(input.salt.constData()),
+				input.salt.size(),
+				uint64(1) << params.logN,
+				params.r,
+				params.p,
+				kKeystoreMemoryBudget,
+				expected.data(),
+				expected.size());
+			Assert(done == 1);
+			if (expected != (*keys)[i]) {
+				return QString(
+					"Input %1 of %2 differs, N=2^%3, r=%4, p=%5."
+				).arg(i + 1
+				).arg(inputs.size()
+				).arg(params.logN
+				).arg(params.r
+				).arg(params.p);
+			}
+		}
+	}
+	return QString();
+}
+
+// The same keystore with one field replaced.
+[[nodiscard]] QByteArray ChangeKeystore(
+		const QByteArray &keystore,
+		const QString &key,
+		const QJsonValue &value) {
+	auto object = QJsonDocument::fromJson(keystore).object();
+	object.insert(key, value);
+	return QJsonDocument(object).toJson();
+}
+
+[[nodiscard]] QString CheckKeystore(const WordIndex &index) {
+	auto random = std::mt19937(3);
+	auto entries = std::vector<KeystoreEntry>(2);
+	for (auto &entry : entries) {
+		for (auto i = 0; i != kKeystoreWords; ++i) {
+			const auto word = index.word(random() % index.size());
+			entry.words.emplace_back(word.data(), word.size());
+		}
+		entry.publicKey = "PublicKey" + QByteArray::number(random());
+	}
+	entries[1].needsPassword = true;
+
+	const auto passphrase = QByteArray("passphrase");
+	const auto keystores = ExportKeystores(
+		entries,
+		passphrase,
+		kKeystoreParams);
+	if (!keystores || keystores->size() != entries.size()) {
+		return "Export failed.";
+	}
+	for (auto i = 0; i != int(entries.size()); ++i) {
+		const auto &keystore = (*keystores)[i];
+		const auto imported = ImportKeystore(keystore, passphrase);
+		if (imported.error != KeystoreError::None
+			|| imported.entry.words != entries[i].words
+			|| imported.entry.publicKey != entries[i].publicKey
+			|| imported.entry.needsPassword != entries[i].needsPassword) {
+			return "Keystore " + QString::number(i + 1) + " differs.";
+		}
+	}
+
+	// The tag authenticates the ciphertext and the public key.
+	const auto &keystore = keystores->front();
+	const auto object = QJsonDocument::fromJson(keystore).object();
+	auto ciphertext = object.value("ciphertext").toString();
+	ciphertext[0] = (ciphertext[0] == '0') ? '1' : '0';
+	const auto wrong = {
+		ImportKeystore(keystore, "wrong passphrase").error,
+		ImportKeystore(
+			ChangeKeystore(keystore, "ciphertext", ciphertext),
+			passphrase).error,
+		ImportKeystore(
+			ChangeKeystore(keystore, "publicKey", "PublicKey"),
+			passphrase).error,
+	};
+	for (const auto error : wrong) {
+		if (error != KeystoreError::WrongPassphrase) {
+			return "A changed keystore was accepted.";
+		}
+	}
+	if (ImportKeystore("{}", passphrase).error != KeystoreError::Invalid
+		|| ImportKeystore(
+			ChangeKeystore(keystore, "version", 2),
+			passphrase).error != KeystoreError::Invalid) {
+		return "An invalid keystore was accepted.";
+	}
+
+	const auto cancelled = std::atomic<bool>(true);
+	if (ExportKeystores(entries, passphrase, kKeystoreParams, &cancelled)
+		|| Crypto::CalibrateScrypt(
+			kKeystoreUnlockTime,
+			kKeystoreMemoryBudget,
+			&cancelled)) {
+		return "Cancelling did not stop the derivation.";
+	}
+	return QString();
+}
+
+} // namespace
+
+int RunSelfTest() {
+	const auto index = WordIndex(Ton::Wallet::GetValidWords());
+	auto checks = std::vector<Check>{
+		{ "word index", [&] { return CheckWordIndex(index); } },
+		{ "word set", [&] { return CheckWordSet(index); } },
+		{ "word matcher", [&] { return CheckWordMatcher(index); } },
+		{ "mnemonic", [&] { return CheckMnemonic(index); } },
+		{ "key shares", [&] { return CheckShares(index); } },
+		{ "Ed25519 batches", [] { return CheckPublicKeys(); } },
+		{ "scrypt", [] { return CheckScrypt(); } },
+		{ "keystore", [&] { return CheckKeystore(index); } },
+	};
+	for (const auto kernel : Crypto::SupportedPbkdf2Kernels()) {
+		checks.push_back({
+			"PBKDF2-HMAC-SHA512 " + Pbkdf2KernelName(kernel),
+			[=] { return CheckPbkdf2(kernel); },
+		});
+	}
+
+	auto out = QTextStream(stdout);
+	auto failed = 0;
+	for (const auto &check : checks) {
+		const auto error = check.run();
+		if (error.isEmpty()) {
+			out << "ok\t" << check.name << "\n";
+		} else {
+			out << "FAILED\t" << check.name << ": " << error << "\n";
+			++failed;
+		}
+		out.flush();
+	}
+	return failed ? 1 : 0;
+}
+
+} // namespace Keygen
@@ -0,0 +1,16 @@
+// This file is part of TON Key Generator,
+// a desktop application for the TON Blockchain project.
+//
+// For license and copyright information please follow this link:
+// https://github.com/ton-blockchain/tonkeygen/blob/master/LEGAL
+//
+#pragma once
+
+namespace Keygen {
+
+// Headless checks of the fast paths against straightforward versions
+// of them. Prints one line for each check to stdout. Returns the process
+// exit code: 0 if all the checks passed.
+[[nodiscard]] int RunSelfTest();
+
+} // namespace Keygen
@@ -8,235 +8,21 @@
 
 #include "keygen/phrases.h"
 #include "ui/rp_widget.h"
-#include "ui/widgets/labels.h"
-#include "ui/widgets/input_fields.h"
 #include "ui/text/text_utilities.h"
-#include "ui/word_suggestions.h"
-#include "base/event_filter.h"
-#include "base/qt_signal_producer.h"
-#include "base/platform/base_platform_layout_switch.h"
+#include "ui/words_grid_editor.h"
 #include "styles/style_keygen.h"
 
-#include <QtGui/QtEvents>
-
 namespace Keygen::Steps {
 namespace {
 
 const auto kSkipPassword = QString("speakfriendandenter");
 
-class Word final {
-public:
-	enum class TabDirection {
-		Forward,
-		Backward,
-	};
-	Word(
-		not_null<QWidget*> parent,
-		int index,
-		Fn<std::vector<QString>(QString)> wordsByPrefix);
-	Word(const Word &other) = delete;
-	Word &operator=(const Word &other) = delete;
-
-	void move(int left, int top) const;
-	int top() const;
-	QString word() const;
-	void setFocus() const;
-	void showError() const;
-	void showErrorNoFocus() const;
-
-	[[nodiscard]] rpl::producer<> focused() const;
-	[[nodiscard]] rpl::producer<> blurred() const;
-	[[nodiscard]] rpl::producer<TabDirection> tabbed() const;
-	[[nodiscard]] rpl::producer<> submitted() const;
-
-private:
-	void setupSuggestions();
-	void createSuggestionsWidget();
-	void showSuggestions(const QString &word);
-
-	object_ptr<Ui::FlatLabel> _index;
-	object_ptr<Ui::InputField> _word;
-	const Fn<std::vector<QString>(QString)> _wordsByPrefix;
-	std::unique_ptr<Ui::WordSuggestions> _suggestions;
-	rpl::event_stream<TabDirection> _wordTabbed;
-	bool _chosen = false;
-
-};
-
-Word::Word(
-	not_null<QWidget*> parent,
-	int index,
-	Fn<std::vector<QString>(QString)> wordsByPrefix)
-: _index(parent, QString::number(index + 1) + '.', st::wordIndexLabel)
-, _word(parent, st::checkInputField, rpl::single(QString()), QString())
-, _wordsByPrefix(std::move(wordsByPrefix)) {
-	_word->customUpDown(true);
-	base::install_event_filter(_word.data(), [=](not_null<QEvent*> e) {
-		if (e->type() != QEvent::KeyPress) {
-			return base::EventFilterResult::Continue;
-		}
-		const auto ev = static_cast<QKeyEvent*>(e.get());
-		if ((ev->key() != Qt::Key_Tab) && (ev->key() != Qt::Key_Backtab)) {
-			return base::EventFilterResult::Continue;
-		}
-		const auto direction =  ((ev->key() == Qt::Key_Tab)
-			&& !(ev->modifiers() & Qt::ShiftModifier))
-			? TabDirection::Forward
-			: TabDirection::Backward;
-		_wordTabbed.fire_copy(direction);
-		return base::EventFilterResult::Cancel;
-	});
-	setupSuggestions();
-}
-
-void Word::setupSuggestions() {
-	base::qt_signal_producer(
-		_word.data(),
-		&Ui::InputField::changed
-	) | rpl::start_with_next([=] {
-		_chosen = false;
-		showSuggestions(word());
-	}, _word->lifetime());
-
-	focused(
-	) | rpl::filter([=] {
-		return !_chosen;
-	}) | rpl::start_with_next([=] {
-		showSuggestions(word());
-	}, _word->lifetime());
-
-	base::install_event_filter(_word.data(), [=](not_null<QEvent*> e) {
-		if (e->type() != QEvent::KeyPress || !_suggestions) {
-			return base::EventFilterResult::Continue;
-		}
-		const auto key = static_cast<QKeyEvent*>(e.get())->key();
-		if (key == Qt::Key_Up) {
-			_suggestions->selectUp();
-			return base::EventFilterResult::Cancel;
-		} else if (key == Qt::Key_Down) {
-			_suggestions->selectDown();
-			return base::EventFilterResult::Cancel;
-		}
-		return base::EventFilterResult::Continue;
-	});
-}
-
-void Word::showSuggestions(const QString &word) {
-	auto list = _wordsByPrefix(word);
-	if (list.empty() || (list.size() == 1 && list.front() == word) || word.size() < 3) {
-		if (_suggestions) {
-			_suggestions->hide();
-		}
-	} else {
-		if (!_suggestions) {
-			createSuggestionsWidget();
-		}
-		_suggestions->show(std::move(list));
-	}
-}
-
-void Word::createSuggestionsWidget() {
-	_suggestions = std::make_unique<Ui::WordSuggestions>(
-		_word->parentWidget());
-
-	_suggestions->chosen(
-	) | rpl::start_with_next([=](QString word) {
-		_chosen = true;
-		_word->setText(word);
-		_word->setFocus();
-		_word->setCursorPosition(word.size());
-		_suggestions = nullptr;
-		emit _word->submitted(Qt::KeyboardModifiers());
-	}, _suggestions->lifetime());
-
-	_suggestions->hidden(
-	) | rpl::start_with_next([=] {
-		_suggestions = nullptr;
-	}, _suggestions->lifetime());
-
-	_word->geometryValue(
-	) | rpl::start_with_next([=](QRect geometry) {
-		_suggestions->setGeometry(
-			geometry.topLeft() + QPoint(0, geometry.height()),
-			geometry.width());
-	}, _suggestions->lifetime());
-
-	_word->events(
-	) | rpl::filter([](not_null<QEvent*> e) {
-		return (e->type() == QEvent::KeyPress);
-	}) | rpl::map([=](not_null<QEvent*> e) {
-		return static_cast<QKeyEvent*>(e.get())->key();
-	}) | rpl::start_with_next([=](int key) {
-		if (key == Qt::Key_Up) {
-			_suggestions->selectUp();
-		} else if (key == Qt::Key_Down) {
-			_suggestions->selectDown();
-		}
-	}, _suggestions->lifetime());
-
-	blurred(
-	) | rpl::start_with_next([=] {
-		_suggestions->hide();
-	}, _suggestions->lifetime());
-}
-
-void Word::move(int left, int top) const {
-	_index->move(left - _index->width() - st::wordIndexSkip, top);
-	_word->move(left, top - st::checkInputSkip);
-}
-
-void Word::setFocus() const {
-	base::Platform::SwitchKeyboardLayoutToEnglish();
-	_word->setFocus();
-}
-
-void Word::showError() const {
-	_word->showError();
-}
-
-void Word::showErrorNoFocus() const {
-	_word->showErrorNoFocus();
-}
-
-rpl::producer<> Word::focused() const {
-	return base::qt_signal_producer(_word.data(), &Ui::InputField::focused);
-}
-
-rpl::producer<> Word::blurred() const {
-	return base::qt_signal_producer(_word.data(), &Ui::InputField::blurred);
-}
-
-rpl::producer<Word::TabDirection> Word::tabbed() const {
-	return _wordTabbed.events();
-}
-
-rpl::producer<> Word::submitted() const {
-	return base::qt_signal_producer(
-		_word.data(),
-		&Ui::InputField::submitted
-	) | rpl::filter([=] {
-		if (_suggestions) {
-			_suggestions->choose();
-			return false;
-		}
-		return true;
-	}) | rpl::map([] {
-		return rpl::empty_value();
-	});
-}
-
-int Word::top() const {
-	return _index->y();
-}
-
-QString Word::word() const {
-	return _word->getLastText();
-}
-
 } // namespace
 
 Check::Check(
-	Fn<std::vector<QString>(QString)> wordsByPrefix,
+	Fn<WordsRange(QString)> wordsByPrefix,
+	Fn<bool(int, QString)> isValidWord,
+	Fn<bool(int, QString)> isValidPrefix,
 	Layout type)
 : Step(Type::Scroll) {
 	const auto title = (type == Layout::Checking)
@@ -247,7 +33,10 @@ Check::Check(
 		: tr::lng_verify_description;
 	setTitle(title(Ui::Text::RichLangValue));
 	setDescription(description(Ui::Text::RichLangValue));
-	initControls(std::move(wordsByPrefix));
+	initControls(
+		std::move(wordsByPrefix),
+		std::move(isValidWord),
+		std::move(isValidPrefix));
 }
 
 std::vector<QString> Check::words() const {
@@ -258,6 +47,10 @@ rpl::producer<> Check::submitRequests() const {
 	return _submitRequests.events();
 }
 
+rpl::producer<std::vector<QString>> Check::speculateRequests() const {
+	return _speculateRequests.events();
+}
+
 void Check::setFocus() {
 	_setFocus();
 }
@@ -274,18 +67,34 @@ bool Check::allowEscapeBack() const {
 	return false;
 }
 
-void Check::initControls(Fn<std::vector<QString>(QString)> wordsByPrefix) {
+void Check::initControls(
+		Fn<WordsRange(QString)> wordsByPrefix,
+		Fn<bool(int, QString)> isValidWord,
+		Fn<bool(int, QString)> isValidPrefix) {
 	constexpr auto rows = 12;
 	constexpr auto count = rows * 2;
-	auto inputs = std::make_shared<std::vector<std::unique_ptr<Word>>>();
+	const auto editor = lifetime().make_state<Ui::WordsGridEditor>(
+		inner(),
+		count,
+		std::move(wordsByPrefix));
 	const auto wordsTop = st::checksTop;
 	const auto rowsBottom = wordsTop + rows * st::wordHeight;
 	const auto isValid = [=](int index) {
 		Expects(index < count);
 
-		const auto word = (*inputs)[index]->word();
-		const auto words = wordsByPrefix(word);
-		return !words.empty() && (words.front() == word);
+		return isValidWord(index, editor->word(index));
+	};
+	const auto speculated = lifetime().make_state<std::vector<QString>>();
+	const auto speculate = [=] {
+		// Derive the key in advance once every word looks right.
+		const auto ready = ranges::all_of(
+			ranges::view::ints(0, count),
+			isValid);
+		auto words = ready ? editor->words() : std::vector<QString>();
+		if (*speculated != words) {
+			*speculated = words;
+			_speculateRequests.fire(std::move(words));
+		}
 	};
 	const auto showError = [=](int index) {
 		Expects(index < count);
@@ -293,101 +102,93 @@ void Check::initControls(Fn<std::vector<QString>(QString)> wordsByPrefix) {
 		if (isValid(index)) {
 			return false;
 		}
-		(*inputs)[index]->showError();
+		editor->showError(index);
 		return true;
 	};
-	const auto init = [&](const Word &word, int index) {
-		const auto next = [=] {
-			return (index + 1 < count)
-				? (*inputs)[index + 1].get()
-				: nullptr;
-		};
-		const auto previous = [=] {
-			return (index > 0)
-				? (*inputs)[index - 1].get()
-				: nullptr;
-		};
 
-		word.focused(
-		) | rpl::start_with_next([=] {
-			const auto row = index % rows;
-			ensureVisible(
-				wordsTop + (row - 1) * st::wordHeight,
-				2 * st::wordHeight + st::suggestionsHeightMax);
-		}, lifetime());
-
-		word.blurred(
-		) | rpl::filter([=] {
-			return !(*inputs)[index]->word().trimmed().isEmpty()
-				&& !isValid(index);
-		}) | rpl::start_with_next([=] {
-			(*inputs)[index]->showErrorNoFocus();
+	editor->focused(
+	) | rpl::start_with_next([=](int index) {
+		const auto row = index % rows;
+		ensureVisible(
+			wordsTop + (row - 1) * st::wordHeight,
+			2 * st::wordHeight + st::suggestionsHeightMax);
+	}, lifetime());
+
+	editor->blurred(
+	) | rpl::filter([=](int index) {
+		return !editor->word(index).trimmed().isEmpty() && !isValid(index);
+	}) | rpl::start_with_next([=](int index) {
+		editor->showErrorNoFocus(index);
+	}, lifetime());
+
+	if (isValidPrefix) {
+		// Report a typo as soon as it is typed.
+		editor->edited(
+		) | rpl::filter([=](int index) {
+			return !isValidPrefix(index, editor->word(index));
+		}) | rpl::start_with_next([=](int index) {
+			editor->showErrorNoFocus(index);
 		}, lifetime());
+	}
 
-		word.tabbed(
-		) | rpl::start_with_next([=](Word::TabDirection direction) {
-			if (direction == Word::TabDirection::Forward) {
-				if (const auto word = next()) {
-					word->setFocus();
-				}
-			} else {
-				if (const auto word = previous()) {
-					word->setFocus();
+	editor->edited(
+	) | rpl::start_with_next([=] {
+		speculate();
+	}, lifetime());
+
+	editor->pasted(
+	) | rpl::start_with_next([=](const Ui::WordsGridEditor::Pasted &data) {
+		// Fill all the cells in one pass and then validate them.
+		const auto &words = data.words;
+		const auto from = (words.size() >= count) ? 0 : data.index;
+		const auto till = std::min(from + int(words.size()), count);
+		editor->setWords(from, words);
+		auto firstInvalid = -1;
+		for (auto i = from; i != till; ++i) {
+			if (!isValid(i)) {
+				editor->showErrorNoFocus(i);
+				if (firstInvalid < 0) {
+					firstInvalid = i;
 				}
 			}
-		}, lifetime());
-
-		word.submitted(
-		) | rpl::start_with_next([=] {
-			if ((*inputs)[index]->word() == kSkipPassword) {
+		}
+		editor->setFocus((firstInvalid >= 0) ? firstInvalid : (till - 1));
+		speculate();
+	}, lifetime());
+
+	editor->submitted(
+	) | rpl::start_with_next([=](int index) {
+		if (editor->word(index) == kSkipPassword) {
+			_submitRequests.fire({});
+		} else if (!showError(index)) {
+			if (index + 1 < count) {
+				editor->setFocus(index + 1);
+			} else {
 				_submitRequests.fire({});
-			} else if (!showError(index)) {
-				if (const auto word = next()) {
-					word->setFocus();
-				} else {
-					_submitRequests.fire({});
-				}
 			}
-		}, lifetime());
-	};
-	for (auto i = 0; i != count; ++i) {
-		inputs->push_back(std::make_unique<Word>(inner(), i, wordsByPrefix));
-		init(*inputs->back(), i);
-	}
+		}
+	}, lifetime());
 
 	inner()->sizeValue(
 	) | rpl::start_with_next([=](QSize size) {
-		const auto half = size.width() / 2;
-		const auto left = half - st::wordSkipLeft;
-		const auto right = half + st::wordSkipRight;
-		auto x = left;
-		auto y = contentTop() + wordsTop;
-		auto index = 0;
-		for (const auto &input : *inputs) {
-			input->move(x, y);
-			y += st::wordHeight;
-			if (++index == rows) {
-				x = right;
-				y = contentTop() + wordsTop;
-			}
-		}
+		editor->moveToTop(
+			contentTop() + wordsTop - st::checkInputSkip,
+			size.width());
 
 		auto state = NextButtonState();
 		state.text = tr::lng_view_next(tr::now);
 		state.top = rowsBottom + st::wordsNextSkip;
 		requestNextButton(state);
-	}, inner()->lifetime());
+	}, lifetime());
 
 	_words = [=] {
-		return (*inputs) | ranges::view::transform(
-			[](const std::unique_ptr<Word> &p) { return p->word(); }
-		) | ranges::to_vector;
+		return editor->words();
 	};
 	_setFocus = [=] {
-		inputs->front()->setFocus();
+		editor->setFocus(0);
 	};
 	_checkAll = [=] {
-		if ((*inputs)[0]->word() == kSkipPassword) {
+		if (editor->word(0) == kSkipPassword) {
 			return true;
 		}
 		auto result = true;
@@ -7,6 +7,7 @@
 #pragma once
 
 #include "keygen/steps/step.h"
+#include "keygen/word_index.h"
 
 namespace Keygen::Steps {
 
@@ -16,8 +17,11 @@ public:
 		Checking,
 		Verifying,
 	};
+	// When isValidPrefix is set typos are reported while typing.
 	Check(
-		Fn<std::vector<QString>(QString)> wordsByPrefix,
+		Fn<WordsRange(QString)> wordsByPrefix,
+		Fn<bool(int, QString)> isValidWord,
+		Fn<bool(int, QString)> isValidPrefix,
 		Layout type);
 
 	int desiredHeight() const override;
@@ -26,11 +30,17 @@ public:
 	[[nodiscard]] std::vector<QString> words() const;
 	[[nodiscard]] rpl::producer<> submitRequests() const;
 
+	// Fires all the words once they look valid, an empty list otherwise.
+	[[nodiscard]] rpl::producer<std::vector<QString>> speculateRequests() const;
+
 	void setFocus() override;
 	bool checkAll();
 
 private:
-	void initControls(Fn<std::vector<QString>(QString)> wordsByPrefix);
+	void initControls(
+		Fn<WordsRange(QString)> wordsByPrefix,
+		Fn<bool(int, QString)> isValidWord,
+		Fn<bool(int, QString)> isValidPrefix);
 
 	int _desiredHeight = 0;
 	Fn<std::vector<QString>()> _words;
@@ -38,6 +48,7 @@ private:
 	Fn<bool()> _checkAll;
 
 	rpl::event_stream<> _submitRequests;
+	rpl::event_stream<std::vector<QString>> _speculateRequests;
 
 };
 
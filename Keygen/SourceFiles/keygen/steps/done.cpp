@@ -50,6 +50,18 @@ rpl::producer<> Done::verifyKeyRequests() const {
 	return _verifyKeyRequests.events();
 }
 
+rpl::producer<> Done::addressesRequests() const {
+	return _addressesRequests.events();
+}
+
+rpl::producer<> Done::splitRequests() const {
+	return _splitRequests.events();
+}
+
+rpl::producer<> Done::keystoreRequests() const {
+	return _keystoreRequests.events();
+}
+
 void Done::showMenu(not_null<Ui::IconButton*> toggle) {
 	if (_menu) {
 		return;
@@ -78,6 +90,15 @@ void Done::showMenu(not_null<Ui::IconButton*> toggle) {
 		}
 	}));
 
+	menu->addAction(tr::lng_done_addresses(tr::now), [=] {
+		_addressesRequests.fire({});
+	});
+	menu->addAction(tr::lng_done_split(tr::now), [=] {
+		_splitRequests.fire({});
+	});
+	menu->addAction(tr::lng_done_keystore(tr::now), [=] {
+		_keystoreRequests.fire({});
+	});
 	menu->addAction(tr::lng_done_generate_new(tr::now), [=] {
 		_newKeyRequests.fire({});
 	});
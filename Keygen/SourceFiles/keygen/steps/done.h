@@ -24,6 +24,9 @@ public:
 	[[nodiscard]] rpl::producer<> saveKeyRequests() const;
 	[[nodiscard]] rpl::producer<> newKeyRequests() const;
 	[[nodiscard]] rpl::producer<> verifyKeyRequests() const;
+	[[nodiscard]] rpl::producer<> addressesRequests() const;
+	[[nodiscard]] rpl::producer<> splitRequests() const;
+	[[nodiscard]] rpl::producer<> keystoreRequests() const;
 
 private:
 	void initControls(const QString &publicKey);
@@ -36,6 +39,9 @@ private:
 	rpl::event_stream<> _saveKeyRequests;
 	rpl::event_stream<> _newKeyRequests;
 	rpl::event_stream<> _verifyKeyRequests;
+	rpl::event_stream<> _addressesRequests;
+	rpl::event_stream<> _splitRequests;
+	rpl::event_stream<> _keystoreRequests;
 
 	base::unique_qptr<Ui::DropdownMenu> _menu;
 
@@ -7,6 +7,8 @@
 #include "keygen/steps/manager.h"
 
 #include "keygen/steps/intro.h"
+#include "keygen/steps/password.h"
+#include "keygen/steps/vanity.h"
 #include "keygen/steps/random_seed.h"
 #include "keygen/steps/created.h"
 #include "keygen/steps/view.h"
@@ -15,6 +17,8 @@
 #include "keygen/phrases.h"
 #include "ui/wrap/fade_wrap.h"
 #include "ui/widgets/buttons.h"
+#include "ui/widgets/checkbox.h"
+#include "ui/widgets/input_fields.h"
 #include "ui/text/text_utilities.h"
 #include "ui/toast/toast.h"
 #include "ui/rp_widget.h"
@@ -29,10 +33,36 @@ namespace {
 constexpr auto kSeedLengthMin = 50;
 constexpr auto kSeedLengthMax = 200;
 constexpr auto kSaveKeyDoneDuration = crl::time(500);
+constexpr auto kWordsCount = 24;
+constexpr auto kPublicKeyLength = 48;
+constexpr auto kRecoveredShownMax = 8;
+constexpr auto kSharesMax = 255;
+
+[[nodiscard]] QString FormatVanityTime(int64 seconds) {
+	const auto minutes = seconds / 60;
+	const auto hours = minutes / 60;
+	const auto days = hours / 24;
+	const auto format = [](const tr::phrase &phrase, int64 count) {
+		return phrase(tr::now).replace("{count}", QString::number(count));
+	};
+	if (days > 1) {
+		return format(tr::lng_vanity_time_days, days);
+	} else if (hours > 1) {
+		return format(tr::lng_vanity_time_hours, hours);
+	} else if (minutes > 1) {
+		return format(tr::lng_vanity_time_minutes, minutes);
+	}
+	return tr::lng_vanity_time_minute(tr::now);
+}
 
 } // namespace
 
-Manager::Manager(Fn<std::vector<QString>(QString)> wordsByPrefix)
+Manager::Manager(
+	Fn<WordsRange(QString)> wordsByPrefix,
+	Fn<bool(QString)> isValidWord,
+	Fn<bool(int, QString)> isExpectedWord,
+	Fn<bool(int, QString)> isExpectedPrefix,
+	Fn<double(VanityRequest)> vanityChance)
 : _content(std::make_unique<Ui::RpWidget>())
 , _nextButton(
 	std::in_place,
@@ -48,12 +78,23 @@ Manager::Manager(Fn<std::vector<QString>(QString)> wordsByPrefix)
 		_content.get(),
 		tr::lng_intro_verify(tr::now),
 		st::verifyLink))
+, _optionsLink(
+	std::in_place,
+	_content.get(),
+	object_ptr<Ui::LinkButton>(
+		_content.get(),
+		tr::lng_intro_options(tr::now),
+		st::verifyLink))
 , _backButton(
 	std::in_place,
 	_content.get(),
 	object_ptr<Ui::IconButton>(_content.get(), st::topBackButton))
 , _layerManager(_content.get())
-, _wordsByPrefix(std::move(wordsByPrefix)) {
+, _wordsByPrefix(std::move(wordsByPrefix))
+, _isValidWord(std::move(isValidWord))
+, _isExpectedWord(std::move(isExpectedWord))
+, _isExpectedPrefix(std::move(isExpectedPrefix))
+, _vanityChance(std::move(vanityChance)) {
 	initButtons();
 }
 
@@ -74,6 +115,10 @@ void Manager::initButtons() {
 		verify();
 	});
 	_verifyLink->setDuration(st::coverDuration);
+	_optionsLink->entity()->setClickedCallback([=] {
+		showOptions();
+	});
+	_optionsLink->setDuration(st::coverDuration);
 
 	_backButton->entity()->setClickedCallback([=] { back(); });
 	_backButton->toggle(false, anim::type::instant);
@@ -114,6 +159,9 @@ void Manager::verify() {
 		box->addButton(
 			tr::lng_intro_verify_ok(),
 			[=] { showVerify(); });
+		box->addButton(
+			tr::lng_intro_verify_combine(),
+			[=] { showCombine(); });
 		box->addButton(
 			tr::lng_intro_verify_cancel(),
 			[=] { box->closeBox(); });
@@ -121,16 +169,60 @@ void Manager::verify() {
 }
 
 void Manager::showIntro() {
+	_withPassword = _withVanity = false;
 	_verifyLink->show(anim::type::normal);
+	_optionsLink->show(anim::type::normal);
 	showStep(std::make_unique<Intro>(), Direction::Forward, [=] {
-		_verifyLink->hide(anim::type::normal);
-		showRandomSeed();
+		startCreating();
 	});
 }
 
+void Manager::showOptions() {
+	_layerManager.showBox(Box([=](not_null<Ui::GenericBox*> box) {
+		Ui::InitMessageBox(
+			box,
+			tr::lng_options_title(),
+			tr::lng_options_text(Ui::Text::RichLangValue));
+		const auto password = box->addRow(object_ptr<Ui::Checkbox>(
+			box.get(),
+			tr::lng_options_password(tr::now),
+			_withPassword,
+			st::defaultCheckbox));
+		const auto vanity = box->addRow(object_ptr<Ui::Checkbox>(
+			box.get(),
+			tr::lng_options_vanity(tr::now),
+			_withVanity,
+			st::defaultCheckbox));
+		box->addButton(tr::lng_options_submit(), [=] {
+			_withPassword = password->checked();
+			_withVanity = vanity->checked();
+			startCreating();
+		});
+		box->addButton(tr::lng_options_cancel(), [=] { box->closeBox(); });
+	}));
+}
+
+void Manager::startCreating() {
+	hideIntroLinks();
+	if (_withPassword) {
+		showPassword();
+	} else if (_withVanity) {
+		showVanity();
+	} else {
+		showRandomSeed();
+	}
+}
+
+void Manager::hideIntroLinks() {
+	_verifyLink->hide(anim::type::normal);
+	_optionsLink->hide(anim::type::normal);
+}
+
 void Manager::showVerify() {
 	auto check = std::make_unique<Check>(
 		_wordsByPrefix,
+		[=](int index, const QString &word) { return _isValidWord(word); },
+		nullptr,
 		Check::Layout::Verifying);
 
 	const auto raw = check.get();
@@ -140,7 +232,10 @@ void Manager::showVerify() {
 		next();
 	}, raw->lifetime());
 
-	_verifyLink->hide(anim::type::normal);
+	raw->speculateRequests(
+	) | rpl::start_to_stream(_speculateRequests, raw->lifetime());
+
+	hideIntroLinks();
 	showStep(std::move(check), Direction::Forward, [=] {
 		if (raw->checkAll()) {
 			_verifyRequests.fire(raw->words());
@@ -150,6 +245,125 @@ void Manager::showVerify() {
 	});
 }
 
+void Manager::showVerifyPassword() {
+	_layerManager.showBox(Box([=](not_null<Ui::GenericBox*> box) {
+		Ui::InitMessageBox(
+			box,
+			tr::lng_verify_password_title(),
+			tr::lng_verify_password_text(Ui::Text::RichLangValue));
+		const auto field = box->addRow(object_ptr<Ui::PasswordInput>(
+			box.get(),
+			st::passwordField,
+			tr::lng_password_placeholder()));
+		const auto submit = [=] {
+			const auto password = field->getLastText();
+			if (password.isEmpty()) {
+				field->showError();
+				return;
+			}
+			box->closeBox();
+
+			// Set the password before the words are submitted again.
+			_passwordRequests.fire_copy(password);
+			next();
+		};
+		QObject::connect(field, &Ui::MaskedInputField::submitted, submit);
+		box->setFocusCallback([=] { field->setFocusFast(); });
+		box->addButton(tr::lng_verify_password_submit(), submit);
+		box->addButton(
+			tr::lng_verify_password_cancel(),
+			[=] { box->closeBox(); });
+
+		const auto weak = Ui::MakeWeak(_step->widget());
+		box->boxClosing(
+		) | rpl::filter([=] {
+			return weak != nullptr;
+		}) | rpl::start_with_next([=] {
+			_step->setFocus();
+		}, box->lifetime());
+	}));
+}
+
+void Manager::showPassword() {
+	auto password = std::make_unique<Password>();
+
+	const auto raw = password.get();
+
+	raw->submitRequests(
+	) | rpl::start_with_next([=] {
+		next();
+	}, raw->lifetime());
+
+	showStep(std::move(password), Direction::Forward, [=] {
+		if (raw->checkAll()) {
+			_passwordRequests.fire(raw->password());
+			if (_withVanity) {
+				showVanity();
+			} else {
+				showRandomSeed();
+			}
+		}
+	}, [=] {
+		_actionRequests.fire(Action::NewKey);
+	});
+}
+
+void Manager::showVanity() {
+	auto vanity = std::make_unique<Vanity>(_vanityChance);
+
+	const auto raw = vanity.get();
+
+	raw->submitRequests(
+	) | rpl::start_with_next([=] {
+		next();
+	}, raw->lifetime());
+
+	showStep(std::move(vanity), Direction::Forward, [=] {
+		if (raw->checkAll()) {
+			_vanityRequests.fire(raw->request());
+			showRandomSeed();
+		}
+	}, [=] {
+		_actionRequests.fire(Action::NewKey);
+	});
+}
+
+void Manager::showVanityProgress() {
+	_vanityProgress = tr::lng_vanity_progress_starting(tr::now);
+	_layerManager.showBox(Box([=](not_null<Ui::GenericBox*> box) {
+		auto text = _vanityProgress.value(
+		) | rpl::map([](const QString &text) {
+			return Ui::Text::WithEntities(text);
+		});
+		Ui::InitMessageBox(
+			box,
+			tr::lng_vanity_progress_title(),
+			std::move(text));
+		box->addButton(tr::lng_vanity_cancel(), [=] { box->closeBox(); });
+		box->boxClosing(
+		) | rpl::start_with_next([=] {
+			_actionRequests.fire(Action::CancelVanity);
+		}, box->lifetime());
+	}));
+}
+
+void Manager::setVanityProgress(
+		int64 keys,
+		int64 perSecond,
+		int64 expected) {
+	_vanityProgress = tr::lng_vanity_progress_text(
+		tr::now
+	).replace(
+		"{keys}",
+		QString::number(keys)
+	).replace(
+		"{speed}",
+		QString::number(perSecond)
+	).replace(
+		"{time}",
+		FormatVanityTime(expected));
+}
+
 void Manager::showRandomSeed() {
 	using namespace rpl::mappers;
 
@@ -194,6 +408,8 @@ void Manager::showWords(std::vector<QString> &&words, Direction direction) {
 void Manager::showCheck(Direction direction) {
 	auto check = std::make_unique<Check>(
 		_wordsByPrefix,
+		_isExpectedWord,
+		_isExpectedPrefix,
 		Check::Layout::Checking);
 
 	const auto raw = check.get();
@@ -203,6 +419,9 @@ void Manager::showCheck(Direction direction) {
 		next();
 	}, raw->lifetime());
 
+	raw->speculateRequests(
+	) | rpl::start_to_stream(_speculateRequests, raw->lifetime());
+
 	showStep(std::move(check), direction, [=] {
 		if (raw->checkAll()) {
 			_checkRequests.fire(raw->words());
@@ -246,6 +465,8 @@ void Manager::showCheckFail() {
 }
 
 void Manager::showVerifyDone(const QString &publicKey) {
+	// Combined shares skip the words step that hides the links.
+	hideIntroLinks();
 	showDone(publicKey);
 }
 
@@ -258,6 +479,7 @@ void Manager::showVerifyFail() {
 		box->addButton(
 			tr::lng_verify_bad_try_again(),
 			[=] { box->closeBox(); });
+		box->addButton(tr::lng_verify_bad_recover(), [=] { showRecovery(); });
 
 		const auto weak = Ui::MakeWeak(_step->widget());
 		box->boxClosing(
@@ -270,6 +492,158 @@ void Manager::showVerifyFail() {
 
 }
 
+void Manager::showRecovery() {
+	_layerManager.showBox(Box([=](not_null<Ui::GenericBox*> box) {
+		Ui::InitMessageBox(
+			box,
+			tr::lng_recovery_title(),
+			tr::lng_recovery_text(Ui::Text::RichLangValue));
+		const auto position = box->addRow(object_ptr<Ui::InputField>(
+			box.get(),
+			st::recoveryField,
+			tr::lng_recovery_position()));
+		const auto publicKey = box->addRow(object_ptr<Ui::InputField>(
+			box.get(),
+			st::recoveryField,
+			tr::lng_recovery_public_key()));
+		const auto password = box->addRow(object_ptr<Ui::PasswordInput>(
+			box.get(),
+			st::passwordField,
+			tr::lng_recovery_password()));
+		const auto submit = [=] {
+			auto request = RecoveryRequest();
+			const auto number = position->getLastText().trimmed();
+			if (!number.isEmpty()) {
+				auto ok = false;
+				const auto value = number.toInt(&ok);
+				if (!ok || value < 1 || value > kWordsCount) {
+					position->showError();
+					return;
+				}
+				request.position = value - 1;
+			}
+			request.publicKey = publicKey->getLastText().trimmed();
+			if (!request.publicKey.isEmpty()
+				&& request.publicKey.size() != kPublicKeyLength) {
+				publicKey->showError();
+				return;
+			}
+			request.password = password->getLastText();
+			_recoveryRequests.fire(std::move(request));
+		};
+		QObject::connect(position, &Ui::InputField::submitted, submit);
+		QObject::connect(publicKey, &Ui::InputField::submitted, submit);
+		QObject::connect(password, &Ui::MaskedInputField::submitted, submit);
+		box->setFocusCallback([=] { position->setFocusFast(); });
+		box->addButton(tr::lng_recovery_start(), submit);
+		box->addButton(tr::lng_recovery_cancel(), [=] { box->closeBox(); });
+	}));
+}
+
+void Manager::showRecoveryProgress() {
+	_recoveryProgress = 0;
+	_layerManager.showBox(Box([=](not_null<Ui::GenericBox*> box) {
+		auto text = rpl::combine(
+			tr::lng_recovery_progress_text(),
+			_recoveryProgress.value()
+		) | rpl::map([](QString phrase, int percent) {
+			return Ui::Text::WithEntities(phrase.replace(
+				"{percent}",
+				QString::number(percent)));
+		});
+		Ui::InitMessageBox(
+			box,
+			tr::lng_recovery_progress_title(),
+			std::move(text));
+		box->addButton(tr::lng_recovery_cancel(), [=] { box->closeBox(); });
+		box->boxClosing(
+		) | rpl::start_with_next([=] {
+			_actionRequests.fire(Action::CancelRecovery);
+		}, box->lifetime());
+	}));
+}
+
+void Manager::setRecoveryProgress(int percent) {
+	_recoveryProgress = percent;
+}
+
+void Manager::showRecoveryDone(std::vector<RecoveredWord> &&words) {
+	const auto describe = [](const RecoveredWord &recovered) {
+		return tr::lng_recovery_word(
+			tr::now
+		).replace(
+			"{index}",
+			QString::number(recovered.position + 1)
+		).replace(
+			"{word}",
+			recovered.word);
+	};
+	const auto count = int(words.size());
+	auto title = tr::lng_recovery_none_title(tr::now);
+	auto text = tr::lng_recovery_none_text(tr::now);
+	if (count == 1) {
+		title = tr::lng_recovery_found_title(tr::now);
+		text = tr::lng_recovery_found_text(
+			tr::now
+		).replace("{word}", describe(words.front()));
+	} else if (count > 1) {
+		title = tr::lng_recovery_many_title(tr::now);
+		text = tr::lng_recovery_many_text(
+			tr::now
+		).replace("{count}", QString::number(count));
+		if (count > kRecoveredShownMax) {
+			text.append("\n\n").append(tr::lng_recovery_many_shown(
+				tr::now
+			).replace("{shown}", QString::number(kRecoveredShownMax)));
+		}
+	}
+	const auto choices = ranges::view::all(
+		words
+	) | ranges::view::take(
+		(count > 1) ? kRecoveredShownMax : 0
+	) | ranges::view::transform([](const RecoveredWord &recovered) {
+		return tr::lng_recovery_choose(
+			tr::now
+		).replace(
+			"{index}",
+			QString::number(recovered.position + 1)
+		).replace(
+			"{word}",
+			recovered.word);
+	}) | ranges::to_vector;
+	_layerManager.showBox(Box([=](not_null<Ui::GenericBox*> box) {
+		Ui::InitMessageBox(
+			box,
+			rpl::single(title),
+			rpl::single(Ui::Text::RichLangValue(text)));
+		for (auto i = 0; i != int(choices.size()); ++i) {
+			const auto choice = box->addRow(object_ptr<Ui::LinkButton>(
+				box.get(),
+				choices[i],
+				st::recoveryChoice));
+			choice->setClickedCallback([=] { _recoveredChoices.fire_copy(i); });
+		}
+		if (count == 1) {
+			box->addButton(
+				tr::lng_recovery_found_use(),
+				[=] { _recoveredChoices.fire(0); });
+		} else if (count > 1) {
+			box->addButton(
+				tr::lng_recovery_many_retry(),
+				[=] { showRecovery(); });
+		}
+		box->addButton(tr::lng_recovery_close(), [=] { box->closeBox(); });
+
+		const auto weak = Ui::MakeWeak(_step->widget());
+		box->boxClosing(
+		) | rpl::filter([=] {
+			return weak != nullptr;
+		}) | rpl::start_with_next([=] {
+			_step->setFocus();
+		}, box->lifetime());
+	}));
+}
+
 void Manager::showDone(const QString &publicKey) {
 	auto done = std::make_unique<Done>(publicKey);
 	done->copyKeyRequests(
@@ -288,6 +662,18 @@ void Manager::showDone(const QString &publicKey) {
 	) | rpl::start_with_next([=] {
 		showCheck(Direction::Backward);
 	}, done->lifetime());
+	done->addressesRequests(
+	) | rpl::map([] {
+		return Action::ShowAddresses;
+	}) | rpl::start_to_stream(_actionRequests, done->lifetime());
+	done->splitRequests(
+	) | rpl::start_with_next([=] {
+		showSplit();
+	}, done->lifetime());
+	done->keystoreRequests(
+	) | rpl::start_with_next([=] {
+		showKeystore();
+	}, done->lifetime());
 	showStep(std::move(done), Direction::Forward);
 }
 
@@ -295,9 +681,218 @@ void Manager::showCopyKeyDone() {
 	Ui::Toast::Show(_content.get(), tr::lng_done_to_clipboard(tr::now));
 }
 
+void Manager::showAddresses(std::vector<WalletAddress> &&addresses) {
+	auto text = QString();
+	for (const auto &[title, address] : addresses) {
+		if (!text.isEmpty()) {
+			text.append("\n\n");
+		}
+		text.append(title).append(":\n").append(address);
+	}
+	_layerManager.showBox(Box([=](not_null<Ui::GenericBox*> box) {
+		Ui::InitMessageBox(
+			box,
+			tr::lng_addresses_title(),
+			rpl::single(Ui::Text::WithEntities(text)));
+		box->addButton(tr::lng_addresses_copy(), [=] {
+			_actionRequests.fire(Action::CopyAddresses);
+		});
+		box->addButton(tr::lng_addresses_close(), [=] { box->closeBox(); });
+	}));
+}
+
+void Manager::showCopyAddressesDone() {
+	Ui::Toast::Show(
+		_content.get(),
+		tr::lng_addresses_to_clipboard(tr::now));
+}
+
+void Manager::showSplit() {
+	_layerManager.showBox(Box([=](not_null<Ui::GenericBox*> box) {
+		Ui::InitMessageBox(
+			box,
+			tr::lng_split_title(),
+			tr::lng_split_text(Ui::Text::RichLangValue));
+		const auto threshold = box->addRow(object_ptr<Ui::InputField>(
+			box.get(),
+			st::recoveryField,
+			tr::lng_split_threshold()));
+		const auto count = box->addRow(object_ptr<Ui::InputField>(
+			box.get(),
+			st::recoveryField,
+			tr::lng_split_count()));
+		const auto number = [](not_null<Ui::InputField*> field, int min) {
+			auto ok = false;
+			const auto value = field->getLastText().trimmed().toInt(&ok);
+			return (ok && value >= min && value <= kSharesMax) ? value : 0;
+		};
+		const auto submit = [=] {
+			auto request = SplitRequest();
+			request.threshold = number(threshold, 2);
+			request.count = number(count, std::max(request.threshold, 2));
+			if (!request.threshold) {
+				threshold->showError();
+				return;
+			} else if (!request.count) {
+				count->showError();
+				return;
+			}
+			_splitRequests.fire_copy(request);
+		};
+		QObject::connect(threshold, &Ui::InputField::submitted, submit);
+		QObject::connect(count, &Ui::InputField::submitted, submit);
+		box->setFocusCallback([=] { threshold->setFocusFast(); });
+		box->addButton(tr::lng_split_submit(), submit);
+		box->addButton(tr::lng_split_cancel(), [=] { box->closeBox(); });
+	}));
+}
+
+void Manager::showShares(std::vector<QString> &&shares, int threshold) {
+	auto text = tr::lng_shares_about(
+		tr::now
+	).replace(
+		"{threshold}",
+		QString::number(threshold)
+	).replace(
+		"{count}",
+		QString::number(shares.size()));
+	for (auto i = 0; i != int(shares.size()); ++i) {
+		text.append("\n\n").append(tr::lng_shares_share(
+			tr::now
+		).replace(
+			"{index}",
+			QString::number(i + 1)
+		)).append(":\n").append(shares[i]);
+	}
+	_layerManager.showBox(Box([=](not_null<Ui::GenericBox*> box) {
+		Ui::InitMessageBox(
+			box,
+			tr::lng_shares_title(),
+			rpl::single(Ui::Text::WithEntities(text)));
+		box->addButton(tr::lng_shares_copy(), [=] {
+			_actionRequests.fire(Action::CopyShares);
+		});
+		box->addButton(tr::lng_shares_close(), [=] { box->closeBox(); });
+	}));
+}
+
+void Manager::showCopySharesDone() {
+	Ui::Toast::Show(_content.get(), tr::lng_shares_to_clipboard(tr::now));
+}
+
+void Manager::showCombine() {
+	_layerManager.showBox(Box([=](not_null<Ui::GenericBox*> box) {
+		Ui::InitMessageBox(
+			box,
+			tr::lng_combine_title(),
+			tr::lng_combine_text(Ui::Text::RichLangValue));
+		const auto shares = box->addRow(object_ptr<Ui::InputField>(
+			box.get(),
+			st::sharesField,
+			Ui::InputField::Mode::MultiLine,
+			tr::lng_combine_shares()));
+		const auto password = box->addRow(object_ptr<Ui::PasswordInput>(
+			box.get(),
+			st::passwordField,
+			tr::lng_combine_password()));
+		const auto submit = [=] {
+			auto request = CombineRequest();
+			const auto lines = shares->getLastText().split('\n');
+			for (const auto &line : lines) {
+				if (!line.trimmed().isEmpty()) {
+					request.shares.push_back(line.trimmed());
+				}
+			}
+			if (request.shares.empty()) {
+				shares->showError();
+				return;
+			}
+			request.password = password->getLastText();
+			_combineRequests.fire(std::move(request));
+		};
+		QObject::connect(shares, &Ui::InputField::submitted, submit);
+		QObject::connect(password, &Ui::MaskedInputField::submitted, submit);
+		box->setFocusCallback([=] { shares->setFocusFast(); });
+
+		// The box stays open, so that the typed shares may be fixed.
+		_combineErrors.events(
+		) | rpl::start_with_next([=](const QString &text) {
+			shares->showError();
+			Ui::Toast::Show(_content.get(), text);
+		}, box->lifetime());
+		box->addButton(tr::lng_combine_submit(), submit);
+		box->addButton(tr::lng_combine_cancel(), [=] { box->closeBox(); });
+	}));
+}
+
+void Manager::showCombineFail(const QString &text) {
+	_combineErrors.fire_copy(text);
+}
+
+void Manager::showKeystore() {
+	_layerManager.showBox(Box([=](not_null<Ui::GenericBox*> box) {
+		Ui::InitMessageBox(
+			box,
+			tr::lng_keystore_title(),
+			tr::lng_keystore_text(Ui::Text::RichLangValue));
+		const auto passphrase = box->addRow(object_ptr<Ui::PasswordInput>(
+			box.get(),
+			st::passwordField,
+			tr::lng_keystore_passphrase()));
+		const auto repeat = box->addRow(object_ptr<Ui::PasswordInput>(
+			box.get(),
+			st::passwordField,
+			tr::lng_keystore_repeat()));
+		const auto submit = [=] {
+			const auto value = passphrase->getLastText();
+			if (value.isEmpty()) {
+				passphrase->showError();
+				return;
+			} else if (repeat->getLastText() != value) {
+				repeat->showError();
+				return;
+			}
+			_keystoreRequests.fire_copy(value);
+		};
+		QObject::connect(passphrase, &Ui::MaskedInputField::submitted, [=] {
+			repeat->setFocus();
+		});
+		QObject::connect(repeat, &Ui::MaskedInputField::submitted, submit);
+		box->setFocusCallback([=] { passphrase->setFocusFast(); });
+		box->addButton(tr::lng_keystore_submit(), submit);
+		box->addButton(tr::lng_keystore_cancel(), [=] { box->closeBox(); });
+	}));
+}
+
+void Manager::showKeystoreProgress() {
+	_layerManager.showBox(Box([=](not_null<Ui::GenericBox*> box) {
+		Ui::InitMessageBox(
+			box,
+			tr::lng_keystore_progress_title(),
+			tr::lng_keystore_progress_text(Ui::Text::WithEntities));
+		box->addButton(tr::lng_keystore_cancel(), [=] { box->closeBox(); });
+		box->boxClosing(
+		) | rpl::start_with_next([=] {
+			_actionRequests.fire(Action::CancelKeystore);
+		}, box->lifetime());
+	}));
+}
+
+void Manager::hideKeystoreProgress() {
+	_layerManager.hideAll();
+}
+
 void Manager::showSaveKeyDone(const QString &path) {
+	showSavedToFile(tr::lng_done_to_file(tr::now), path);
+}
+
+void Manager::showSaveKeystoreDone(const QString &path) {
+	showSavedToFile(tr::lng_keystore_to_file(tr::now), path);
+}
+
+void Manager::showSavedToFile(const QString &text, const QString &path) {
 	auto config = Ui::Toast::Config();
-	config.text = tr::lng_done_to_file(tr::now);
+	config.text = text;
 	config.durationMs = kSaveKeyDoneDuration;
 	Ui::Toast::Show(_content.get(), config);
 	const auto delay = st::toastFadeInDuration
@@ -356,11 +951,13 @@ void Manager::showStep(
 	if (!step) {
 		_nextButton->finishAnimating();
 		_verifyLink->finishAnimating();
+		_optionsLink->finishAnimating();
 		_nextButtonShown.stop();
 	}
 	_backButton->toggle(_back != nullptr, anim::type::normal);
 	_nextButton->raise();
 	_verifyLink->raise();
+	_optionsLink->raise();
 	_backButton->raise();
 	_layerManager.raise();
 
@@ -407,6 +1004,9 @@ void Manager::moveNextButton() {
 	_verifyLink->move(
 		(_content->width() - _verifyLink->width()) / 2,
 		_nextButton->y() + _nextButton->height() + st::verifyLinkTop);
+	_optionsLink->move(
+		(_content->width() - _optionsLink->width()) / 2,
+		_verifyLink->y() + _verifyLink->height() + st::optionsLinkTop);
 }
 
 void Manager::confirmNewKey() {
@@ -422,6 +1022,14 @@ void Manager::confirmNewKey() {
 	}));
 }
 
+rpl::producer<QString> Manager::passwordRequests() const {
+	return _passwordRequests.events();
+}
+
+rpl::producer<VanityRequest> Manager::vanityRequests() const {
+	return _vanityRequests.events();
+}
+
 rpl::producer<QByteArray> Manager::generateRequests() const {
 	return _generateRequests.events();
 }
@@ -434,6 +1042,30 @@ rpl::producer<std::vector<QString>> Manager::verifyRequests() const {
 	return _verifyRequests.events();
 }
 
+rpl::producer<std::vector<QString>> Manager::speculateRequests() const {
+	return _speculateRequests.events();
+}
+
+rpl::producer<RecoveryRequest> Manager::recoveryRequests() const {
+	return _recoveryRequests.events();
+}
+
+rpl::producer<SplitRequest> Manager::splitRequests() const {
+	return _splitRequests.events();
+}
+
+rpl::producer<CombineRequest> Manager::combineRequests() const {
+	return _combineRequests.events();
+}
+
+rpl::producer<QString> Manager::keystoreRequests() const {
+	return _keystoreRequests.events();
+}
+
+rpl::producer<int> Manager::recoveredChoices() const {
+	return _recoveredChoices.events();
+}
+
 rpl::producer<Manager::Action> Manager::actionRequests() const {
 	return _actionRequests.events();
 }
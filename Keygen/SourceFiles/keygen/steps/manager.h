@@ -7,6 +7,8 @@
 #pragma once
 
 #include "keygen/steps/step.h"
+#include "keygen/steps/vanity.h"
+#include "keygen/word_index.h"
 #include "ui/effects/animations.h"
 #include "ui/layers/layer_manager.h"
 #include "base/unique_qptr.h"
@@ -22,24 +24,76 @@ class FadeWrap;
 
 namespace Keygen::Steps {
 
+// Which word of the failed list to recover and how to confirm it.
+struct RecoveryRequest {
+	int position = -1; // Any word, if not set.
+	QString publicKey;
+	QString password;
+};
+
+struct RecoveredWord {
+	int position = 0;
+	QString word;
+	QString publicKey;
+};
+
+struct WalletAddress {
+	QString title;
+	QString address;
+};
+
+struct SplitRequest {
+	int threshold = 0;
+	int count = 0;
+};
+
+// The shares as typed, one share of words on each line.
+struct CombineRequest {
+	std::vector<QString> shares;
+	QString password;
+};
+
 class Manager final {
 public:
-	explicit Manager(Fn<std::vector<QString>(QString)> wordsByPrefix);
+	Manager(
+		Fn<WordsRange(QString)> wordsByPrefix,
+		Fn<bool(QString)> isValidWord,
+		Fn<bool(int, QString)> isExpectedWord,
+		Fn<bool(int, QString)> isExpectedPrefix,
+		Fn<double(VanityRequest)> vanityChance);
 	Manager(const Manager &other) = delete;
 	Manager &operator=(const Manager &other) = delete;
 	~Manager();
 
 	[[nodiscard]] not_null<Ui::RpWidget*> content() const;
 
+	[[nodiscard]] rpl::producer<QString> passwordRequests() const;
+	[[nodiscard]] rpl::producer<VanityRequest> vanityRequests() const;
 	[[nodiscard]] rpl::producer<QByteArray> generateRequests() const;
 	[[nodiscard]] rpl::producer<std::vector<QString>> checkRequests() const;
 	[[nodiscard]] rpl::producer<std::vector<QString>> verifyRequests() const;
+	[[nodiscard]] rpl::producer<std::vector<QString>> speculateRequests() const;
+	[[nodiscard]] rpl::producer<RecoveryRequest> recoveryRequests() const;
+	[[nodiscard]] rpl::producer<SplitRequest> splitRequests() const;
+	[[nodiscard]] rpl::producer<CombineRequest> combineRequests() const;
+
+	// Passphrases to encrypt the secret words with.
+	[[nodiscard]] rpl::producer<QString> keystoreRequests() const;
+
+	// Index of the recovered list the user decided to use.
+	[[nodiscard]] rpl::producer<int> recoveredChoices() const;
 
 	enum class Action {
 		ShowWordsBack,
 		CopyKey,
 		SaveKey,
 		NewKey,
+		CancelRecovery,
+		CancelVanity,
+		ShowAddresses,
+		CopyAddresses,
+		CopyShares,
+		CancelKeystore,
 	};
 
 	[[nodiscard]] rpl::producer<Action> actionRequests() const;
@@ -51,6 +105,11 @@ public:
 
 	void showIntro();
 	void showVerify();
+	void showVerifyPassword();
+	void showPassword();
+	void showVanity();
+	void showVanityProgress();
+	void setVanityProgress(int64 keys, int64 perSecond, int64 expected);
 	void showRandomSeed();
 	void showCreated(std::vector<QString> &&words);
 	void showWords(std::vector<QString> &&words, Direction direction);
@@ -59,9 +118,24 @@ public:
 	void showCheckFail();
 	void showVerifyDone(const QString &publicKey);
 	void showVerifyFail();
+	void showRecovery();
+	void showRecoveryProgress();
+	void setRecoveryProgress(int percent);
+	void showRecoveryDone(std::vector<RecoveredWord> &&words);
 	void showDone(const QString &publicKey);
 	void showCopyKeyDone();
+	void showAddresses(std::vector<WalletAddress> &&addresses);
+	void showCopyAddressesDone();
+	void showSplit();
+	void showShares(std::vector<QString> &&shares, int threshold);
+	void showCopySharesDone();
+	void showCombine();
+	void showCombineFail(const QString &text);
+	void showKeystore();
+	void showKeystoreProgress();
+	void hideKeystoreProgress();
 	void showSaveKeyDone(const QString &path);
+	void showSaveKeystoreDone(const QString &path);
 	void showSaveKeyFail();
 	void showError(const QString &text);
 
@@ -72,27 +146,51 @@ private:
 		FnMut<void()> next = nullptr,
 		FnMut<void()> back = nullptr);
 	void confirmNewKey();
+	void showOptions();
+	void startCreating();
+	void hideIntroLinks();
+	void showSavedToFile(const QString &text, const QString &path);
 	void initButtons();
 	void moveNextButton();
 
 	const std::unique_ptr<Ui::RpWidget> _content;
 	const base::unique_qptr<Ui::FadeWrap<Ui::RoundButton>> _nextButton;
 	const base::unique_qptr<Ui::FadeWrap<Ui::LinkButton>> _verifyLink;
+	const base::unique_qptr<Ui::FadeWrap<Ui::LinkButton>> _optionsLink;
 	const base::unique_qptr<Ui::FadeWrap<Ui::IconButton>> _backButton;
 	Ui::Animations::Simple _nextButtonShown;
 	NextButtonState _lastNextState;
 	Ui::LayerManager _layerManager;
 
-	const Fn<std::vector<QString>(QString)> _wordsByPrefix;
+	const Fn<WordsRange(QString)> _wordsByPrefix;
+	const Fn<bool(QString)> _isValidWord;
+	const Fn<bool(int, QString)> _isExpectedWord;
+	const Fn<bool(int, QString)> _isExpectedPrefix;
+	const Fn<double(VanityRequest)> _vanityChance;
 
 	std::unique_ptr<Step> _step;
 
+	// The password and vanity steps are shown only if chosen in options.
+	bool _withPassword = false;
+	bool _withVanity = false;
+
 	FnMut<void()> _next;
 	FnMut<void()> _back;
 
+	rpl::event_stream<QString> _passwordRequests;
+	rpl::event_stream<VanityRequest> _vanityRequests;
 	rpl::event_stream<QByteArray> _generateRequests;
 	rpl::event_stream<std::vector<QString>> _checkRequests;
 	rpl::event_stream<std::vector<QString>> _verifyRequests;
+	rpl::event_stream<std::vector<QString>> _speculateRequests;
+	rpl::event_stream<RecoveryRequest> _recoveryRequests;
+	rpl::event_stream<SplitRequest> _splitRequests;
+	rpl::event_stream<CombineRequest> _combineRequests;
+	rpl::event_stream<QString> _combineErrors;
+	rpl::event_stream<QString> _keystoreRequests;
+	rpl::event_stream<int> _recoveredChoices;
+	rpl::variable<int> _recoveryProgress = 0;
+	rpl::variable<QString> _vanityProgress;
 	rpl::event_stream<Action> _actionRequests;
 
 };
@@ -0,0 +1,81 @@
+// This file is part of TON Key Generator,
+// a desktop application for the TON Blockchain project.
+//
+// For license and copyright information please follow this link:
+// https://github.com/ton-blockchain/tonkeygen/blob/master/LEGAL
+//
+#include "keygen/steps/password.h"
+
+#include "keygen/phrases.h"
+#include "ui/rp_widget.h"
+#include "ui/widgets/input_fields.h"
+#include "ui/text/text_utilities.h"
+#include "styles/style_keygen.h"
+
+namespace Keygen::Steps {
+
+Password::Password() : Step(Type::Default) {
+	setTitle(tr::lng_password_title(Ui::Text::RichLangValue));
+	setDescription(tr::lng_password_description(Ui::Text::RichLangValue));
+	initControls();
+}
+
+QString Password::password() const {
+	return _password->getLastText();
+}
+
+rpl::producer<> Password::submitRequests() const {
+	return _submitRequests.events();
+}
+
+void Password::setFocus() {
+	_password->setFocusFast();
+}
+
+bool Password::checkAll() {
+	if (_repeat->getLastText() != _password->getLastText()) {
+		_repeat->showError();
+		return false;
+	}
+	return true;
+}
+
+void Password::initControls() {
+	_password = Ui::CreateChild<Ui::PasswordInput>(
+		inner().get(),
+		st::passwordField,
+		tr::lng_password_placeholder());
+	_repeat = Ui::CreateChild<Ui::PasswordInput>(
+		inner().get(),
+		st::passwordField,
+		tr::lng_password_repeat());
+
+	QObject::connect(_password, &Ui::MaskedInputField::submitted, [=] {
+		_repeat->setFocus();
+	});
+	QObject::connect(_repeat, &Ui::MaskedInputField::submitted, [=] {
+		_submitRequests.fire({});
+	});
+
+	inner()->sizeValue(
+	) | rpl::start_with_next([=](QSize size) {
+		const auto left = (size.width() - st::passwordField.width) / 2;
+		const auto top = contentTop() + st::passwordTop;
+		_password->setGeometry(
+			left,
+			top,
+			st::passwordField.width,
+			_password->height());
+		_repeat->setGeometry(
+			left,
+			top + _password->height() + st::passwordSkip,
+			st::passwordField.width,
+			_repeat->height());
+
+		auto state = NextButtonState();
+		state.text = tr::lng_password_next(tr::now);
+		requestNextButton(state);
+	}, inner()->lifetime());
+}
+
+} // namespace Keygen::Steps
@@ -0,0 +1,38 @@
+// This file is part of TON Key Generator,
+// a desktop application for the TON Blockchain project.
+//
+// For license and copyright information please follow this link:
+// https://github.com/ton-blockchain/tonkeygen/blob/master/LEGAL
+//
+#pragma once
+
+#include "keygen/steps/step.h"
+
+namespace Ui {
+class PasswordInput;
+} // namespace Ui
+
+namespace Keygen::Steps {
+
+// Optional password for the new key, empty fields mean no password.
+class Password final : public Step {
+public:
+	Password();
+
+	[[nodiscard]] QString password() const;
+	[[nodiscard]] rpl::producer<> submitRequests() const;
+
+	void setFocus() override;
+	bool checkAll();
+
+private:
+	void initControls();
+
+	Ui::PasswordInput *_password = nullptr;
+	Ui::PasswordInput *_repeat = nullptr;
+
+	rpl::event_stream<> _submitRequests;
+
+};
+
+} // namespace Keygen::Steps
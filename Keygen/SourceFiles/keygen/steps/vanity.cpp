@@ -0,0 +1,87 @@
+// This file is part of TON Key Generator,
+// a desktop application for the TON Blockchain project.
+//
+// For license and copyright information please follow this link:
+// https://github.com/ton-blockchain/tonkeygen/blob/master/LEGAL
+//
+#include "keygen/steps/vanity.h"
+
+#include "keygen/phrases.h"
+#include "ui/rp_widget.h"
+#include "ui/widgets/checkbox.h"
+#include "ui/widgets/input_fields.h"
+#include "ui/text/text_utilities.h"
+#include "styles/style_keygen.h"
+
+namespace Keygen::Steps {
+
+Vanity::Vanity(Fn<double(VanityRequest)> patternChance)
+: Step(Type::Default)
+, _patternChance(std::move(patternChance)) {
+	setTitle(tr::lng_vanity_title(Ui::Text::RichLangValue));
+	setDescription(tr::lng_vanity_description(Ui::Text::RichLangValue));
+	initControls();
+}
+
+VanityRequest Vanity::request() const {
+	auto result = VanityRequest();
+	result.pattern = _pattern->getLastText().trimmed();
+	result.target = _address->checked()
+		? VanityTarget::WalletAddress
+		: VanityTarget::PublicKey;
+	return result;
+}
+
+rpl::producer<> Vanity::submitRequests() const {
+	return _submitRequests.events();
+}
+
+void Vanity::setFocus() {
+	_pattern->setFocusFast();
+}
+
+bool Vanity::checkAll() {
+	const auto current = request();
+	if (!current.pattern.isEmpty() && _patternChance(current) <= 0.) {
+		_pattern->showError();
+		return false;
+	}
+	return true;
+}
+
+void Vanity::initControls() {
+	_address = Ui::CreateChild<Ui::Checkbox>(
+		inner().get(),
+		tr::lng_vanity_address(tr::now),
+		false,
+		st::defaultCheckbox);
+	_pattern = Ui::CreateChild<Ui::InputField>(
+		inner().get(),
+		st::vanityField,
+		rpl::conditional(
+			_address->checkedValue(),
+			tr::lng_vanity_address_placeholder(),
+			tr::lng_vanity_placeholder()));
+
+	QObject::connect(_pattern, &Ui::InputField::submitted, [=] {
+		_submitRequests.fire({});
+	});
+
+	inner()->sizeValue(
+	) | rpl::start_with_next([=](QSize size) {
+		_pattern->setGeometry(
+			(size.width() - st::vanityField.width) / 2,
+			contentTop() + st::vanityTop,
+			st::vanityField.width,
+			_pattern->height());
+		_address->move(
+			(size.width() - st::vanityField.width) / 2,
+			_pattern->y() + _pattern->height() + st::vanityAddressTop);
+
+		auto state = NextButtonState();
+		state.text = tr::lng_vanity_next(tr::now);
+		requestNextButton(state);
+	}, inner()->lifetime());
+}
+
+} // namespace Keygen::Steps
@@ -0,0 +1,51 @@
+// This file is part of TON Key Generator,
+// a desktop application for the TON Blockchain project.
+//
+// For license and copyright information please follow this link:
+// https://github.com/ton-blockchain/tonkeygen/blob/master/LEGAL
+//
+#pragma once
+
+#include "keygen/steps/step.h"
+
+namespace Ui {
+class InputField;
+class Checkbox;
+} // namespace Ui
+
+namespace Keygen::Steps {
+
+enum class VanityTarget {
+	PublicKey,
+	WalletAddress, // The first one shown: v3R2 in the basechain.
+};
+
+// Optional characters the public key or the wallet address should start
+// with, empty pattern means any key will do.
+struct VanityRequest {
+	QString pattern;
+	VanityTarget target = VanityTarget::PublicKey;
+};
+
+class Vanity final : public Step {
+public:
+	explicit Vanity(Fn<double(VanityRequest)> patternChance);
+
+	[[nodiscard]] VanityRequest request() const;
+	[[nodiscard]] rpl::producer<> submitRequests() const;
+
+	void setFocus() override;
+	bool checkAll();
+
+private:
+	void initControls();
+
+	const Fn<double(VanityRequest)> _patternChance;
+	Ui::InputField *_pattern = nullptr;
+	Ui::Checkbox *_address = nullptr;
+
+	rpl::event_stream<> _submitRequests;
+
+};
+
+} // namespace Keygen::Steps
@@ -8,41 +8,11 @@
 
 #include "keygen/phrases.h"
 #include "ui/rp_widget.h"
-#include "ui/widgets/labels.h"
 #include "ui/text/text_utilities.h"
+#include "ui/words_grid.h"
 #include "styles/style_keygen.h"
 
 namespace Keygen::Steps {
-namespace {
-
-class Word final {
-public:
-	Word(not_null<QWidget*> parent, int index, const QString &word);
-
-	void move(int left, int top) const;
-	[[nodiscard]] int top() const;
-
-private:
-	object_ptr<Ui::FlatLabel> _index;
-	object_ptr<Ui::FlatLabel> _word;
-
-};
-
-Word::Word(not_null<QWidget*> parent, int index, const QString &word)
-: _index(parent, QString::number(index + 1) + '.', st::wordIndexLabel)
-, _word(parent, word, st::wordLabel) {
-}
-
-void Word::move(int left, int top) const {
-	_index->move(left - _index->width() - st::wordIndexSkip, top);
-	_word->move(left, top);
-}
-
-int Word::top() const {
-	return _index->y();
-}
-
-} // namespace
 
 View::View(std::vector<QString> &&words) : Step(Type::Scroll) {
 	setTitle(tr::lng_view_title(Ui::Text::RichLangValue));
@@ -57,26 +27,17 @@ int View::desiredHeight() const {
 void View::initControls(std::vector<QString> &&words) {
 	Expects(words.size() % 2 == 0);
 
-	auto labels = std::make_shared<std::vector<std::pair<Word, Word>>>();
+	const auto grid = Ui::CreateWordsGrid(inner(), words);
 	const auto rows = words.size() / 2;
-	for (auto i = 0; i != rows; ++i) {
-		labels->emplace_back(
-			Word(inner(), i, words[i]),
-			Word(inner(), i + rows, words[i + rows]));
-	}
 	const auto rowsBottom = st::wordsTop + rows * st::wordHeight;
 
 	inner()->sizeValue(
 	) | rpl::start_with_next([=](QSize size) {
-		const auto half = size.width() / 2;
-		const auto left = half - st::wordSkipLeft;
-		const auto right = half + st::wordSkipRight;
-		auto top = contentTop() + st::wordsTop;
-		for (const auto &pair : *labels) {
-			pair.first.move(left, top);
-			pair.second.move(right, top);
-			top += st::wordHeight;
-		}
+		grid->setGeometry(
+			0,
+			contentTop() + st::wordsTop,
+			size.width(),
+			grid->height());
 
 		auto state = NextButtonState();
 		state.text = tr::lng_view_next(tr::now);
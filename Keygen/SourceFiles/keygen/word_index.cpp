@@ -0,0 +1,195 @@
+// This file is part of TON Key Generator,
+// a desktop application for the TON Blockchain project.
+//
+// For license and copyright information please follow this link:
+// https://github.com/ton-blockchain/tonkeygen/blob/master/LEGAL
+//
+#include "keygen/word_index.h"
+
+namespace Keygen {
+namespace {
+
+constexpr auto kLetters = 26;
+constexpr auto kTableDepth = 3;
+
+// Offsets of the one, two and three letter prefixes in the ranges table.
+constexpr auto kTableOffsets = std::array<int, kTableDepth + 1>{
+	0,
+	kLetters,
+	kLetters + kLetters * kLetters,
+	kLetters + kLetters * kLetters + kLetters * kLetters * kLetters,
+};
+
+[[nodiscard]] ushort Lower(QChar ch) {
+	return ch.toLower().unicode();
+}
+
+template <typename String>
+[[nodiscard]] int TableIndex(const String &word, int length) {
+	Expects(length > 0 && length <= kTableDepth && length <= word.size());
+
+	auto result = 0;
+	for (auto i = 0; i != length; ++i) {
+		const auto ch = Lower(QChar(word[i]));
+		if (ch < 'a' || ch > 'z') {
+			return -1;
+		}
+		result = result * kLetters + (ch - 'a');
+	}
+	return kTableOffsets[length - 1] + result;
+}
+
+// Zero if word starts with prefix, otherwise the sign of (word - prefix).
+[[nodiscard]] int ComparePrefix(QLatin1String word, QStringRef prefix) {
+	const auto length = std::min(word.size(), prefix.size());
+	for (auto i = 0; i != length; ++i) {
+		const auto a = ushort(uchar(word.data()[i]));
+		const auto b = Lower(prefix[i]);
+		if (a != b) {
+			return (a < b) ? -1 : 1;
+		}
+	}
+	return (word.size() < prefix.size()) ? -1 : 0;
+}
+
+template <typename Predicate>
+[[nodiscard]] int PartitionPoint(int from, int till, Predicate &&predicate) {
+	while (from < till) {
+		const auto middle = from + (till - from) / 2;
+		if (predicate(middle)) {
+			from = middle + 1;
+		} else {
+			till = middle;
+		}
+	}
+	return from;
+}
+
+} // namespace
+
+int WordsRange::wordIndex(int position) const {
+	Expects(position >= 0 && position < size());
+
+	return ranked ? indices[from + position] : (from + position);
+}
+
+QLatin1String WordsRange::word(int position) const {
+	Expects(index != nullptr);
+
+	return index->word(wordIndex(position));
+}
+
+const QString &WordsRange::text(int position) const {
+	Expects(index != nullptr);
+
+	return index->text(wordIndex(position));
+}
+
+WordIndex::WordIndex(const base::flat_set<QString> &words)
+: _ranges(kTableOffsets.back()) {
+	_offsets.reserve(words.size() + 1);
+	_texts.reserve(words.size());
+	for (const auto &word : words) {
+		_offsets.push_back(_arena.size());
+		_arena.append(word.toLatin1());
+		_texts.push_back(word);
+	}
+	_offsets.push_back(_arena.size());
+
+	const auto count = size();
+	for (auto i = 0; i != count; ++i) {
+		const auto entry = word(i);
+		const auto depth = std::min(entry.size(), kTableDepth);
+		for (auto length = 1; length <= depth; ++length) {
+			const auto index = TableIndex(entry, length);
+			if (index < 0) {
+				break;
+			}
+			auto &range = _ranges[index];
+			if (range.till <= range.from) {
+				range.from = i;
+			}
+			range.till = i + 1;
+		}
+	}
+}
+
+bool WordIndex::empty() const {
+	return _texts.empty();
+}
+
+int WordIndex::size() const {
+	return int(_texts.size());
+}
+
+std::vector<QByteArray> WordIndex::list() const {
+	auto result = std::vector<QByteArray>();
+	result.reserve(size());
+	for (auto i = 0; i != size(); ++i) {
+		const auto from = _offsets[i];
+		result.push_back(_arena.mid(from, _offsets[i + 1] - from));
+	}
+	return result;
+}
+
+QLatin1String WordIndex::word(int index) const {
+	Expects(index >= 0 && index < size());
+
+	const auto from = _offsets[index];
+	return QLatin1String(
+		_arena.constData() + from,
+		_offsets[index + 1] - from);
+}
+
+const QString &WordIndex::text(int index) const {
+	Expects(index >= 0 && index < size());
+
+	return _texts[index];
+}
+
+WordsRange WordIndex::byPrefix(QStringRef prefix) const {
+	_counters.lookups.fetch_add(1, std::memory_order_relaxed);
+
+	const auto length = prefix.size();
+	if (!length) {
+		return { this, 0, size() };
+	}
+	const auto index = TableIndex(prefix, std::min(length, kTableDepth));
+	const auto range = (index < 0)
+		? searchRange({ 0, size() }, prefix)
+		: (length <= kTableDepth)
+		? _ranges[index]
+		: searchRange(_ranges[index], prefix);
+	return { this, range.from, range.till };
+}
+
+WordsRange WordIndex::narrow(WordsRange range, QStringRef prefix) const {
+	Expects(range.index == this);
+	Expects(!range.ranked);
+
+	_counters.narrowings.fetch_add(1, std::memory_order_relaxed);
+
+	const auto result = searchRange({ range.from, range.till }, prefix);
+	return { this, result.from, result.till };
+}
+
+WordIndex::Range WordIndex::searchRange(
+		Range range,
+		QStringRef prefix) const {
+	const auto from = PartitionPoint(range.from, range.till, [&](int i) {
+		return ComparePrefix(word(i), prefix) < 0;
+	});
+	const auto till = PartitionPoint(from, range.till, [&](int i) {
+		return ComparePrefix(word(i), prefix) == 0;
+	});
+	return { from, till };
+}
+
+WordIndex::Stats WordIndex::stats() const {
+	auto result = Stats();
+	result.lookups = _counters.lookups.load(std::memory_order_relaxed);
+	result.narrowings = _counters.narrowings.load(std::memory_order_relaxed);
+	return result;
+}
+
+} // namespace Keygen
@@ -0,0 +1,110 @@
+// This file is part of TON Key Generator,
+// a desktop application for the TON Blockchain project.
+//
+// For license and copyright information please follow this link:
+// https://github.com/ton-blockchain/tonkeygen/blob/master/LEGAL
+//
+#pragma once
+
+namespace Keygen {
+
+class WordIndex;
+
+// A lightweight view of consecutive words in a WordIndex.
+struct WordsRange {
+	static constexpr auto kMaxRanked = 8;
+
+	const WordIndex *index = nullptr;
+	int from = 0;
+	int till = 0;
+
+	// Fuzzy matches are not consecutive, they keep their indices here.
+	bool ranked = false;
+	std::array<int, kMaxRanked> indices = { { 0 } };
+
+	[[nodiscard]] int size() const {
+		return till - from;
+	}
+	[[nodiscard]] bool empty() const {
+		return (till <= from);
+	}
+	[[nodiscard]] int wordIndex(int position) const;
+	[[nodiscard]] QLatin1String word(int position) const;
+	[[nodiscard]] const QString &text(int position) const;
+};
+
+inline bool operator==(const WordsRange &a, const WordsRange &b) {
+	if ((a.index != b.index)
+		|| (a.from != b.from)
+		|| (a.till != b.till)
+		|| (a.ranked != b.ranked)) {
+		return false;
+	} else if (!a.ranked) {
+		return true;
+	}
+	return std::equal(
+		a.indices.begin() + a.from,
+		a.indices.begin() + a.till,
+		b.indices.begin() + b.from);
+}
+
+inline bool operator!=(const WordsRange &a, const WordsRange &b) {
+	return !(a == b);
+}
+
+class WordIndex final {
+public:
+	struct Stats {
+		int64 lookups = 0;
+		int64 narrowings = 0;
+	};
+
+	explicit WordIndex(const base::flat_set<QString> &words);
+
+	[[nodiscard]] bool empty() const;
+	[[nodiscard]] int size() const;
+	[[nodiscard]] QLatin1String word(int index) const;
+
+	// All the words in sorted order, as tonlib joins them.
+	[[nodiscard]] std::vector<QByteArray> list() const;
+
+	// The QString shares the data of the one the index was built from.
+	[[nodiscard]] const QString &text(int index) const;
+
+	// Case-insensitive, expects an already trimmed prefix.
+	[[nodiscard]] WordsRange byPrefix(QStringRef prefix) const;
+
+	// Searches only inside a range found earlier for a shorter prefix.
+	[[nodiscard]] WordsRange narrow(
+		WordsRange range,
+		QStringRef prefix) const;
+
+	// Nothing allocates after the construction, so the index may be used
+	// from several threads at once.
+	[[nodiscard]] Stats stats() const;
+
+private:
+	struct Range {
+		int from = 0;
+		int till = 0;
+	};
+	struct Counters {
+		std::atomic<int64> lookups = 0;
+		std::atomic<int64> narrowings = 0;
+	};
+
+	[[nodiscard]] Range searchRange(Range range, QStringRef prefix) const;
+
+	// All words stored one after another, in sorted order.
+	QByteArray _arena;
+	std::vector<int> _offsets;
+	std::vector<QString> _texts;
+
+	// Ranges for all [a-z] prefixes of one, two and three letters.
+	std::vector<Range> _ranges;
+
+	mutable Counters _counters;
+
+};
+
+} // namespace Keygen
@@ -0,0 +1,262 @@
+// This file is part of TON Key Generator,
+// a desktop application for the TON Blockchain project.
+//
+// For license and copyright information please follow this link:
+// https://github.com/ton-blockchain/tonkeygen/blob/master/LEGAL
+//
+#include "keygen/word_matcher.h"
+
+namespace Keygen {
+namespace {
+
+constexpr auto kEditCost = 2;
+constexpr auto kNeighbourCost = 1;
+
+const auto kKeyboardRows = std::array<QLatin1String, 3>{ {
+	QLatin1String("qwertyuiop"),
+	QLatin1String("asdfghjkl"),
+	QLatin1String("zxcvbnm"),
+} };
+
+} // namespace
+
+struct WordMatcher::Search {
+	std::array<uchar, kMaxLength> query = { { 0 } };
+	int length = 0;
+	int maxCost = 0;
+
+	std::array<std::pair<int, int>, WordsRange::kMaxRanked> best;
+	int count = 0;
+
+	void add(int cost, int index);
+	[[nodiscard]] bool accepts(int cost, int index) const;
+};
+
+bool WordMatcher::Search::accepts(int cost, int index) const {
+	return (count < int(best.size()))
+		|| (std::make_pair(cost, index) < best[count - 1]);
+}
+
+void WordMatcher::Search::add(int cost, int index) {
+	if (!accepts(cost, index)) {
+		return;
+	} else if (count < int(best.size())) {
+		++count;
+	}
+	best[count - 1] = std::make_pair(cost, index);
+	std::sort(best.begin(), best.begin() + count);
+}
+
+WordMatcher::WordMatcher(not_null<const WordIndex*> index)
+: _index(index) {
+	const auto x2 = [](int row, int column) {
+		// Every keyboard row is shifted by half a key to the right.
+		return 2 * column + row;
+	};
+	for (auto row = 0; row != kKeyboardRows.size(); ++row) {
+		const auto keys = kKeyboardRows[row];
+		for (auto column = 0; column != keys.size(); ++column) {
+			const auto a = keys.data()[column] - 'a';
+			for (auto other = 0; other != kKeyboardRows.size(); ++other) {
+				const auto neighbours = kKeyboardRows[other];
+				for (auto j = 0; j != neighbours.size(); ++j) {
+					const auto b = neighbours.data()[j] - 'a';
+					const auto dy = std::abs(row - other);
+					const auto dx = std::abs(x2(row, column) - x2(other, j));
+					_substitution[a][b] = (a == b)
+						? 0
+						: ((dy == 0 && dx == 2) || (dy == 1 && dx <= 1))
+						? kNeighbourCost
+						: kEditCost;
+				}
+			}
+		}
+	}
+
+	if (_index->empty()) {
+		return;
+	}
+
+	// Children of each node are stored consecutively, breadth first.
+	_nodes.push_back({ 0, _index->size() });
+	for (auto i = 0, depth = 0, levelEnd = 1; i != _nodes.size(); ++i) {
+		if (i == levelEnd) {
+			++depth;
+			levelEnd = int(_nodes.size());
+		}
+		auto from = _nodes[i].from;
+		const auto till = _nodes[i].till;
+		if (_index->word(from).size() == depth) {
+			_nodes[i].word = true;
+			++from;
+		}
+		_nodes[i].firstChild = int(_nodes.size());
+		while (from != till) {
+			const auto letter = uchar(_index->word(from).data()[depth]);
+			auto end = from + 1;
+			while (end != till
+				&& uchar(_index->word(end).data()[depth]) == letter) {
+				++end;
+			}
+			auto child = Node();
+			child.from = from;
+			child.till = end;
+			child.letter = letter;
+			_nodes.push_back(child);
+			++_nodes[i].childrenCount;
+			from = end;
+		}
+	}
+}
+
+WordsRange WordMatcher::find(QStringRef prefix) const {
+	auto result = WordsRange();
+	result.index = _index.get();
+	result.ranked = true;
+
+	const auto length = prefix.size();
+	if (_nodes.empty() || length < kMinLength || length > kMaxLength) {
+		return result;
+	}
+	auto search = Search();
+	for (auto i = 0; i != length; ++i) {
+		const auto ch = prefix[i].toLower().unicode();
+		if (ch < 'a' || ch > 'z') {
+			return result;
+		}
+		search.query[i] = uchar(ch);
+	}
+	search.length = length;
+	search.maxCost = maxCost(length);
+
+	auto row = Row();
+	for (auto i = 0; i <= length; ++i) {
+		row[i] = i * kEditCost;
+	}
+	const auto &root = _nodes.front();
+	for (auto i = 0; i != root.childrenCount; ++i) {
+		const auto &child = _nodes[root.firstChild + i];
+		visit(search, child, row, nullptr, 0, std::numeric_limits<int>::max());
+	}
+
+	for (auto i = 0; i != search.count; ++i) {
+		result.indices[i] = search.best[i].second;
+	}
+	result.till = search.count;
+	return result;
+}
+
+int WordMatcher::cost(QStringRef prefix, QLatin1String word) const {
+	const auto rows = prefix.size() + 1;
+	const auto columns = word.size() + 1;
+	auto matrix = std::vector<int>(rows * columns);
+	const auto at = [&](int i, int j) -> int& {
+		return matrix[i * columns + j];
+	};
+	for (auto i = 0; i != rows; ++i) {
+		at(i, 0) = i * kEditCost;
+	}
+	for (auto j = 0; j != columns; ++j) {
+		at(0, j) = j * kEditCost;
+	}
+	const auto typed = [&](int i) {
+		return uchar(prefix[i].toLower().unicode());
+	};
+	const auto letter = [&](int j) {
+		return uchar(word.data()[j]);
+	};
+	for (auto i = 1; i != rows; ++i) {
+		for (auto j = 1; j != columns; ++j) {
+			const auto a = typed(i - 1);
+			const auto b = letter(j - 1);
+			const auto substitution = (a == b)
+				? 0
+				: (a >= 'a' && a <= 'z' && b >= 'a' && b <= 'z')
+				? int(_substitution[a - 'a'][b - 'a'])
+				: kEditCost;
+			auto value = std::min({
+				at(i - 1, j - 1) + substitution,
+				at(i - 1, j) + kEditCost,
+				at(i, j - 1) + kEditCost,
+			});
+			if (i > 1
+				&& j > 1
+				&& a == letter(j - 2)
+				&& typed(i - 2) == b) {
+				value = std::min(value, at(i - 2, j - 2) + kEditCost);
+			}
+			at(i, j) = value;
+		}
+	}
+
+	// Any prefix of the word may match, the rest of it is not typed yet.
+	auto result = at(rows - 1, 0);
+	for (auto j = 1; j != columns; ++j) {
+		result = std::min(result, at(rows - 1, j));
+	}
+	return result;
+}
+
+int WordMatcher::maxCost(int length) {
+	return (length < 6) ? kEditCost : (kEditCost + kNeighbourCost);
+}
+
+void WordMatcher::visit(
+		Search &search,
+		const Node &node,
+		const Row &parent,
+		const Row *grandParent,
+		uchar parentLetter,
+		int inherited) const {
+	const auto letter = node.letter;
+	const auto length = search.length;
+	const auto known = (letter >= 'a' && letter <= 'z');
+
+	auto row = Row();
+	row[0] = parent[0] + kEditCost;
+	auto minimum = row[0];
+	for (auto i = 1; i <= length; ++i) {
+		const auto typed = search.query[i - 1];
+		const auto substitution = (typed == letter)
+			? 0
+			: known
+			? int(_substitution[typed - 'a'][letter - 'a'])
+			: kEditCost;
+		auto value = std::min({
+			parent[i - 1] + substitution,
+			parent[i] + kEditCost,
+			row[i - 1] + kEditCost,
+		});
+		if (grandParent
+			&& i > 1
+			&& typed == parentLetter
+			&& search.query[i - 2] == letter) {
+			value = std::min(value, (*grandParent)[i - 2] + kEditCost);
+		}
+		row[i] = value;
+		minimum = std::min(minimum, value);
+	}
+
+	// The rest of a word is not typed yet, so the best cost of matching
+	// the whole query against any prefix of the word counts for it.
+	const auto cost = std::min(inherited, row[length]);
+	if (node.word && cost <= search.maxCost) {
+		search.add(cost, node.from);
+	}
+	if (minimum > search.maxCost) {
+		if (cost > search.maxCost) {
+			return;
+		}
+		const auto from = node.from + (node.word ? 1 : 0);
+		for (auto i = from; i != node.till && search.accepts(cost, i); ++i) {
+			search.add(cost, i);
+		}
+		return;
+	}
+	for (auto i = 0; i != node.childrenCount; ++i) {
+		const auto &child = _nodes[node.firstChild + i];
+		visit(search, child, row, &parent, letter, cost);
+	}
+}
+
+} // namespace Keygen
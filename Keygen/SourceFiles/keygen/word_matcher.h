@@ -0,0 +1,59 @@
+// This file is part of TON Key Generator,
+// a desktop application for the TON Blockchain project.
+//
+// For license and copyright information please follow this link:
+// https://github.com/ton-blockchain/tonkeygen/blob/master/LEGAL
+//
+#pragma once
+
+#include "keygen/word_index.h"
+
+namespace Keygen {
+
+// Typo-tolerant lookup: walks a trie of the wordlist with a weighted
+// Damerau-Levenshtein row, where neighbour keys are cheaper to mix up.
+class WordMatcher final {
+public:
+	explicit WordMatcher(not_null<const WordIndex*> index);
+
+	// Case-insensitive, expects an already trimmed prefix.
+	// Returns up to WordsRange::kMaxRanked words, best matches first.
+	[[nodiscard]] WordsRange find(QStringRef prefix) const;
+
+	// The cost find() ranks a word by, computed with the full matrix.
+	// Words with more than maxCost() of it are never suggested.
+	[[nodiscard]] int cost(QStringRef prefix, QLatin1String word) const;
+	[[nodiscard]] static int maxCost(int length);
+
+	static constexpr auto kMinLength = 3;
+	static constexpr auto kMaxLength = 16;
+
+private:
+	static constexpr auto kLetters = 26;
+
+	struct Node {
+		int from = 0;
+		int till = 0;
+		int firstChild = 0;
+		int childrenCount = 0;
+		uchar letter = 0;
+		bool word = false;
+	};
+	using Row = std::array<int, kMaxLength + 1>;
+	struct Search;
+
+	void visit(
+		Search &search,
+		const Node &node,
+		const Row &parent,
+		const Row *grandParent,
+		uchar parentLetter,
+		int inherited) const;
+
+	const not_null<const WordIndex*> _index;
+	std::vector<Node> _nodes;
+	std::array<std::array<uchar, kLetters>, kLetters> _substitution = {};
+
+};
+
+} // namespace Keygen
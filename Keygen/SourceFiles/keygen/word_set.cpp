@@ -0,0 +1,158 @@
+// This file is part of TON Key Generator,
+// a desktop application for the TON Blockchain project.
+//
+// For license and copyright information please follow this link:
+// https://github.com/ton-blockchain/tonkeygen/blob/master/LEGAL
+//
+#include "keygen/word_set.h"
+
+#include "keygen/word_index.h"
+
+namespace Keygen {
+namespace {
+
+constexpr auto kBucketSize = 4;
+constexpr auto kBucketSalt = 0x9E3779B97F4A7C15ULL;
+constexpr auto kSecondSalt = 0xD6E8FEB86659FD93ULL;
+
+[[nodiscard]] uint64 Mix(uint64 value) {
+	value ^= value >> 33;
+	value *= 0xFF51AFD7ED558CCDULL;
+	value ^= value >> 33;
+	value *= 0xC4CEB9FE1A85EC53ULL;
+	value ^= value >> 33;
+	return value;
+}
+
+// Returns the hash and all character bits combined.
+template <typename Char>
+[[nodiscard]] std::pair<uint64, uint32> Hash(const Char *data, int size) {
+	auto result = 0xCBF29CE484222325ULL;
+	auto mask = uint32();
+	for (auto i = 0; i != size; ++i) {
+		mask |= uint32(data[i]);
+		result ^= uint64(data[i]);
+		result *= 0x100000001B3ULL;
+	}
+	return { Mix(result), mask };
+}
+
+} // namespace
+
+WordSet::WordSet(const WordIndex &index)
+: _count(index.size())
+, _bucketsCount((_count + kBucketSize - 1) / kBucketSize) {
+	if (_count && !build(index)) {
+		_fallback = &index;
+		_displacements = std::vector<uint32>();
+	}
+}
+
+bool WordSet::build(const WordIndex &index) {
+	auto slots = std::vector<Slot>();
+	auto buckets = std::vector<std::vector<int>>(_bucketsCount);
+	slots.reserve(_count);
+	for (auto i = 0; i != int(_count); ++i) {
+		const auto word = index.word(i);
+		const auto data = reinterpret_cast<const uchar*>(word.data());
+		slots.push_back(slot(Hash(data, word.size()).first));
+		buckets[slots.back().bucket].push_back(i);
+	}
+
+	// Place the largest buckets first, while the table is still empty.
+	auto order = ranges::view::ints(
+		0,
+		int(_bucketsCount)
+	) | ranges::to_vector;
+	std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+		return buckets[a].size() > buckets[b].size();
+	});
+
+	const auto limit = uint64(_count) * _count;
+	auto taken = std::vector<int>(_count, -1);
+	auto positions = std::vector<uint32>();
+	_displacements.resize(_bucketsCount);
+	for (const auto bucket : order) {
+		const auto &words = buckets[bucket];
+		if (words.empty()) {
+			break;
+		}
+		auto found = false;
+		for (auto shift = uint64(); shift != limit; ++shift) {
+			positions.clear();
+			found = true;
+			for (const auto i : words) {
+				const auto now = position(slots[i], uint32(shift));
+				const auto end = positions.end();
+				if (taken[now] >= 0
+					|| std::find(positions.begin(), end, now) != end) {
+					found = false;
+					break;
+				}
+				positions.push_back(now);
+			}
+			if (found) {
+				_displacements[bucket] = uint32(shift);
+				for (auto j = 0, count = int(words.size()); j != count; ++j) {
+					taken[positions[j]] = words[j];
+				}
+				break;
+			}
+		}
+		if (!found) {
+			return false;
+		}
+	}
+
+	_offsets.reserve(_count + 1);
+	for (const auto i : taken) {
+		const auto word = index.word(i);
+		_offsets.push_back(_arena.size());
+		_arena.append(word.data(), word.size());
+	}
+	_offsets.push_back(_arena.size());
+	return true;
+}
+
+bool WordSet::contains(const QString &word) const {
+	if (!_count) {
+		return true;
+	} else if (_fallback) {
+		// Case-insensitive, but an existing word comes first in its range.
+		const auto range = _fallback->byPrefix(word.midRef(0));
+		return !range.empty() && (range.word(0) == word);
+	}
+	const auto [hash, mask] = Hash(word.utf16(), word.size());
+	if (mask > 0xFF) {
+		return false;
+	}
+	const auto found = slot(hash);
+	return (word == stored(position(found, _displacements[found.bucket])));
+}
+
+bool WordSet::hashed() const {
+	return !_fallback;
+}
+
+WordSet::Slot WordSet::slot(uint64 hash) const {
+	auto result = Slot();
+	result.bucket = uint32(Mix(hash ^ kBucketSalt) % _bucketsCount);
+	result.first = uint32(hash % _count);
+	result.second = uint32(Mix(hash + kSecondSalt) % _count);
+	return result;
+}
+
+uint32 WordSet::position(Slot slot, uint32 displacement) const {
+	const auto shift = uint64(displacement % _count);
+	const auto multiplier = uint64(displacement / _count);
+	return uint32((slot.first + shift + multiplier * slot.second) % _count);
+}
+
+QLatin1String WordSet::stored(int position) const {
+	const auto from = _offsets[position];
+	return QLatin1String(
+		_arena.constData() + from,
+		_offsets[position + 1] - from);
+}
+
+} // namespace Keygen
@@ -0,0 +1,51 @@
+// This file is part of TON Key Generator,
+// a desktop application for the TON Blockchain project.
+//
+// For license and copyright information please follow this link:
+// https://github.com/ton-blockchain/tonkeygen/blob/master/LEGAL
+//
+#pragma once
+
+namespace Keygen {
+
+class WordIndex;
+
+// Membership test over the wordlist, backed by a minimal perfect hash:
+// each lookup is one hash of the word and one comparison. If no hash
+// fits the list, the lookups go to the index, which must outlive the set.
+class WordSet final {
+public:
+	explicit WordSet(const WordIndex &index);
+
+	// Exact, case-sensitive match. Accepts anything if the list is empty.
+	[[nodiscard]] bool contains(const QString &word) const;
+
+	// False if the lookups fell back to the index.
+	[[nodiscard]] bool hashed() const;
+
+private:
+	struct Slot {
+		uint32 bucket = 0;
+		uint32 first = 0;
+		uint32 second = 0;
+	};
+
+	[[nodiscard]] bool build(const WordIndex &index);
+	[[nodiscard]] Slot slot(uint64 hash) const;
+	[[nodiscard]] uint32 position(Slot slot, uint32 displacement) const;
+	[[nodiscard]] QLatin1String stored(int position) const;
+
+	uint32 _count = 0;
+	uint32 _bucketsCount = 0;
+	const WordIndex *_fallback = nullptr;
+
+	// Displacement for each bucket, picked so that slots never collide.
+	std::vector<uint32> _displacements;
+
+	// Words stored one after another in the order of their slots.
+	QByteArray _arena;
+	std::vector<int> _offsets;
+
+};
+
+} // namespace Keygen
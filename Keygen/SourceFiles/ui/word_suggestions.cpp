@@ -29,7 +29,7 @@ WordSuggestions::WordSuggestions(not_null<QWidget*> parent)
 
 	_widget->paintRequest(
 	) | rpl::start_with_next([=](QRect clip) {
-		paintRows();
+		paintRows(clip);
 	}, _widget->lifetime());
 
 	_inner->setMouseTracking(true);
@@ -48,18 +48,21 @@ WordSuggestions::WordSuggestions(not_null<QWidget*> parent)
 	}, _inner->lifetime());
 }
 
-void WordSuggestions::show(std::vector<QString> &&words) {
+void WordSuggestions::show(Keygen::WordsRange words) {
 	if (_words == words) {
 		return;
 	}
-	_words = std::move(words);
+	const auto resize = (_words.size() != words.size());
+	_words = words;
 	select(0);
-	const auto height = st::suggestionsSkip * 2
-		+ int(_words.size()) * st::suggestionHeight
-		+ st::suggestionShadowWidth;
-	const auto outerHeight = std::min(height, st::suggestionsHeightMax);
-	_inner->resize(_widget->width(), height);
-	_widget->resize(_widget->width(), outerHeight);
+	if (resize) {
+		const auto height = st::suggestionsSkip * 2
+			+ int(_words.size()) * st::suggestionHeight
+			+ st::suggestionShadowWidth;
+		const auto outerHeight = std::min(height, st::suggestionsHeightMax);
+		_inner->resize(_widget->width(), height);
+		_widget->resize(_widget->width(), outerHeight);
+	}
 	_widget->update();
 	_widget->show();
 }
@@ -87,8 +90,8 @@ void WordSuggestions::select(int index) {
 	if (_selected == index) {
 		return;
 	}
-	_selected = index;
-	_inner->update();
+	updateRow(std::exchange(_selected, index));
+	updateRow(_selected);
 }
 
 void WordSuggestions::selectByMouse(QPoint position) {
@@ -105,7 +108,7 @@ void WordSuggestions::choose() {
 	Expects(!_words.empty());
 	Expects(_selected >= 0 && _selected < _words.size());
 
-	_chosen.fire_copy(_words[_selected]);
+	_chosen.fire_copy(_words.text(_selected));
 }
 
 void WordSuggestions::setGeometry(QPoint position, int width) {
@@ -113,64 +116,85 @@ void WordSuggestions::setGeometry(QPoint position, int width) {
 	_inner->resize(width, _inner->height());
 }
 
-void WordSuggestions::paintRows() {
-	QPainter(_widget.get()).drawImage(0, 0, prepareFrame());
+int WordSuggestions::rowsTop() const {
+	return st::suggestionsSkip - _scroll->scrollTop();
 }
 
-QImage WordSuggestions::prepareFrame() const {
-	const auto pixelRatio = style::DevicePixelRatio();
-	if (_frame.size() != _widget->size() * pixelRatio) {
-		_frame = QImage(
-			_widget->size() * pixelRatio,
-			QImage::Format_ARGB32_Premultiplied);
+void WordSuggestions::updateRow(int index) {
+	if (index < 0 || index >= _words.size()) {
+		return;
 	}
-	_frame.fill(st::windowBg->c);
-	_frame.setDevicePixelRatio(pixelRatio);
-	{
-		auto p = QPainter(&_frame);
-
-		const auto thickness = st::suggestionShadowWidth;
-
-		p.setPen(st::windowFg);
-		p.setFont(st::normalFont);
-		auto index = 0;
-		const auto wordLeft = thickness;
-		auto wordTop = st::suggestionsSkip - _scroll->scrollTop();
-		const auto wordWidth = _widget->width() - 2 * thickness;
-		const auto wordHeight = st::suggestionHeight;
-		for (const auto &word : _words) {
-			if (index == (_pressed >= 0 ? _pressed : _selected)) {
-				p.fillRect(
-					wordLeft,
-					wordTop,
-					wordWidth,
-					wordHeight,
-					st::windowBgOver);
-			}
-			p.drawText(
-				wordLeft + st::suggestionLeft,
-				wordTop + st::suggestionTop + st::normalFont->ascent,
-				word);
-			wordTop += wordHeight;
-			++index;
-		}
+	const auto thickness = st::suggestionShadowWidth;
+	_widget->update(
+		thickness,
+		rowsTop() + index * st::suggestionHeight,
+		_widget->width() - 2 * thickness,
+		st::suggestionHeight);
+}
 
-		const auto radius = st::suggestionsRadius;
-		const auto left = float64(thickness) / 2;
-		const auto top = -2. * radius;
-		const auto width = float64(_widget->width()) - thickness;
-		const auto height = float64(_widget->height())
-			- top
-			+ ((thickness / 2.) - thickness);
-
-		PainterHighQualityEnabler hq(p);
-		p.setBrush(Qt::NoBrush);
-		auto pen = st::defaultInputField.borderFg->p;
-		pen.setWidth(thickness);
-		p.setPen(pen);
-		p.drawRoundedRect(QRectF{ left, top, width, height }, radius, radius);
+const QStaticText &WordSuggestions::layout(int index) const {
+	const auto word = _words.wordIndex(index);
+	auto i = _layouts.find(word);
+	if (i == _layouts.end()) {
+		auto text = QStaticText(_words.text(index));
+		text.setPerformanceHint(QStaticText::AggressiveCaching);
+		text.prepare(QTransform(), st::normalFont->f);
+		i = _layouts.emplace(word, std::move(text)).first;
 	}
-	return _frame;
+	return i->second;
+}
+
+void WordSuggestions::paintRows(QRect clip) {
+	auto p = QPainter(_widget.get());
+	p.fillRect(clip, st::windowBg);
+
+	const auto thickness = st::suggestionShadowWidth;
+
+	// Paint only the rows that intersect the updated area.
+	const auto wordLeft = thickness;
+	const auto wordWidth = _widget->width() - 2 * thickness;
+	const auto wordHeight = st::suggestionHeight;
+	const auto top = rowsTop();
+	const auto from = std::max((clip.y() - top) / wordHeight, 0);
+	const auto till = std::min(
+		(clip.y() + clip.height() - top + wordHeight - 1) / wordHeight,
+		_words.size());
+	const auto active = (_pressed >= 0) ? _pressed : _selected;
+	p.setPen(st::windowFg);
+	p.setFont(st::normalFont);
+	for (auto index = from; index < till; ++index) {
+		const auto wordTop = top + index * wordHeight;
+		if (index == active) {
+			p.fillRect(
+				wordLeft,
+				wordTop,
+				wordWidth,
+				wordHeight,
+				st::windowBgOver);
+		}
+		p.drawStaticText(
+			wordLeft + st::suggestionLeft,
+			wordTop + st::suggestionTop,
+			layout(index));
+	}
+
+	const auto radius = st::suggestionsRadius;
+	const auto left = float64(thickness) / 2;
+	const auto borderTop = -2. * radius;
+	const auto width = float64(_widget->width()) - thickness;
+	const auto height = float64(_widget->height())
+		- borderTop
+		+ ((thickness / 2.) - thickness);
+
+	PainterHighQualityEnabler hq(p);
+	p.setBrush(Qt::NoBrush);
+	auto pen = st::defaultInputField.borderFg->p;
+	pen.setWidth(thickness);
+	p.setPen(pen);
+	p.drawRoundedRect(
+		QRectF{ left, borderTop, width, height },
+		radius,
+		radius);
 }
 
 rpl::producer<QString> WordSuggestions::chosen() const {
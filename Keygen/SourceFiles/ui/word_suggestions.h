@@ -6,6 +6,11 @@
 //
 #pragma once
 
+#include "keygen/word_index.h"
+#include "base/flat_map.h"
+
+#include <QtGui/QStaticText>
+
 namespace Ui {
 
 class RpWidget;
@@ -16,7 +21,7 @@ public:
 	explicit WordSuggestions(not_null<QWidget*> parent);
 
 	void setGeometry(QPoint position, int width);
-	void show(std::vector<QString> &&words);
+	void show(Keygen::WordsRange words);
 	void hide();
 
 	void selectDown();
@@ -30,17 +35,19 @@ public:
 	[[nodiscard]] rpl::lifetime &lifetime();
 
 private:
-	void paintRows();
+	void paintRows(QRect clip);
+	void updateRow(int index);
 	void ensureSelectedVisible();
 	void selectByMouse(QPoint position);
-	[[nodiscard]] QImage prepareFrame() const;
+	[[nodiscard]] int rowsTop() const;
+	[[nodiscard]] const QStaticText &layout(int index) const;
 
 	const std::unique_ptr<RpWidget> _widget;
 	const not_null<ScrollArea*> _scroll;
 	const not_null<RpWidget*> _inner;
 
-	mutable QImage _frame;
-	std::vector<QString> _words;
+	Keygen::WordsRange _words;
+	mutable base::flat_map<int, QStaticText> _layouts;
 	int _selected = -1;
 	int _pressed = -1;
 
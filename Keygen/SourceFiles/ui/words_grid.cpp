@@ -0,0 +1,115 @@
+// This file is part of TON Key Generator,
+// a desktop application for the TON Blockchain project.
+//
+// For license and copyright information please follow this link:
+// https://github.com/ton-blockchain/tonkeygen/blob/master/LEGAL
+//
+#include "ui/words_grid.h"
+
+#include "ui/rp_widget.h"
+#include "ui/painter.h"
+#include "ui/text/text.h"
+#include "styles/style_widgets.h"
+#include "styles/style_keygen.h"
+
+namespace Ui {
+namespace {
+
+struct Cell {
+	Text::String index;
+	Text::String word;
+	QPoint indexPosition;
+	QPoint wordPosition;
+};
+
+void PaintLabel(
+		Painter &p,
+		const style::FlatLabel &st,
+		const Text::String &text,
+		QPoint position,
+		int outerWidth) {
+	const auto width = text.maxWidth();
+	p.setPen(st.textFg);
+	p.setTextPalette(st.palette);
+	text.drawLeft(
+		p,
+		position.x() + st.margin.left(),
+		position.y() + st.margin.top(),
+		width,
+		outerWidth,
+		st.align);
+}
+
+} // namespace
+
+not_null<Ui::RpWidget*> CreateWordsGrid(
+		not_null<QWidget*> parent,
+		const std::vector<QString> &words) {
+	Expects(words.size() % 2 == 0);
+
+	auto result = Ui::CreateChild<Ui::RpWidget>(parent.get());
+	result->setAttribute(Qt::WA_TransparentForMouseEvents);
+
+	const auto rows = int(words.size()) / 2;
+	const auto cells = result->lifetime().make_state<std::vector<Cell>>();
+	cells->reserve(words.size());
+	for (auto i = 0; i != words.size(); ++i) {
+		auto cell = Cell();
+		cell.index = Text::String(
+			st::wordIndexLabel.style,
+			QString::number(i + 1) + '.');
+		cell.word = Text::String(st::wordLabel.style, words[i]);
+		cells->push_back(std::move(cell));
+	}
+
+	// Layout depends only on the width, so compute it once per width.
+	result->widthValue(
+	) | rpl::start_with_next([=](int width) {
+		const auto half = width / 2;
+		const auto left = half - st::wordSkipLeft;
+		const auto right = half + st::wordSkipRight;
+		for (auto i = 0; i != cells->size(); ++i) {
+			auto &cell = (*cells)[i];
+			const auto x = (i < rows) ? left : right;
+			const auto y = (i % rows) * st::wordHeight;
+			const auto &margin = st::wordIndexLabel.margin;
+			const auto indexWidth = margin.left()
+				+ cell.index.maxWidth()
+				+ margin.right();
+			cell.indexPosition = QPoint(
+				x - indexWidth - st::wordIndexSkip,
+				y);
+			cell.wordPosition = QPoint(x, y);
+		}
+	}, result->lifetime());
+
+	result->paintRequest(
+	) | rpl::start_with_next([=](QRect clip) {
+		auto p = Painter(result);
+		const auto width = result->width();
+		for (const auto &cell : *cells) {
+			const auto top = cell.wordPosition.y();
+			if (top >= clip.y() + clip.height()
+				|| top + st::wordHeight <= clip.y()) {
+				continue;
+			}
+			PaintLabel(
+				p,
+				st::wordIndexLabel,
+				cell.index,
+				cell.indexPosition,
+				width);
+			PaintLabel(
+				p,
+				st::wordLabel,
+				cell.word,
+				cell.wordPosition,
+				width);
+		}
+	}, result->lifetime());
+
+	result->resize(result->width(), rows * st::wordHeight);
+	return result;
+}
+
+} // namespace Ui
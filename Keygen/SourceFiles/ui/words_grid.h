@@ -0,0 +1,22 @@
+// This file is part of TON Key Generator,
+// a desktop application for the TON Blockchain project.
+//
+// For license and copyright information please follow this link:
+// https://github.com/ton-blockchain/tonkeygen/blob/master/LEGAL
+//
+#pragma once
+
+class QWidget;
+class QString;
+
+namespace Ui {
+
+class RpWidget;
+
+// Paints numbered words in two columns, the same way the pairs of
+// st::wordIndexLabel and st::wordLabel labels would look.
+[[nodiscard]] not_null<Ui::RpWidget*> CreateWordsGrid(
+	not_null<QWidget*> parent,
+	const std::vector<QString> &words);
+
+} // namespace Ui
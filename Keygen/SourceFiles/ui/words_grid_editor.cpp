@@ -0,0 +1,648 @@
+// This file is part of TON Key Generator,
+// a desktop application for the TON Blockchain project.
+//
+// For license and copyright information please follow this link:
+// https://github.com/ton-blockchain/tonkeygen/blob/master/LEGAL
+//
+#include "ui/words_grid_editor.h"
+
+#include "ui/rp_widget.h"
+#include "ui/word_suggestions.h"
+#include "base/event_filter.h"
+#include "base/platform/base_platform_layout_switch.h"
+#include "styles/style_keygen.h"
+#include "styles/style_widgets.h"
+#include "styles/palette.h"
+
+#include <QtCore/QRegularExpression>
+#include <QtGui/QClipboard>
+#include <QtGui/QGuiApplication>
+#include <QtGui/QPainter>
+#include <QtGui/QtEvents>
+
+namespace Ui {
+namespace {
+
+constexpr auto kColumns = 2;
+constexpr auto kMaxWordLength = 32;
+constexpr auto kCaretBlinkDuration = crl::time(500);
+
+[[nodiscard]] QStringList ParsePastedWords(const QString &text) {
+	static const auto kSeparators = QRegularExpression("\\s+");
+	static const auto kNumbering = QRegularExpression("^\\d+[.)]?$");
+
+	auto result = QStringList();
+	const auto parts = text.split(kSeparators, QString::SkipEmptyParts);
+	for (const auto &part : parts) {
+		// Skip numbering like "1." when a whole list was copied.
+		if (!kNumbering.match(part).hasMatch()) {
+			result.push_back(part.toLower());
+		}
+	}
+	return result;
+}
+
+} // namespace
+
+WordsGridEditor::WordsGridEditor(
+	not_null<QWidget*> parent,
+	int count,
+	Fn<Keygen::WordsRange(QString)> wordsByPrefix)
+: _widget(std::make_unique<RpWidget>(parent))
+, _wordsByPrefix(std::move(wordsByPrefix))
+, _rows((count + kColumns - 1) / kColumns)
+, _cells(count)
+, _caretTimer([=] { toggleCaret(); }) {
+	Expects(count > 0);
+
+	_labels.reserve(count);
+	for (auto i = 0; i != count; ++i) {
+		_labels.push_back(QString::number(i + 1) + '.');
+	}
+	_widget->setFocusPolicy(Qt::StrongFocus);
+	_widget->setMouseTracking(true);
+	_widget->setAttribute(Qt::WA_InputMethodEnabled, false);
+	_widget->show();
+
+	setupEvents();
+}
+
+WordsGridEditor::~WordsGridEditor() = default;
+
+void WordsGridEditor::setupEvents() {
+	_widget->paintRequest(
+	) | rpl::start_with_next([=](QRect clip) {
+		paint(clip);
+	}, _widget->lifetime());
+
+	base::install_event_filter(_widget.get(), [=](not_null<QEvent*> e) {
+		const auto type = e->type();
+		if (type == QEvent::KeyPress) {
+			return handleKeyPress(static_cast<QKeyEvent*>(e.get()))
+				? base::EventFilterResult::Cancel
+				: base::EventFilterResult::Continue;
+		} else if (type == QEvent::MouseButtonPress
+			|| type == QEvent::MouseButtonDblClick) {
+			handleMousePress(static_cast<QMouseEvent*>(e.get()));
+		} else if (type == QEvent::MouseMove) {
+			handleMouseMove(static_cast<QMouseEvent*>(e.get()));
+		} else if (type == QEvent::MouseButtonRelease) {
+			_selecting = false;
+		} else if (type == QEvent::FocusIn) {
+			handleFocusIn();
+		} else if (type == QEvent::FocusOut) {
+			handleFocusOut();
+		}
+		return base::EventFilterResult::Continue;
+	});
+}
+
+int WordsGridEditor::rows() const {
+	return _rows;
+}
+
+int WordsGridEditor::count() const {
+	return int(_cells.size());
+}
+
+QString WordsGridEditor::word(int index) const {
+	Expects(index >= 0 && index < count());
+
+	return _cells[index].text;
+}
+
+std::vector<QString> WordsGridEditor::words() const {
+	return _cells | ranges::view::transform(
+		&Cell::text
+	) | ranges::to_vector;
+}
+
+void WordsGridEditor::moveToTop(int top, int width) {
+	_widget->setGeometry(0, top, width, _rows * st::wordHeight);
+}
+
+void WordsGridEditor::setWords(int from, const QStringList &words) {
+	Expects(from >= 0 && from < count());
+
+	// Fill the cells in one pass, without suggestions.
+	const auto till = std::min(from + int(words.size()), count());
+	for (auto i = from; i != till; ++i) {
+		auto &cell = _cells[i];
+		cell.text = words[i - from].left(kMaxWordLength);
+		cell.cursor = cell.anchor = cell.text.size();
+		cell.error = false;
+		cell.chosen = true;
+	}
+	if (_suggestions) {
+		_suggestions->hide();
+	}
+	_widget->update();
+}
+
+void WordsGridEditor::setFocus(int index) {
+	Expects(index >= 0 && index < count());
+
+	base::Platform::SwitchKeyboardLayoutToEnglish();
+	setActive(index);
+	_widget->setFocus();
+}
+
+void WordsGridEditor::showError(int index) {
+	showErrorNoFocus(index);
+	setFocus(index);
+}
+
+void WordsGridEditor::showErrorNoFocus(int index) {
+	Expects(index >= 0 && index < count());
+
+	_cells[index].error = true;
+	updateCell(index);
+}
+
+void WordsGridEditor::setActive(int index) {
+	if (_active == index) {
+		return;
+	}
+	if (_active >= 0) {
+		const auto was = std::exchange(_active, -1);
+		if (_suggestions) {
+			_suggestions->hide();
+		}
+		updateCell(was);
+		if (_hasFocus) {
+			_blurred.fire_copy(was);
+		}
+	}
+	_active = index;
+	if (_active < 0) {
+		return;
+	}
+	auto &cell = _cells[_active];
+	cell.cursor = cell.anchor = cell.text.size();
+	restartCaret();
+	if (_hasFocus) {
+		_focused.fire_copy(_active);
+		if (!cell.chosen) {
+			showSuggestions(_active);
+		}
+	}
+}
+
+void WordsGridEditor::handleFocusIn() {
+	_hasFocus = true;
+	if (_active < 0) {
+		_active = 0;
+	}
+	restartCaret();
+	_focused.fire_copy(_active);
+	if (!_cells[_active].chosen) {
+		showSuggestions(_active);
+	}
+}
+
+void WordsGridEditor::handleFocusOut() {
+	_hasFocus = false;
+	_selecting = false;
+	_caretTimer.cancel();
+	if (_suggestions) {
+		_suggestions->hide();
+	}
+	if (_active >= 0) {
+		updateCell(_active);
+		_blurred.fire_copy(_active);
+	}
+}
+
+void WordsGridEditor::restartCaret() {
+	_caretShown = true;
+	if (_hasFocus) {
+		_caretTimer.callEach(kCaretBlinkDuration);
+	}
+	if (_active >= 0) {
+		updateCell(_active);
+	}
+}
+
+void WordsGridEditor::toggleCaret() {
+	_caretShown = !_caretShown;
+	if (_active >= 0) {
+		updateCell(_active);
+	}
+}
+
+bool WordsGridEditor::handleKeyPress(not_null<QKeyEvent*> e) {
+	if (_active < 0) {
+		return false;
+	}
+	const auto key = e->key();
+	const auto shift = (e->modifiers() & Qt::ShiftModifier) != 0;
+	auto &cell = _cells[_active];
+	if (key == Qt::Key_Tab || key == Qt::Key_Backtab) {
+		const auto forward = (key == Qt::Key_Tab) && !shift;
+		const auto index = _active + (forward ? 1 : -1);
+		if (index >= 0 && index < count()) {
+			setFocus(index);
+		}
+	} else if (key == Qt::Key_Enter || key == Qt::Key_Return) {
+		if (_suggestions) {
+			_suggestions->choose();
+		} else {
+			_submitted.fire_copy(_active);
+		}
+	} else if (key == Qt::Key_Up || key == Qt::Key_Down) {
+		const auto up = (key == Qt::Key_Up);
+		if (_suggestions) {
+			if (up) {
+				_suggestions->selectUp();
+			} else {
+				_suggestions->selectDown();
+			}
+		} else {
+			const auto row = _active % _rows;
+			if (up ? (row > 0) : (row + 1 < _rows && _active + 1 < count())) {
+				setFocus(_active + (up ? -1 : 1));
+			}
+		}
+	} else if (e->matches(QKeySequence::Paste)) {
+		paste();
+	} else if (e->matches(QKeySequence::Copy)) {
+		copySelection();
+	} else if (e->matches(QKeySequence::Cut)) {
+		copySelection();
+		if (hasSelection(_active)) {
+			removeSelection();
+			changed(_active);
+		}
+	} else if (e->matches(QKeySequence::SelectAll)) {
+		cell.anchor = 0;
+		cell.cursor = cell.text.size();
+		restartCaret();
+	} else if (key == Qt::Key_Left || key == Qt::Key_Right) {
+		const auto left = (key == Qt::Key_Left);
+		if (hasSelection(_active) && !shift) {
+			const auto edge = left
+				? std::min(cell.anchor, cell.cursor)
+				: std::max(cell.anchor, cell.cursor);
+			moveCursor(edge, false);
+		} else {
+			moveCursor(cell.cursor + (left ? -1 : 1), shift);
+		}
+	} else if (key == Qt::Key_Home || key == Qt::Key_End) {
+		moveCursor((key == Qt::Key_Home) ? 0 : cell.text.size(), shift);
+	} else if (key == Qt::Key_Backspace || key == Qt::Key_Delete) {
+		erase((key == Qt::Key_Backspace) ? -1 : 1);
+	} else {
+		static const auto kBlanks = QRegularExpression("[\\s\\x00-\\x1f\\x7f]");
+		const auto modifiers = e->modifiers()
+			& (Qt::ControlModifier | Qt::MetaModifier);
+		auto text = e->text();
+		text.remove(kBlanks);
+		if (modifiers || text.isEmpty()) {
+			return false;
+		}
+		insert(text);
+	}
+	return true;
+}
+
+void WordsGridEditor::handleMousePress(not_null<QMouseEvent*> e) {
+	if (e->button() != Qt::LeftButton) {
+		return;
+	}
+	const auto index = cellAt(e->pos());
+	if (index < 0) {
+		return;
+	}
+	setFocus(index);
+	auto &cell = _cells[index];
+	if (e->type() == QEvent::MouseButtonDblClick) {
+		cell.anchor = 0;
+		cell.cursor = cell.text.size();
+		restartCaret();
+		return;
+	}
+	const auto shift = (e->modifiers() & Qt::ShiftModifier) != 0;
+	moveCursor(positionAt(index, e->pos().x()), shift);
+	_selecting = true;
+}
+
+void WordsGridEditor::handleMouseMove(not_null<QMouseEvent*> e) {
+	if (_selecting && _active >= 0) {
+		moveCursor(positionAt(_active, e->pos().x()), true);
+	}
+	_widget->setCursor((_selecting || cellAt(e->pos()) >= 0)
+		? style::cur_text
+		: style::cur_default);
+}
+
+void WordsGridEditor::moveCursor(int position, bool select) {
+	Expects(_active >= 0);
+
+	auto &cell = _cells[_active];
+	cell.cursor = std::clamp(position, 0, cell.text.size());
+	if (!select) {
+		cell.anchor = cell.cursor;
+	}
+	restartCaret();
+}
+
+bool WordsGridEditor::hasSelection(int index) const {
+	return (_cells[index].anchor != _cells[index].cursor);
+}
+
+void WordsGridEditor::removeSelection() {
+	Expects(_active >= 0);
+
+	auto &cell = _cells[_active];
+	const auto from = std::min(cell.anchor, cell.cursor);
+	cell.text.remove(from, std::abs(cell.anchor - cell.cursor));
+	cell.cursor = cell.anchor = from;
+}
+
+void WordsGridEditor::insert(const QString &text) {
+	Expects(_active >= 0);
+
+	removeSelection();
+	auto &cell = _cells[_active];
+	const auto add = text.left(kMaxWordLength - cell.text.size());
+	cell.text.insert(cell.cursor, add);
+	cell.cursor = cell.anchor = cell.cursor + add.size();
+	changed(_active);
+}
+
+void WordsGridEditor::erase(int direction) {
+	Expects(_active >= 0);
+
+	auto &cell = _cells[_active];
+	if (hasSelection(_active)) {
+		removeSelection();
+	} else if (direction < 0 && cell.cursor > 0) {
+		cell.text.remove(--cell.cursor, 1);
+		cell.anchor = cell.cursor;
+	} else if (direction > 0 && cell.cursor < cell.text.size()) {
+		cell.text.remove(cell.cursor, 1);
+	} else {
+		return;
+	}
+	changed(_active);
+}
+
+void WordsGridEditor::copySelection() const {
+	if (_active < 0 || !hasSelection(_active)) {
+		return;
+	}
+	const auto &cell = _cells[_active];
+	QGuiApplication::clipboard()->setText(cell.text.mid(
+		std::min(cell.anchor, cell.cursor),
+		std::abs(cell.anchor - cell.cursor)));
+}
+
+void WordsGridEditor::paste() {
+	Expects(_active >= 0);
+
+	auto words = ParsePastedWords(QGuiApplication::clipboard()->text());
+	if (words.size() > 1) {
+		if (_suggestions) {
+			_suggestions->hide();
+		}
+		_pasted.fire({ _active, std::move(words) });
+	} else if (!words.isEmpty()) {
+		insert(words.front());
+	}
+}
+
+void WordsGridEditor::changed(int index) {
+	auto &cell = _cells[index];
+	cell.error = false;
+	cell.chosen = false;
+	restartCaret();
+	showSuggestions(index);
+	_edited.fire_copy(index);
+}
+
+Keygen::WordsRange WordsGridEditor::lookup(int index) {
+	auto &cell = _cells[index];
+	const auto &word = cell.text;
+
+	// While the user only appends characters narrow the previous result.
+	const auto narrow = (cell.lastRange.index != nullptr)
+		&& !cell.lastRange.ranked
+		&& !cell.lastQuery.isEmpty()
+		&& word.startsWith(cell.lastQuery);
+	if (narrow) {
+		cell.lastRange = cell.lastRange.index->narrow(
+			cell.lastRange,
+			QStringRef(&word));
+	}
+	if (!narrow || cell.lastRange.empty()) {
+		// Nothing left to narrow, let the typo-tolerant lookup try.
+		cell.lastRange = _wordsByPrefix(word);
+	}
+	cell.lastQuery = word;
+	return cell.lastRange;
+}
+
+void WordsGridEditor::showSuggestions(int index) {
+	const auto &word = _cells[index].text;
+	const auto range = lookup(index);
+	if (range.empty()
+		|| (range.size() == 1 && range.word(0) == word)
+		|| word.size() < 3) {
+		if (_suggestions) {
+			_suggestions->hide();
+		}
+	} else {
+		if (!_suggestions) {
+			createSuggestions();
+		}
+		_suggestions->show(range);
+	}
+}
+
+void WordsGridEditor::createSuggestions() {
+	_suggestions = std::make_unique<WordSuggestions>(
+		_widget->parentWidget());
+
+	_suggestions->chosen(
+	) | rpl::start_with_next([=](QString word) {
+		const auto index = _active;
+		auto &cell = _cells[index];
+		cell.text = word;
+		cell.cursor = cell.anchor = word.size();
+		cell.error = false;
+		cell.chosen = true;
+		updateCell(index);
+		_widget->setFocus();
+		_suggestions = nullptr;
+		_submitted.fire_copy(index);
+	}, _suggestions->lifetime());
+
+	_suggestions->hidden(
+	) | rpl::start_with_next([=] {
+		_suggestions = nullptr;
+	}, _suggestions->lifetime());
+
+	_widget->geometryValue(
+	) | rpl::start_with_next([=] {
+		updateSuggestionsGeometry();
+	}, _suggestions->lifetime());
+}
+
+void WordsGridEditor::updateSuggestionsGeometry() {
+	Expects(_suggestions != nullptr);
+	Expects(_active >= 0);
+
+	const auto input = inputRect(_active).translated(_widget->pos());
+	_suggestions->setGeometry(
+		input.topLeft() + QPoint(0, input.height()),
+		input.width());
+}
+
+QRect WordsGridEditor::inputRect(int index) const {
+	const auto column = index / _rows;
+	const auto row = index % _rows;
+	const auto half = _widget->width() / 2;
+	const auto left = column
+		? (half + st::wordSkipRight)
+		: (half - st::wordSkipLeft);
+	return QRect(
+		left,
+		row * st::wordHeight,
+		st::checkInputField.width,
+		st::checkInputField.heightMin);
+}
+
+int WordsGridEditor::cellAt(QPoint position) const {
+	for (auto i = 0; i != count(); ++i) {
+		if (inputRect(i).contains(position)) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+int WordsGridEditor::cursorLeft(int index, int position) const {
+	const auto &st = st::checkInputField;
+	return inputRect(index).x()
+		+ st.textMargins.left()
+		+ st.font->width(_cells[index].text.left(position));
+}
+
+int WordsGridEditor::positionAt(int index, int left) const {
+	const auto &text = _cells[index].text;
+	auto x = cursorLeft(index, 0);
+	for (auto i = 0; i != text.size(); ++i) {
+		const auto width = st::checkInputField.font->width(text[i]);
+		if (left < x + width / 2) {
+			return i;
+		}
+		x += width;
+	}
+	return text.size();
+}
+
+void WordsGridEditor::updateCell(int index) {
+	const auto input = inputRect(index);
+	_widget->update(0, input.y(), _widget->width(), input.height());
+}
+
+void WordsGridEditor::paint(QRect clip) {
+	auto p = QPainter(_widget.get());
+	for (auto i = 0; i != count(); ++i) {
+		const auto input = inputRect(i);
+		if (input.y() < clip.y() + clip.height()
+			&& input.y() + input.height() > clip.y()) {
+			paintCell(p, i);
+		}
+	}
+}
+
+void WordsGridEditor::paintCell(QPainter &p, int index) {
+	const auto &st = st::checkInputField;
+	const auto &cell = _cells[index];
+	const auto input = inputRect(index);
+
+	const auto &label = _labels[index];
+	const auto &labelFont = st::wordIndexLabel.style.font;
+	p.setFont(labelFont);
+	p.setPen(st::wordIndexLabel.textFg);
+	p.drawText(
+		input.x() - labelFont->width(label) - st::wordIndexSkip,
+		input.y() + st::checkInputSkip + labelFont->ascent,
+		label);
+
+	const auto active = _hasFocus && (index == _active);
+	const auto textTop = input.y() + st.textMargins.top();
+	const auto baseline = textTop + st.font->ascent;
+	const auto textLeft = cursorLeft(index, 0);
+	p.save();
+	p.setClipRect(input);
+	p.setFont(st.font);
+	p.setPen(st.textFg);
+	p.drawText(textLeft, baseline, cell.text);
+	if (active && hasSelection(index)) {
+		const auto from = cursorLeft(index, std::min(cell.anchor, cell.cursor));
+		const auto till = cursorLeft(index, std::max(cell.anchor, cell.cursor));
+		const auto selection = QRect(
+			from,
+			textTop,
+			till - from,
+			st.font->height);
+		const auto &palette = _widget->palette();
+		p.fillRect(selection, palette.color(QPalette::Highlight));
+		p.setClipRect(selection.intersected(input));
+		p.setPen(palette.color(QPalette::HighlightedText));
+		p.drawText(textLeft, baseline, cell.text);
+	} else if (active && _caretShown) {
+		p.fillRect(
+			cursorLeft(index, cell.cursor),
+			textTop,
+			st::lineWidth,
+			st.font->height,
+			st.textFg);
+	}
+	p.restore();
+
+	const auto bottom = input.y() + input.height();
+	if (cell.error || active) {
+		p.fillRect(
+			input.x(),
+			bottom - st.borderActive,
+			input.width(),
+			st.borderActive,
+			cell.error ? st.borderFgError : st.borderFgActive);
+	} else {
+		p.fillRect(
+			input.x(),
+			bottom - st.border,
+			input.width(),
+			st.border,
+			st.borderFg);
+	}
+}
+
+rpl::producer<int> WordsGridEditor::focused() const {
+	return _focused.events();
+}
+
+rpl::producer<int> WordsGridEditor::blurred() const {
+	return _blurred.events();
+}
+
+rpl::producer<int> WordsGridEditor::submitted() const {
+	return _submitted.events();
+}
+
+rpl::producer<int> WordsGridEditor::edited() const {
+	return _edited.events();
+}
+
+auto WordsGridEditor::pasted() const -> rpl::producer<Pasted> {
+	return _pasted.events();
+}
+
+rpl::lifetime &WordsGridEditor::lifetime() {
+	return _widget->lifetime();
+}
+
+} // namespace Ui
@@ -0,0 +1,120 @@
+// This file is part of TON Key Generator,
+// a desktop application for the TON Blockchain project.
+//
+// For license and copyright information please follow this link:
+// https://github.com/ton-blockchain/tonkeygen/blob/master/LEGAL
+//
+#pragma once
+
+#include "keygen/word_index.h"
+#include "base/timer.h"
+
+class QKeyEvent;
+class QMouseEvent;
+
+namespace Ui {
+
+class RpWidget;
+class WordSuggestions;
+
+// All the mnemonic inputs in a single custom painted widget.
+class WordsGridEditor final {
+public:
+	struct Pasted {
+		int index = 0;
+		QStringList words;
+	};
+
+	WordsGridEditor(
+		not_null<QWidget*> parent,
+		int count,
+		Fn<Keygen::WordsRange(QString)> wordsByPrefix);
+	WordsGridEditor(const WordsGridEditor &other) = delete;
+	WordsGridEditor &operator=(const WordsGridEditor &other) = delete;
+	~WordsGridEditor();
+
+	[[nodiscard]] int rows() const;
+	[[nodiscard]] int count() const;
+	[[nodiscard]] QString word(int index) const;
+	[[nodiscard]] std::vector<QString> words() const;
+
+	void moveToTop(int top, int width);
+	void setWords(int from, const QStringList &words);
+	void setFocus(int index);
+	void showError(int index);
+	void showErrorNoFocus(int index);
+
+	[[nodiscard]] rpl::producer<int> focused() const;
+	[[nodiscard]] rpl::producer<int> blurred() const;
+	[[nodiscard]] rpl::producer<int> submitted() const;
+	[[nodiscard]] rpl::producer<int> edited() const;
+	[[nodiscard]] rpl::producer<Pasted> pasted() const;
+
+	[[nodiscard]] rpl::lifetime &lifetime();
+
+private:
+	struct Cell {
+		QString text;
+		int cursor = 0;
+		int anchor = 0;
+		bool error = false;
+		bool chosen = false;
+
+		QString lastQuery;
+		Keygen::WordsRange lastRange;
+	};
+
+	void setupEvents();
+	void paint(QRect clip);
+	void paintCell(QPainter &p, int index);
+	[[nodiscard]] bool handleKeyPress(not_null<QKeyEvent*> e);
+	void handleMousePress(not_null<QMouseEvent*> e);
+	void handleMouseMove(not_null<QMouseEvent*> e);
+	void handleFocusIn();
+	void handleFocusOut();
+	void setActive(int index);
+	void updateCell(int index);
+	void restartCaret();
+	void toggleCaret();
+
+	void insert(const QString &text);
+	void removeSelection();
+	void erase(int direction);
+	void moveCursor(int position, bool select);
+	void copySelection() const;
+	void paste();
+	void changed(int index);
+
+	void showSuggestions(int index);
+	void createSuggestions();
+	void updateSuggestionsGeometry();
+	[[nodiscard]] Keygen::WordsRange lookup(int index);
+
+	[[nodiscard]] QRect inputRect(int index) const;
+	[[nodiscard]] int cellAt(QPoint position) const;
+	[[nodiscard]] int cursorLeft(int index, int position) const;
+	[[nodiscard]] int positionAt(int index, int left) const;
+	[[nodiscard]] bool hasSelection(int index) const;
+
+	const std::unique_ptr<RpWidget> _widget;
+	const Fn<Keygen::WordsRange(QString)> _wordsByPrefix;
+	const int _rows = 0;
+	std::vector<Cell> _cells;
+	std::vector<QString> _labels;
+
+	int _active = -1;
+	bool _hasFocus = false;
+	bool _caretShown = false;
+	bool _selecting = false;
+	base::Timer _caretTimer;
+	std::unique_ptr<WordSuggestions> _suggestions;
+
+	rpl::event_stream<int> _focused;
+	rpl::event_stream<int> _blurred;
+	rpl::event_stream<int> _submitted;
+	rpl::event_stream<int> _edited;
+	rpl::event_stream<Pasted> _pasted;
+
+};
+
+} // namespace Ui